@@ -0,0 +1,489 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+/**
+ Standalone benchmarks for FSLPromises, which unlike the XCTest performance tests don't depend on
+ Apple-only APIs and so can run on Linux with GNUstep and libdispatch as well.
+
+ Usage: FSLPromisesBenchmarks [--filter <substring>] [--sizes <n,...>] [--warmup <n>]
+                              [--repetitions <n>] [--json <path or ->] [--record]
+                              [--trace <path>]
+
+ The `--record` and `--trace` options only make sense for FSLPromisesBenchmarksInstrumented, which
+ is built with the instrumentation hooks compiled in. The former installs a sink that just counts
+ the events, and the latter writes the latest events to a Chrome trace file instead.
+ */
+
+#import <Foundation/Foundation.h>
+
+#include <stdatomic.h>
+#include <time.h>
+
+#import "FSLPromises.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Counts the events handed to it, to measure the overhead of recording them. */
+@interface FSLBenchmarkInstrumentationSink : NSObject <FSLPromiseInstrumentationSink>
+@property(nonatomic, readonly) uint64_t eventsCount;
+@end
+
+@implementation FSLBenchmarkInstrumentationSink {
+  _Atomic(uint64_t) _eventsCount;
+}
+
+- (uint64_t)eventsCount {
+  return atomic_load_explicit(&_eventsCount, memory_order_relaxed);
+}
+
+- (void)promiseInstrumentationDidRecordEvents:(FSLPromiseInstrumentationEvent const *)events
+                                        count:(NSUInteger)count {
+  atomic_fetch_add_explicit(&_eventsCount, count, memory_order_relaxed);
+}
+
+@end
+
+typedef FSLPromise *_Nonnull (^FSLBenchmarkRunBlock)(void);
+
+/**
+ Prepares anything a benchmark needs for the given size outside of the measured interval, and
+ returns a block doing the measured work, which is invoked once per repetition.
+ */
+typedef FSLBenchmarkRunBlock _Nonnull (^FSLBenchmarkSetupBlock)(NSUInteger size,
+                                                                 dispatch_queue_t queue);
+
+/** Sizes each benchmark is run with unless overridden with `--sizes`. */
+static NSUInteger const FSLBenchmarkDefaultSizes[] = {1, 100, 10000};
+
+static NSUInteger const FSLBenchmarkDefaultWarmupCount = 3;
+static NSUInteger const FSLBenchmarkDefaultRepetitionsCount = 30;
+
+/** Number of latest events kept with `--trace`, to keep the trace file openable. */
+static NSUInteger const FSLBenchmarkTraceCapacity = 1 << 20;
+
+static uint64_t FSLBenchmarkNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+/** Returns the nearest-rank percentile of the sorted samples. */
+static uint64_t FSLBenchmarkPercentile(uint64_t const *samples, NSUInteger count, double percent) {
+  NSUInteger rank = (NSUInteger)ceil(percent / 100 * count);
+  return samples[MAX(rank, 1u) - 1];
+}
+
+static int FSLBenchmarkCompareSamples(void const *lhs, void const *rhs) {
+  uint64_t const left = *(uint64_t const *)lhs;
+  uint64_t const right = *(uint64_t const *)rhs;
+  return left < right ? -1 : left > right ? 1 : 0;
+}
+
+/** Returns `count` promises fulfilled asynchronously on `queue`. */
+static NSArray<FSLPromise *> *FSLBenchmarkPromises(NSUInteger count, dispatch_queue_t queue) {
+  NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    [promises addObject:[FSLPromise onQueue:queue
+                                         do:^id {
+                                           return @(i);
+                                         }]];
+  }
+  return promises;
+}
+
+/** Number of iterations of the CPU-bound work done by each leaf of the fork/join benchmarks. */
+static NSUInteger const FSLBenchmarkForkJoinLeafIterations = 1000;
+
+/** Returns a hash of `seed` taking some CPU time, like a small slice of parsing or compression. */
+static uint64_t FSLBenchmarkLeafWork(uint64_t seed) {
+  uint64_t hash = seed;
+  for (NSUInteger i = 0; i < FSLBenchmarkForkJoinLeafIterations; ++i) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+  }
+  return hash;
+}
+
+/**
+ Returns a promise of the sum of hashes of `count` seeds from `seed` on, which recursively forks
+ the work in two `do:` blocks joined with `all:`, the way divide and conquer algorithms do.
+ */
+static FSLPromise *FSLBenchmarkForkJoin(id<FSLPromiseExecutor> executor, uint64_t seed,
+                                        NSUInteger count) {
+  return [FSLPromise onExecutor:executor
+                             do:^id {
+                               if (count == 1) {
+                                 return @(FSLBenchmarkLeafWork(seed));
+                               }
+                               NSUInteger const half = count / 2;
+                               NSArray *promises = @[
+                                 FSLBenchmarkForkJoin(executor, seed, half),
+                                 FSLBenchmarkForkJoin(executor, seed + half, count - half)
+                               ];
+                               return [[FSLPromise onExecutor:executor all:promises]
+                                   onExecutor:executor
+                                         then:^id(NSArray<NSNumber *> *values) {
+                                           return @(values[0].unsignedLongLongValue +
+                                                    values[1].unsignedLongLongValue);
+                                         }];
+                             }];
+}
+
+/**
+ Returns the benchmarks by name, one per combinator, plus the fork/join ones comparing a concurrent
+ dispatch queue with a work-stealing executor.
+ */
+static NSDictionary<NSString *, FSLBenchmarkSetupBlock> *FSLBenchmarks(void) {
+  return @{
+    @"then" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        FSLPromise *promise = [FSLPromise resolvedWith:@0];
+        for (NSUInteger i = 0; i < size; ++i) {
+          promise = [promise onQueue:queue
+                                then:^id(NSNumber *value) {
+                                  return @(value.integerValue + 1);
+                                }];
+        }
+        return promise;
+      };
+    },
+    @"catch" : ^(NSUInteger size, dispatch_queue_t queue) {
+      NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+      return ^{
+        FSLPromise *promise = [FSLPromise resolvedWith:error];
+        for (NSUInteger i = 0; i < size; ++i) {
+          promise = [promise onQueue:queue
+                               catch:^(NSError *__unused _) {
+                               }];
+        }
+        return [promise onQueue:queue
+                       recover:^id(NSError *__unused _) {
+                         return nil;
+                       }];
+      };
+    },
+    @"all" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        return [FSLPromise onQueue:queue all:FSLBenchmarkPromises(size, queue)];
+      };
+    },
+    @"any" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        return [FSLPromise onQueue:queue any:FSLBenchmarkPromises(size, queue)];
+      };
+    },
+    @"race" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        return [FSLPromise onQueue:queue race:FSLBenchmarkPromises(size, queue)];
+      };
+    },
+    @"reduce" : ^(NSUInteger size, dispatch_queue_t queue) {
+      NSMutableArray<NSNumber *> *items = [[NSMutableArray alloc] initWithCapacity:size];
+      for (NSUInteger i = 0; i < size; ++i) {
+        [items addObject:@(i)];
+      }
+      return ^{
+        return [[FSLPromise resolvedWith:@0] onQueue:queue
+                                              reduce:items
+                                             combine:^id(NSNumber *partial, NSNumber *next) {
+                                               return @(partial.integerValue + next.integerValue);
+                                             }];
+      };
+    },
+    @"retry" : ^(NSUInteger size, dispatch_queue_t queue) {
+      NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+      return ^{
+        // Fails all attempts but the last one. Zero delays dispatch the next attempt right away
+        // rather than on the next tick of the timer wheel, so this measures the overhead of
+        // retrying.
+        NSUInteger __block attemptsCount = 0;
+        return [FSLPromise onQueue:queue
+                          attempts:(NSInteger)size
+                             delay:0
+                         condition:nil
+                             retry:^id {
+                               return ++attemptsCount < size ? error : @(attemptsCount);
+                             }];
+      };
+    },
+    @"timeout" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:size];
+        for (FSLPromise *promise in FSLBenchmarkPromises(size, queue)) {
+          [promises addObject:[promise onQueue:queue timeout:60]];
+        }
+        return [FSLPromise onQueue:queue all:promises];
+      };
+    },
+    @"delay" : ^(NSUInteger size, dispatch_queue_t queue) {
+      // Zero delays don't wait for a tick of the timer wheel either.
+      return ^{
+        NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:size];
+        for (NSUInteger i = 0; i < size; ++i) {
+          [promises addObject:[[FSLPromise resolvedWith:@(i)] onQueue:queue delay:0]];
+        }
+        return [FSLPromise onQueue:queue all:promises];
+      };
+    },
+    @"wrap" : ^(NSUInteger size, dispatch_queue_t queue) {
+      return ^{
+        NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:size];
+        for (NSUInteger i = 0; i < size; ++i) {
+          [promises addObject:[FSLPromise onQueue:queue
+                                  wrapObjectCompletion:^(FSLPromiseObjectCompletion handler) {
+                                    handler(@(i));
+                                  }]];
+        }
+        return [FSLPromise onQueue:queue all:promises];
+      };
+    },
+    @"wrap2" : ^(NSUInteger size, dispatch_queue_t queue) {
+      // Boxes both objects into an array with NSNull placeholders.
+      return ^{
+        NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:size];
+        for (NSUInteger i = 0; i < size; ++i) {
+          [promises addObject:[FSLPromise syncWrap2ObjectsOrErrorCompletion:^(
+                                              FSLPromise2ObjectsOrErrorCompletion handler) {
+            handler(@(i), nil, nil);
+          }]];
+        }
+        return [FSLPromise onQueue:queue all:promises];
+      };
+    },
+    @"wrap2-combine" : ^(NSUInteger size, dispatch_queue_t queue) {
+      // Same as "wrap2", but resolves with the first object instead of boxing both.
+      return ^{
+        NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithCapacity:size];
+        for (NSUInteger i = 0; i < size; ++i) {
+          [promises addObject:[FSLPromise
+                                  syncWrap2ObjectsOrErrorCompletion:^(
+                                      FSLPromise2ObjectsOrErrorCompletion handler) {
+                                    handler(@(i), nil, nil);
+                                  }
+                                  combine:^id(id __nullable value1, id __nullable __unused value2) {
+                                    return value1;
+                                  }]];
+        }
+        return [FSLPromise onQueue:queue all:promises];
+      };
+    },
+    @"forkjoin-gcd" : ^(NSUInteger size, dispatch_queue_t __unused queue) {
+      dispatch_queue_t concurrentQueue = dispatch_queue_create(
+          "com.google.FSLPromises.Benchmarks.ForkJoin", DISPATCH_QUEUE_CONCURRENT);
+      FSLPromiseDispatchQueueExecutor *executor =
+          [[FSLPromiseDispatchQueueExecutor alloc] initWithQueue:concurrentQueue];
+      return ^{
+        return FSLBenchmarkForkJoin(executor, 0, size);
+      };
+    },
+    @"forkjoin-ws" : ^(NSUInteger size, dispatch_queue_t __unused queue) {
+      FSLPromiseWorkStealingExecutor *executor = [[FSLPromiseWorkStealingExecutor alloc] init];
+      return ^{
+        return FSLBenchmarkForkJoin(executor, 0, size);
+      };
+    },
+    @"await" : ^(NSUInteger size, dispatch_queue_t queue) {
+      // Awaiting on `queue` for promises resolved on `queue` would deadlock a serial queue.
+      dispatch_queue_t producerQueue = dispatch_queue_create(
+          "com.google.FSLPromises.Benchmarks.Producer", DISPATCH_QUEUE_SERIAL);
+      return ^{
+        return [FSLPromise onQueue:queue
+                                do:^id {
+                                  NSError *error;
+                                  for (NSUInteger i = 0; i < size && !error; ++i) {
+                                    FSLPromise *promise = [FSLPromise onQueue:producerQueue
+                                                                           do:^id {
+                                                                             return @(i);
+                                                                           }];
+                                    FSLPromiseAwait(promise, &error);
+                                  }
+                                  return error;
+                                }];
+      };
+    },
+  };
+}
+
+/** Parses a comma-separated list of positive integers, or returns nil. */
+static NSArray<NSNumber *> *__nullable FSLBenchmarkParseSizes(NSString *string) {
+  NSMutableArray<NSNumber *> *sizes = [[NSMutableArray alloc] init];
+  for (NSString *component in [string componentsSeparatedByString:@","]) {
+    NSInteger size = component.integerValue;
+    if (size <= 0) {
+      return nil;
+    }
+    [sizes addObject:@(size)];
+  }
+  return sizes;
+}
+
+static void FSLBenchmarkPrintUsage(void) {
+  fprintf(stderr,
+          "usage: FSLPromisesBenchmarks [--filter <substring>] [--sizes <n,...>] "
+          "[--warmup <n>] [--repetitions <n>] [--json <path or ->] [--record] "
+          "[--trace <path>]\n");
+}
+
+int main(int argc, char const *argv[]) {
+  @autoreleasepool {
+    NSString *filter;
+    NSString *JSONPath;
+    NSMutableArray<NSNumber *> *sizes = [[NSMutableArray alloc] init];
+    for (size_t i = 0; i < sizeof(FSLBenchmarkDefaultSizes) / sizeof(*FSLBenchmarkDefaultSizes);
+         ++i) {
+      [sizes addObject:@(FSLBenchmarkDefaultSizes[i])];
+    }
+    NSUInteger warmupCount = FSLBenchmarkDefaultWarmupCount;
+    NSUInteger repetitionsCount = FSLBenchmarkDefaultRepetitionsCount;
+    FSLBenchmarkInstrumentationSink *sink;
+    NSString *tracePath;
+    for (int i = 1; i < argc; ++i) {
+      NSString *option = @(argv[i]);
+      if ([option isEqualToString:@"--record"]) {
+        sink = [[FSLBenchmarkInstrumentationSink alloc] init];
+        continue;
+      }
+      NSString *argument = i + 1 < argc ? @(argv[++i]) : nil;
+      if (!argument) {
+        FSLBenchmarkPrintUsage();
+        return 1;
+      } else if ([option isEqualToString:@"--filter"]) {
+        filter = argument;
+      } else if ([option isEqualToString:@"--sizes"]) {
+        NSArray<NSNumber *> *parsedSizes = FSLBenchmarkParseSizes(argument);
+        if (!parsedSizes) {
+          FSLBenchmarkPrintUsage();
+          return 1;
+        }
+        [sizes setArray:parsedSizes];
+      } else if ([option isEqualToString:@"--warmup"]) {
+        warmupCount = (NSUInteger)MAX(argument.integerValue, 0);
+      } else if ([option isEqualToString:@"--repetitions"]) {
+        repetitionsCount = (NSUInteger)MAX(argument.integerValue, 1);
+      } else if ([option isEqualToString:@"--json"]) {
+        JSONPath = argument;
+      } else if ([option isEqualToString:@"--trace"]) {
+        tracePath = argument;
+      } else {
+        FSLBenchmarkPrintUsage();
+        return 1;
+      }
+    }
+
+    // The main thread blocks awaiting the results, so nothing may default to the main queue.
+    dispatch_queue_t queue =
+        dispatch_queue_create("com.google.FSLPromises.Benchmarks", DISPATCH_QUEUE_SERIAL);
+    FSLPromise.defaultDispatchQueue = queue;
+    FSLPromiseTraceRecorder *traceRecorder =
+        tracePath ? [[FSLPromiseTraceRecorder alloc] initWithCapacity:FSLBenchmarkTraceCapacity]
+                  : nil;
+    FSLPromiseInstrumentation.sink = traceRecorder ?: sink;
+    NSString *instrumentation = !FSLPromiseInstrumentation.isEnabled ? @"disabled"
+                                : FSLPromiseInstrumentation.sink     ? @"recording"
+                                                                     : @"idle";
+    fprintf(stderr, "Instrumentation: %s\n", instrumentation.UTF8String);
+
+    NSDictionary<NSString *, FSLBenchmarkSetupBlock> *benchmarks = FSLBenchmarks();
+    NSArray<NSString *> *names =
+        [benchmarks.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    NSMutableArray<NSDictionary *> *results = [[NSMutableArray alloc] init];
+    uint64_t *samples = calloc(repetitionsCount, sizeof(*samples));
+    // Keep stdout clean for the JSON if it goes there.
+    FILE *report = [JSONPath isEqualToString:@"-"] ? stderr : stdout;
+    fprintf(report, "%-14s %8s %14s %14s %14s\n", "benchmark", "size", "p50 (ns)", "p99 (ns)",
+            "mean (ns)");
+    for (NSString *name in names) {
+      if (filter.length && [name rangeOfString:filter].location == NSNotFound) {
+        continue;
+      }
+      for (NSNumber *size in sizes) {
+        @autoreleasepool {
+          FSLBenchmarkRunBlock run = benchmarks[name](size.unsignedIntegerValue, queue);
+          uint64_t total = 0;
+          for (NSUInteger i = 0; i < warmupCount + repetitionsCount; ++i) {
+            @autoreleasepool {
+              NSError *error;
+              uint64_t const start = FSLBenchmarkNow();
+              FSLPromiseAwait(run(), &error);
+              uint64_t const time = FSLBenchmarkNow() - start;
+              if (error) {
+                fprintf(stderr, "%s failed: %s\n", name.UTF8String,
+                        error.description.UTF8String);
+                free(samples);
+                return 1;
+              }
+              if (i >= warmupCount) {
+                samples[i - warmupCount] = time;
+                total += time;
+              }
+            }
+          }
+          qsort(samples, repetitionsCount, sizeof(*samples), FSLBenchmarkCompareSamples);
+          uint64_t const p50 = FSLBenchmarkPercentile(samples, repetitionsCount, 50);
+          uint64_t const p99 = FSLBenchmarkPercentile(samples, repetitionsCount, 99);
+          uint64_t const mean = total / repetitionsCount;
+          fprintf(report, "%-14s %8lu %14llu %14llu %14llu\n", name.UTF8String,
+                  (unsigned long)size.unsignedIntegerValue, (unsigned long long)p50,
+                  (unsigned long long)p99, (unsigned long long)mean);
+          [results addObject:@{
+            @"name" : name,
+            @"size" : size,
+            @"repetitions" : @(repetitionsCount),
+            @"p50_ns" : @(p50),
+            @"p99_ns" : @(p99),
+            @"mean_ns" : @(mean),
+            @"min_ns" : @(samples[0]),
+            @"max_ns" : @(samples[repetitionsCount - 1]),
+          }];
+        }
+      }
+    }
+    free(samples);
+    if (traceRecorder) {
+      NSError *error;
+      if (![traceRecorder writeTraceToFile:tracePath error:&error]) {
+        fprintf(stderr, "Failed to write %s: %s\n", tracePath.UTF8String,
+                error.description.UTF8String);
+        return 1;
+      }
+      fprintf(stderr, "Traced events: %lu (%lu dropped)\n",
+              (unsigned long)traceRecorder.eventsCount,
+              (unsigned long)traceRecorder.droppedEventsCount);
+    } else if (sink) {
+      fprintf(stderr, "Recorded events: %llu\n", (unsigned long long)sink.eventsCount);
+    }
+
+    if (JSONPath) {
+      NSError *error;
+      NSDictionary *JSONObject = @{@"instrumentation" : instrumentation, @"benchmarks" : results};
+      NSData *data = [NSJSONSerialization dataWithJSONObject:JSONObject
+                                                     options:NSJSONWritingPrettyPrinted
+                                                       error:&error];
+      if ([JSONPath isEqualToString:@"-"]) {
+        fwrite(data.bytes, 1, data.length, stdout);
+        fputc('\n', stdout);
+      } else if (!data || ![data writeToFile:JSONPath options:NSDataWritingAtomic error:&error]) {
+        fprintf(stderr, "Failed to write %s: %s\n", JSONPath.UTF8String,
+                error.description.UTF8String);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Copyright 2018 Google Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at:
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Compares FSLPromisesBenchmarks JSON results against a saved baseline.
+
+Exits with status 1 if any benchmark got slower than the baseline by more than the allowed ratio,
+so that it can gate upgrades:
+
+  compare_benchmarks.py baseline.json results.json --p50-threshold 0.1 --p99-threshold 0.25
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+  with open(path) as f:
+    return {(b['name'], b['size']): b for b in json.load(f)['benchmarks']}
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__,
+                                   formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('baseline', help='JSON results to compare against')
+  parser.add_argument('results', help='JSON results to check')
+  parser.add_argument('--p50-threshold', type=float, default=0.1,
+                      help='max allowed relative p50 slowdown (default: %(default)s)')
+  parser.add_argument('--p99-threshold', type=float, default=0.25,
+                      help='max allowed relative p99 slowdown (default: %(default)s)')
+  args = parser.parse_args()
+
+  baseline = load(args.baseline)
+  results = load(args.results)
+  regressions = 0
+  print('%-10s %8s %10s %10s  %s' % ('benchmark', 'size', 'p50', 'p99', 'status'))
+  for key in sorted(results):
+    name, size = key
+    if key not in baseline:
+      print('%-10s %8d %10s %10s  new' % (name, size, '-', '-'))
+      continue
+    ratios = []
+    failed = False
+    for metric, threshold in (('p50_ns', args.p50_threshold), ('p99_ns', args.p99_threshold)):
+      old = baseline[key][metric]
+      ratio = results[key][metric] / old - 1 if old else 0.0
+      ratios.append(ratio)
+      failed = failed or ratio > threshold
+    regressions += failed
+    print('%-10s %8d %+9.1f%% %+9.1f%%  %s' %
+          (name, size, ratios[0] * 100, ratios[1] * 100, 'REGRESSION' if failed else 'ok'))
+  for name, size in sorted(set(baseline) - set(results)):
+    print('%-10s %8d %10s %10s  missing' % (name, size, '-', '-'))
+
+  if regressions:
+    print('%d benchmark(s) regressed' % regressions, file=sys.stderr)
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
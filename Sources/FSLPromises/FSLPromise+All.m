@@ -16,8 +16,8 @@
 
 #import "FSLPromise+All.h"
 
-#import "FSLPromise+Async.h"
 #import "FSLPromisePrivate.h"
+#import "FSLPromiseResults.h"
 
 @implementation FSLPromise (AllAdditions)
 
@@ -27,44 +27,66 @@
 
 + (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue all:(NSArray *)allPromises {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) all:allPromises];
+}
+
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor all:(NSArray *)allPromises {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) all:allPromises];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:all:`, but waits for the promises on `target`.
+ */
++ (FSLPromise<NSArray *> *)onTarget:(void *)target all:(NSArray *)allPromises {
   NSParameterAssert(allPromises);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("all");
   if (allPromises.count == 0) {
     return [[self alloc] initWithResolution:@[]];
   }
-  NSMutableArray *promises = [allPromises mutableCopy];
-  return [self
-      onQueue:queue
-        async:^(FSLPromiseFulfillBlock fulfill, FSLPromiseRejectBlock reject) {
-          for (NSUInteger i = 0; i < promises.count; ++i) {
-            id promise = promises[i];
-            if ([promise isKindOfClass:self]) {
-              continue;
-            } else if ([promise isKindOfClass:[NSError class]]) {
-              reject(promise);
-              return;
-            } else {
-              [promises replaceObjectAtIndex:i
-                                  withObject:[[self alloc] initWithResolution:promise]];
-            }
-          }
-          for (FSLPromise *promise in promises) {
-            [promise observeOnQueue:queue
-                fulfill:^(id __unused _) {
-                  // Wait until all are fulfilled.
-                  for (FSLPromise *promise in promises) {
-                    if (!promise.isFulfilled) {
-                      return;
-                    }
-                  }
-                  // If called multiple times, only the first one affects the result.
-                  fulfill([promises valueForKey:NSStringFromSelector(@selector(value))]);
-                }
-                reject:^(NSError *error) {
-                  reject(error);
-                }];
-          }
-        }];
+  NSArray *promises = [allPromises copy];
+  FSLPromise *combinedPromise = [[self alloc] initPending];
+  [combinedPromise
+      dispatchOnTarget:target
+                 block:^{
+                   for (id promise in promises) {
+                     if ([promise isKindOfClass:[NSError class]]) {
+                       [combinedPromise reject:promise];
+                       return;
+                     }
+                   }
+                   // Each input stores its value at its own index, and the last one to do that
+                   // fulfills the combined promise, so nothing has to scan all inputs again.
+                   FSLPromiseResults *results =
+                       [[FSLPromiseResults alloc] initWithCount:promises.count];
+                   FSLPromiseOnRejectBlock reject = ^(NSError *error) {
+                     [combinedPromise reject:error];
+                   };
+                   NSUInteger index = 0;
+                   for (id promise in promises) {
+                     NSUInteger const resultIndex = index++;
+                     if (![promise isKindOfClass:self]) {
+                       if ([results setObject:promise atIndex:resultIndex]) {
+                         [combinedPromise fulfill:results.array];
+                       }
+                       continue;
+                     }
+                     [promise observeOnTarget:target
+                         fulfill:^(id __nullable value) {
+                           if ([results setObject:value atIndex:resultIndex]) {
+                             [combinedPromise fulfill:results.array];
+                           }
+                         }
+                         reject:reject];
+                     [combinedPromise propagateCancellationToPromise:promise];
+                   }
+                 }];
+  return combinedPromise;
 }
 
 @end
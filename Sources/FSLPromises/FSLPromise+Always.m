@@ -26,9 +26,26 @@
 
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue always:(FSLPromiseAlwaysWorkBlock)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) always:work];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor always:(FSLPromiseAlwaysWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) always:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:always:`, but invokes `work` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target always:(FSLPromiseAlwaysWorkBlock)work {
   NSParameterAssert(work);
 
-  return [self chainOnQueue:queue
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("always");
+  return [self chainOnTarget:target
       chainedFulfill:^id(id value) {
         work();
         return value;
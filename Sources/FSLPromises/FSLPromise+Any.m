@@ -16,24 +16,8 @@
 
 #import "FSLPromise+Any.h"
 
-#import "FSLPromise+Async.h"
 #import "FSLPromisePrivate.h"
-
-static NSArray *FSLPromiseCombineValuesAndErrors(NSArray<FSLPromise *> *promises) {
-  NSMutableArray *combinedValuesAndErrors = [[NSMutableArray alloc] init];
-  for (FSLPromise *promise in promises) {
-    if (promise.isFulfilled) {
-      [combinedValuesAndErrors addObject:promise.value ?: [NSNull null]];
-      continue;
-    }
-    if (promise.isRejected) {
-      [combinedValuesAndErrors addObject:promise.error];
-      continue;
-    }
-    assert(!promise.isPending);
-  };
-  return combinedValuesAndErrors;
-}
+#import "FSLPromiseResults.h"
 
 @implementation FSLPromise (AnyAdditions)
 
@@ -43,54 +27,75 @@ static NSArray *FSLPromiseCombineValuesAndErrors(NSArray<FSLPromise *> *promises
 
 + (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue any:(NSArray *)anyPromises {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) any:anyPromises];
+}
+
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor any:(NSArray *)anyPromises {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) any:anyPromises];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:any:`, but waits for the promises on `target`.
+ */
++ (FSLPromise<NSArray *> *)onTarget:(void *)target any:(NSArray *)anyPromises {
   NSParameterAssert(anyPromises);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("any");
   if (anyPromises.count == 0) {
     return [[self alloc] initWithResolution:@[]];
   }
-  NSMutableArray *promises = [anyPromises mutableCopy];
-  return [self
-      onQueue:queue
-        async:^(FSLPromiseFulfillBlock fulfill, FSLPromiseRejectBlock reject) {
-          for (NSUInteger i = 0; i < promises.count; ++i) {
-            id promise = promises[i];
-            if ([promise isKindOfClass:self]) {
-              continue;
-            } else {
-              [promises replaceObjectAtIndex:i
-                                  withObject:[[self alloc] initWithResolution:promise]];
-            }
-          }
-          for (FSLPromise *promise in promises) {
-            [promise observeOnQueue:queue
-                fulfill:^(id __unused _) {
-                  // Wait until all are resolved.
-                  for (FSLPromise *promise in promises) {
-                    if (promise.isPending) {
-                      return;
-                    }
-                  }
-                  // If called multiple times, only the first one affects the result.
-                  fulfill(FSLPromiseCombineValuesAndErrors(promises));
-                }
-                reject:^(NSError *error) {
-                  BOOL atLeastOneIsFulfilled = NO;
-                  for (FSLPromise *promise in promises) {
-                    if (promise.isPending) {
-                      return;
-                    }
-                    if (promise.isFulfilled) {
-                      atLeastOneIsFulfilled = YES;
-                    }
-                  }
-                  if (atLeastOneIsFulfilled) {
-                    fulfill(FSLPromiseCombineValuesAndErrors(promises));
-                  } else {
-                    reject(error);
-                  }
-                }];
-          }
-        }];
+  NSArray *promises = [anyPromises copy];
+  FSLPromise *combinedPromise = [[self alloc] initPending];
+  [combinedPromise
+      dispatchOnTarget:target
+                 block:^{
+                   // Each input stores its value or error at its own index, and the last one
+                   // to do that resolves the combined promise, so nothing has to scan all
+                   // inputs again.
+                   FSLPromiseResults *results =
+                       [[FSLPromiseResults alloc] initWithCount:promises.count];
+                   void (^resolve)(NSError *__nullable) = ^(NSError *__nullable lastError) {
+                     if (results.errorsCount < results.count) {
+                       [combinedPromise fulfill:results.array];
+                     } else {
+                       [combinedPromise reject:lastError];
+                     }
+                   };
+                   NSUInteger index = 0;
+                   for (id promise in promises) {
+                     NSUInteger const resultIndex = index++;
+                     if ([promise isKindOfClass:[NSError class]]) {
+                       if ([results setError:promise atIndex:resultIndex]) {
+                         resolve(promise);
+                       }
+                       continue;
+                     }
+                     if (![promise isKindOfClass:self]) {
+                       if ([results setObject:promise atIndex:resultIndex]) {
+                         resolve(nil);
+                       }
+                       continue;
+                     }
+                     [promise observeOnTarget:target
+                         fulfill:^(id __nullable value) {
+                           if ([results setObject:value atIndex:resultIndex]) {
+                             resolve(nil);
+                           }
+                         }
+                         reject:^(NSError *error) {
+                           if ([results setError:error atIndex:resultIndex]) {
+                             resolve(error);
+                           }
+                         }];
+                     [combinedPromise propagateCancellationToPromise:promise];
+                   }
+                 }];
+  return combinedPromise;
 }
 
 @end
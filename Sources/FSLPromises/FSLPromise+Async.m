@@ -26,28 +26,40 @@
 
 + (instancetype)onQueue:(dispatch_queue_t)queue async:(FSLPromiseAsyncWorkBlock)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) async:work];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor async:(FSLPromiseAsyncWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) async:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:async:`, but invokes `work` on `target`.
+ */
++ (instancetype)onTarget:(void *)target async:(FSLPromiseAsyncWorkBlock)work {
   NSParameterAssert(work);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("async");
   FSLPromise *promise = [[self alloc] initPending];
-  dispatch_group_async(FSLPromise.dispatchGroup, queue, ^{
-    work(
-        ^(id __nullable value) {
-          if ([value isKindOfClass:[FSLPromise class]]) {
-            [(FSLPromise *)value observeOnQueue:queue
-                fulfill:^(id __nullable value) {
-                  [promise fulfill:value];
-                }
-                reject:^(NSError *error) {
-                  [promise reject:error];
-                }];
-          } else {
-            [promise fulfill:value];
-          }
-        },
-        ^(NSError *error) {
-          [promise reject:error];
-        });
-  });
+  [promise dispatchOnTarget:target
+                      block:^{
+                        work(
+                            ^(id __nullable value) {
+                              if ([value isKindOfClass:[FSLPromise class]]) {
+                                [promise adoptPromise:(FSLPromise *)value];
+                              } else {
+                                [promise fulfill:value];
+                              }
+                            },
+                            ^(NSError *error) {
+                              [promise reject:error];
+                            });
+                      }];
   return promise;
 }
 
@@ -26,14 +26,31 @@
 
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue catch:(FSLPromiseCatchWorkBlock)reject {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) catch:reject];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor catch:(FSLPromiseCatchWorkBlock)reject {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) catch:reject];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:catch:`, but invokes `reject` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target catch:(FSLPromiseCatchWorkBlock)reject {
   NSParameterAssert(reject);
 
-  return [self chainOnQueue:queue
-             chainedFulfill:nil
-              chainedReject:^id(NSError *error) {
-                reject(error);
-                return error;
-              }];
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("catch");
+  return [self chainOnTarget:target
+              chainedFulfill:nil
+               chainedReject:^id(NSError *error) {
+                 reject(error);
+                 return error;
+               }];
 }
 
 @end
@@ -27,16 +27,35 @@
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue delay:(NSTimeInterval)interval {
   NSParameterAssert(queue);
 
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) delay:interval];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor delay:(NSTimeInterval)interval {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) delay:interval];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:delay:`, but fulfills the promise on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target delay:(NSTimeInterval)interval {
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("delay");
   FSLPromise *promise = [[[self class] alloc] initPending];
-  [self observeOnQueue:queue
+  [self observeOnTarget:target
       fulfill:^(id __nullable value) {
-        dispatch_after(dispatch_time(0, (int64_t)(interval * NSEC_PER_SEC)), queue, ^{
-          [promise fulfill:value];
-        });
+        [promise dispatchAfterInterval:interval
+                              onTarget:target
+                                 block:^{
+                                   [promise fulfill:value];
+                                 }];
       }
       reject:^(NSError *error) {
         [promise reject:error];
       }];
+  [promise propagateCancellationToPromise:self];
   return promise;
 }
 
@@ -26,23 +26,35 @@
 
 + (instancetype)onQueue:(dispatch_queue_t)queue do:(FSLPromiseDoWorkBlock)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) do:work];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor do:(FSLPromiseDoWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) do:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:do:`, but invokes `work` on `target`.
+ */
++ (instancetype)onTarget:(void *)target do:(FSLPromiseDoWorkBlock)work {
   NSParameterAssert(work);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("do");
   FSLPromise *promise = [[self alloc] initPending];
-  dispatch_group_async(FSLPromise.dispatchGroup, queue, ^{
-    id value = work();
-    if ([value isKindOfClass:[FSLPromise class]]) {
-      [(FSLPromise *)value observeOnQueue:queue
-          fulfill:^(id __nullable value) {
-            [promise fulfill:value];
-          }
-          reject:^(NSError *error) {
-            [promise reject:error];
-          }];
-    } else {
-      [promise fulfill:value];
-    }
-  });
+  [promise dispatchOnTarget:target
+                      block:^{
+                        id value = work();
+                        if ([value isKindOfClass:[FSLPromise class]]) {
+                          [promise adoptPromise:(FSLPromise *)value];
+                        } else {
+                          [promise fulfill:value];
+                        }
+                      }];
   return promise;
 }
 
@@ -0,0 +1,382 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Hedge.h"
+
+#import <time.h>
+
+#import "FSLPromisePrivate.h"
+
+NSInteger const FSLPromiseHedgeDefaultHedgesCount = 1;
+NSTimeInterval const FSLPromiseHedgeDefaultDelayInterval = 0.1;
+
+/**
+ Returns the current time of a monotonic clock in seconds.
+ */
+static NSTimeInterval FSLPromiseHedgeNow(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (NSTimeInterval)time.tv_sec + (NSTimeInterval)time.tv_nsec / NSEC_PER_SEC;
+}
+
+/**
+ State shared by the attempts of a hedged request. The first attempt to fulfill, or the last one to
+ reject, resolves the promise, after which the state drops the references to the promise and to the
+ attempts and detaches from the ones still pending, like `race:cancelLosers:` does.
+ */
+@interface FSLPromiseHedge : NSObject
+
+- (instancetype)initWithPromise:(FSLPromise *)promise
+                         target:(void *)target
+                    hedgesCount:(NSInteger)count
+                          delay:(FSLPromiseHedgeDelayBlock)delay
+                         report:(nullable FSLPromiseHedgeReportBlock)report
+                           work:(FSLPromiseHedgeWorkBlock)work;
+
+/**
+ Executes `work` block for the next attempt and schedules the one after, unless the promise has been
+ resolved by then. Must be invoked on the target given on init.
+ */
+- (void)startAttempt;
+
+@end
+
+@implementation FSLPromiseHedge {
+  // All guarded by @synchronized(self).
+  /** The promise to resolve, or nil once resolved. */
+  FSLPromise *_promise;
+  /** Promises returned by `work` block so far, or NSNull for attempts that returned a value. */
+  NSMutableArray *_attempts;
+  /** Number of attempts that have yet to resolve. */
+  NSUInteger _pendingAttemptsCount;
+  /** Cancels the timer to start the next attempt, if scheduled. */
+  dispatch_block_t _cancelTimer;
+  NSTimeInterval _startTime;
+
+  // Immutable.
+  /** Not retained, since it's only used by the attempts invoked on it. */
+  void *_target;
+  NSInteger _hedgesCount;
+  FSLPromiseHedgeDelayBlock _delay;
+  FSLPromiseHedgeReportBlock _report;
+  FSLPromiseHedgeWorkBlock _work;
+}
+
+- (instancetype)initWithPromise:(FSLPromise *)promise
+                         target:(void *)target
+                    hedgesCount:(NSInteger)count
+                          delay:(FSLPromiseHedgeDelayBlock)delay
+                         report:(nullable FSLPromiseHedgeReportBlock)report
+                           work:(FSLPromiseHedgeWorkBlock)work {
+  self = [super init];
+  if (self) {
+    _promise = promise;
+    _attempts = [[NSMutableArray alloc] init];
+    _target = target;
+    _hedgesCount = MAX(count, 0);
+    _delay = [delay copy];
+    _report = [report copy];
+    _work = [work copy];
+    FSLPromiseHedge __weak *weakSelf = self;
+    [promise addCancellationHandler:^{
+      [weakSelf settle];
+    }];
+  }
+  return self;
+}
+
+- (void)startAttempt {
+  NSUInteger attempt;
+  dispatch_block_t cancelTimer;
+  @synchronized(self) {
+    if (!_promise) {
+      return;
+    }
+    attempt = _attempts.count;
+    if (attempt == 0) {
+      _startTime = FSLPromiseHedgeNow();
+    }
+    [_attempts addObject:[NSNull null]];
+    ++_pendingAttemptsCount;
+    cancelTimer = _cancelTimer;
+    _cancelTimer = nil;
+  }
+  // The timer may still be scheduled if the previous attempt has been rejected before it fired.
+  if (cancelTimer) {
+    cancelTimer();
+  }
+  id value = _work();
+  if ([value isKindOfClass:[FSLPromise class]]) {
+    FSLPromise *attemptPromise = (FSLPromise *)value;
+    BOOL isSettled;
+    @synchronized(self) {
+      isSettled = _promise == nil;
+      if (!isSettled) {
+        _attempts[attempt] = attemptPromise;
+        // Observe under the lock, so that settling never detaches from an attempt not observed yet.
+        [attemptPromise observeOnTarget:_target
+            fulfill:^(id __nullable value) {
+              [self resolveWithValue:value fromAttempt:attempt];
+            }
+            reject:^(NSError *error) {
+              [self resolveWithValue:error fromAttempt:attempt];
+            }];
+      }
+    }
+    if (isSettled) {
+      [attemptPromise cancelUnlessObserved];
+      return;
+    }
+  } else {
+    [self resolveWithValue:value fromAttempt:attempt];
+  }
+  [self scheduleAttempt:attempt + 1];
+}
+
+#pragma mark - Private
+
+/**
+ Schedules the given attempt after the delay, unless the promise has been resolved, hedges are
+ exhausted or the attempt has already been started because the previous one has been rejected.
+ */
+- (void)scheduleAttempt:(NSUInteger)attempt {
+  FSLPromise *promise;
+  @synchronized(self) {
+    if (_attempts.count != attempt || attempt > (NSUInteger)_hedgesCount) {
+      return;
+    }
+    promise = _promise;
+  }
+  if (!promise) {
+    return;
+  }
+  dispatch_block_t cancelTimer = [promise dispatchAfterInterval:_delay(attempt)
+                                                       onTarget:_target
+                                                          block:^{
+                                                            [self startAttempt];
+                                                          }];
+  BOOL isScheduled;
+  @synchronized(self) {
+    isScheduled = _promise && _attempts.count == attempt;
+    if (isScheduled) {
+      _cancelTimer = cancelTimer;
+    }
+  }
+  if (!isScheduled) {
+    cancelTimer();
+  }
+}
+
+/**
+ Handles the resolution of the given attempt: fulfills the promise on success, and either makes the
+ next attempt right away or rejects the promise once all attempts have been rejected on failure.
+ */
+- (void)resolveWithValue:(nullable id)value fromAttempt:(NSUInteger)attempt {
+  if ([value isKindOfClass:[NSError class]]) {
+    BOOL shouldStartAttempt = NO;
+    BOOL shouldReject = NO;
+    @synchronized(self) {
+      if (!_promise) {
+        return;
+      }
+      --_pendingAttemptsCount;
+      if (_attempts.count <= (NSUInteger)_hedgesCount) {
+        shouldStartAttempt = attempt + 1 == _attempts.count;
+      } else {
+        shouldReject = _pendingAttemptsCount == 0;
+      }
+    }
+    if (shouldStartAttempt) {
+      [self startAttempt];
+      return;
+    }
+    if (!shouldReject) {
+      return;
+    }
+  }
+  FSLPromise *promise = [self settle];
+  if (!promise) {
+    return;
+  }
+  [promise fulfill:value];
+  if (_report) {
+    _report((NSInteger)attempt, FSLPromiseHedgeNow() - _startTime);
+  }
+}
+
+/**
+ Drops the references to the promise and the attempts, cancels the timer, if scheduled, and detaches
+ from the attempts still pending.
+
+ @return The promise to resolve, or nil if it has been settled already.
+ */
+- (nullable FSLPromise *)settle {
+  FSLPromise *promise;
+  NSArray *attempts;
+  dispatch_block_t cancelTimer;
+  @synchronized(self) {
+    promise = _promise;
+    attempts = _attempts;
+    cancelTimer = _cancelTimer;
+    _promise = nil;
+    _attempts = nil;
+    _cancelTimer = nil;
+  }
+  if (cancelTimer) {
+    cancelTimer();
+  }
+  for (id attemptPromise in attempts) {
+    // Attempts which have resolved already ignore the detached observer.
+    if ([attemptPromise isKindOfClass:[FSLPromise class]]) {
+      [(FSLPromise *)attemptPromise detachObserver];
+    }
+  }
+  return promise;
+}
+
+@end
+
+@implementation FSLPromise (HedgeAdditions)
+
++ (instancetype)hedge:(FSLPromiseHedgeWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue hedge:work];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue hedge:(FSLPromiseHedgeWorkBlock)work {
+  return [self onQueue:queue
+                hedges:FSLPromiseHedgeDefaultHedgesCount
+                 delay:FSLPromiseHedgeDefaultDelayInterval
+                 hedge:work];
+}
+
++ (instancetype)hedges:(NSInteger)count
+                 delay:(NSTimeInterval)interval
+                 hedge:(FSLPromiseHedgeWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue hedges:count delay:interval hedge:work];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                 hedges:(NSInteger)count
+                  delay:(NSTimeInterval)interval
+                  hedge:(FSLPromiseHedgeWorkBlock)work {
+  return [self onQueue:queue
+                hedges:count
+             delayedBy:^NSTimeInterval(NSInteger __unused _) {
+               return interval;
+             }
+                report:nil
+                 hedge:work];
+}
+
++ (instancetype)hedges:(NSInteger)count
+             delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                report:(nullable FSLPromiseHedgeReportBlock)report
+                 hedge:(FSLPromiseHedgeWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue
+                hedges:count
+             delayedBy:delay
+                report:report
+                 hedge:work];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                 hedges:(NSInteger)count
+              delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                 report:(nullable FSLPromiseHedgeReportBlock)report
+                  hedge:(FSLPromiseHedgeWorkBlock)work {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue)
+                 hedges:count
+              delayedBy:delay
+                 report:report
+                  hedge:work];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                    hedges:(NSInteger)count
+                 delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                    report:(nullable FSLPromiseHedgeReportBlock)report
+                     hedge:(FSLPromiseHedgeWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor)
+                 hedges:count
+              delayedBy:delay
+                 report:report
+                  hedge:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:hedges:delayedBy:report:hedge:`, but invokes `work` on `target`.
+ */
++ (instancetype)onTarget:(void *)target
+                  hedges:(NSInteger)count
+               delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                  report:(nullable FSLPromiseHedgeReportBlock)report
+                   hedge:(FSLPromiseHedgeWorkBlock)work {
+  NSParameterAssert(delay);
+  NSParameterAssert(work);
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("hedge");
+  FSLPromise *promise = [[self alloc] initPending];
+  FSLPromiseHedge *hedge = [[FSLPromiseHedge alloc] initWithPromise:promise
+                                                             target:target
+                                                        hedgesCount:count
+                                                              delay:delay
+                                                             report:report
+                                                               work:work];
+  [promise dispatchOnTarget:target
+                      block:^{
+                        [hedge startAttempt];
+                      }];
+  return promise;
+}
+
+@end
+
+@implementation FSLPromise (DotSyntax_HedgeAdditions)
+
++ (FSLPromise * (^)(FSLPromiseHedgeWorkBlock))hedge {
+  return ^id(FSLPromiseHedgeWorkBlock work) {
+    return [self hedge:work];
+  };
+}
+
++ (FSLPromise * (^)(dispatch_queue_t, FSLPromiseHedgeWorkBlock))hedgeOn {
+  return ^id(dispatch_queue_t queue, FSLPromiseHedgeWorkBlock work) {
+    return [self onQueue:queue hedge:work];
+  };
+}
+
++ (FSLPromise * (^)(NSInteger, NSTimeInterval, FSLPromiseHedgeWorkBlock))hedgeAgain {
+  return ^id(NSInteger count, NSTimeInterval interval, FSLPromiseHedgeWorkBlock work) {
+    return [self hedges:count delay:interval hedge:work];
+  };
+}
+
++ (FSLPromise * (^)(dispatch_queue_t, NSInteger, NSTimeInterval,
+                    FSLPromiseHedgeWorkBlock))hedgeAgainOn {
+  return ^id(dispatch_queue_t queue, NSInteger count, NSTimeInterval interval,
+             FSLPromiseHedgeWorkBlock work) {
+    return [self onQueue:queue hedges:count delay:interval hedge:work];
+  };
+}
+
+@end
@@ -0,0 +1,406 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Map.h"
+
+#import "FSLPromisePrivate.h"
+#import "FSLPromiseResults.h"
+
+/**
+ Runs the work for a collection of items in a fixed number of lanes, each taking the next item
+ once the work for its previous one has completed, so that no more than that number of items have
+ the work pending at a time and the items are only taken when needed.
+ */
+@interface FSLPromiseMapper : NSObject
+
+/**
+ Creates a mapper to resolve `promise` with.
+
+ @param keepsResults Whether to resolve `promise` with the results of the work, rather than with the
+                     errors collected.
+ */
+- (instancetype)initWithPromise:(FSLPromise *)promise
+                         target:(void *)target
+                          items:(NSArray *)items
+                           mode:(FSLPromiseMapMode)mode
+                   keepsResults:(BOOL)keepsResults
+                           work:(FSLPromiseMapWorkBlock)work;
+
+/**
+ Asynchronously starts the given number of lanes.
+ */
+- (void)startLanes:(NSUInteger)count;
+
+@end
+
+@implementation FSLPromiseMapper {
+  // All guarded by @synchronized(self).
+  /** The promise to resolve, or nil once resolved. */
+  FSLPromise *_promise;
+  NSUInteger _nextIndex;
+  NSUInteger _runningLanesCount;
+  /** The promise each lane waits for, or NSNull. */
+  NSMutableArray *_pendingPromises;
+  NSMutableArray<NSError *> *_errors;
+
+  // Immutable.
+  /** Results in the same order as items, or nil if not kept. */
+  FSLPromiseResults *_results;
+  /** Not retained, since it's only used by the lanes invoked on it, once started. */
+  void *_target;
+  NSArray *_items;
+  FSLPromiseMapMode _mode;
+  FSLPromiseMapWorkBlock _work;
+}
+
+- (instancetype)initWithPromise:(FSLPromise *)promise
+                         target:(void *)target
+                          items:(NSArray *)items
+                           mode:(FSLPromiseMapMode)mode
+                   keepsResults:(BOOL)keepsResults
+                           work:(FSLPromiseMapWorkBlock)work {
+  self = [super init];
+  if (self) {
+    _promise = promise;
+    _pendingPromises = [[NSMutableArray alloc] init];
+    _errors = [[NSMutableArray alloc] init];
+    _results = keepsResults ? [[FSLPromiseResults alloc] initWithCount:items.count] : nil;
+    _target = target;
+    _items = items;
+    _mode = mode;
+    _work = [work copy];
+    FSLPromiseMapper __weak *weakSelf = self;
+    [promise addCancellationHandler:^{
+      [weakSelf settle];
+    }];
+  }
+  return self;
+}
+
+- (void)startLanes:(NSUInteger)count {
+  FSLPromise *promise;
+  @synchronized(self) {
+    promise = _promise;
+    _runningLanesCount = count;
+    for (NSUInteger lane = 0; lane < count; ++lane) {
+      [_pendingPromises addObject:[NSNull null]];
+    }
+  }
+  for (NSUInteger lane = 0; lane < count; ++lane) {
+    [promise dispatchOnTarget:_target
+                        block:^{
+                          [self runLane:lane];
+                        }];
+  }
+}
+
+#pragma mark - Private
+
+/**
+ Invokes the work for the next items, as long as it completes synchronously, until it returns a
+ pending promise or there are no items left.
+ */
+- (void)runLane:(NSUInteger)lane {
+  while (YES) {
+    NSUInteger index = NSNotFound;
+    BOOL isLastLane = NO;
+    @synchronized(self) {
+      if (!_promise) {
+        return;
+      }
+      if (_nextIndex < _items.count) {
+        index = _nextIndex++;
+      } else {
+        isLastLane = --_runningLanesCount == 0;
+      }
+    }
+    if (index == NSNotFound) {
+      if (isLastLane) {
+        [self finish];
+      }
+      return;
+    }
+    id value = _work(_items[index]);
+    if ([value isKindOfClass:[FSLPromise class]]) {
+      FSLPromise *promise = (FSLPromise *)value;
+      BOOL isSettled;
+      @synchronized(self) {
+        isSettled = _promise == nil;
+        if (!isSettled) {
+          _pendingPromises[lane] = promise;
+          // Observe under the lock, so that settling never detaches from work not observed yet.
+          [promise observeOnTarget:_target
+              fulfill:^(id __nullable result) {
+                if ([self completeItemAtIndex:index inLane:lane withResult:result]) {
+                  [self runLane:lane];
+                }
+              }
+              reject:^(NSError *error) {
+                if ([self completeItemAtIndex:index inLane:lane withResult:error]) {
+                  [self runLane:lane];
+                }
+              }];
+        }
+      }
+      if (isSettled) {
+        [promise cancelUnlessObserved];
+      }
+      return;
+    }
+    if (![self completeItemAtIndex:index inLane:lane withResult:value]) {
+      return;
+    }
+  }
+}
+
+/**
+ Stores the result of the work for the item at `index`, or rejects on error in fail-fast mode.
+
+ @return YES if the lane should take the next item.
+ */
+- (BOOL)completeItemAtIndex:(NSUInteger)index
+                     inLane:(NSUInteger)lane
+                 withResult:(nullable id)result {
+  BOOL isError = [result isKindOfClass:[NSError class]];
+  if (isError && _mode == FSLPromiseMapModeFailFast) {
+    [[self settle] reject:result];
+    return NO;
+  }
+  @synchronized(self) {
+    if (!_promise) {
+      return NO;
+    }
+    _pendingPromises[lane] = [NSNull null];
+    if (isError && !_results) {
+      [_errors addObject:result];
+    }
+  }
+  [_results setObject:result atIndex:index];
+  return YES;
+}
+
+/**
+ Fulfills the promise once the work for all items has completed.
+ */
+- (void)finish {
+  NSArray<NSError *> *errors;
+  @synchronized(self) {
+    errors = [_errors copy];
+  }
+  [[self settle] fulfill:_results ? _results.array : errors];
+}
+
+/**
+ Drops the references to the promise and to the pending work, and detaches from the latter.
+
+ @return The promise to resolve, or nil if it has been settled already.
+ */
+- (nullable FSLPromise *)settle {
+  FSLPromise *promise;
+  NSArray *pendingPromises;
+  @synchronized(self) {
+    promise = _promise;
+    pendingPromises = _pendingPromises;
+    _promise = nil;
+    _pendingPromises = nil;
+  }
+  for (id pendingPromise in pendingPromises) {
+    if ([pendingPromise isKindOfClass:[FSLPromise class]]) {
+      [(FSLPromise *)pendingPromise detachObserver];
+    }
+  }
+  return promise;
+}
+
+@end
+
+@implementation FSLPromise (MapAdditions)
+
++ (FSLPromise<NSArray *> *)map:(NSArray *)items
+                   concurrency:(NSUInteger)count
+                          work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue map:items concurrency:count work:work];
+}
+
++ (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
+                               map:(NSArray *)items
+                       concurrency:(NSUInteger)count
+                              work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:queue
+                   map:items
+           concurrency:count
+                  mode:FSLPromiseMapModeFailFast
+                  work:work];
+}
+
++ (FSLPromise<NSArray *> *)map:(NSArray *)items
+                   concurrency:(NSUInteger)count
+                          mode:(FSLPromiseMapMode)mode
+                          work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue
+                   map:items
+           concurrency:count
+                  mode:mode
+                  work:work];
+}
+
++ (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
+                               map:(NSArray *)items
+                       concurrency:(NSUInteger)count
+                              mode:(FSLPromiseMapMode)mode
+                              work:(FSLPromiseMapWorkBlock)work {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue)
+                 items:items
+           concurrency:count
+                  mode:mode
+          keepsResults:YES
+                  work:work];
+}
+
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                  map:(NSArray *)items
+                          concurrency:(NSUInteger)count
+                                 mode:(FSLPromiseMapMode)mode
+                                 work:(FSLPromiseMapWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor)
+                 items:items
+           concurrency:count
+                  mode:mode
+          keepsResults:YES
+                  work:work];
+}
+
++ (FSLPromise<NSArray<NSError *> *> *)forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue forEach:items concurrency:count work:work];
+}
+
++ (FSLPromise<NSArray<NSError *> *> *)onQueue:(dispatch_queue_t)queue
+                                      forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:queue
+               forEach:items
+           concurrency:count
+                  mode:FSLPromiseMapModeFailFast
+                  work:work];
+}
+
++ (FSLPromise<NSArray<NSError *> *> *)forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         mode:(FSLPromiseMapMode)mode
+                                         work:(FSLPromiseMapWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue
+               forEach:items
+           concurrency:count
+                  mode:mode
+                  work:work];
+}
+
++ (FSLPromise<NSArray<NSError *> *> *)onQueue:(dispatch_queue_t)queue
+                                      forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         mode:(FSLPromiseMapMode)mode
+                                         work:(FSLPromiseMapWorkBlock)work {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue)
+                 items:items
+           concurrency:count
+                  mode:mode
+          keepsResults:NO
+                  work:work];
+}
+
++ (FSLPromise<NSArray<NSError *> *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                         forEach:(NSArray *)items
+                                     concurrency:(NSUInteger)count
+                                            mode:(FSLPromiseMapMode)mode
+                                            work:(FSLPromiseMapWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor)
+                 items:items
+           concurrency:count
+                  mode:mode
+          keepsResults:NO
+                  work:work];
+}
+
+#pragma mark - Private
+
++ (FSLPromise *)onTarget:(void *)target
+                   items:(NSArray *)mapItems
+             concurrency:(NSUInteger)count
+                    mode:(FSLPromiseMapMode)mode
+            keepsResults:(BOOL)keepsResults
+                    work:(FSLPromiseMapWorkBlock)work {
+  NSParameterAssert(mapItems);
+  NSParameterAssert(work);
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("map");
+  if (mapItems.count == 0) {
+    return [[self alloc] initWithResolution:@[]];
+  }
+  NSArray *items = [mapItems copy];
+  FSLPromise *promise = [[self alloc] initPending];
+  FSLPromiseMapper *mapper = [[FSLPromiseMapper alloc] initWithPromise:promise
+                                                                target:target
+                                                                 items:items
+                                                                  mode:mode
+                                                          keepsResults:keepsResults
+                                                                  work:work];
+  [mapper startLanes:MIN(MAX(count, (NSUInteger)1), items.count)];
+  return promise;
+}
+
+@end
+
+@implementation FSLPromise (DotSyntax_MapAdditions)
+
++ (FSLPromise<NSArray *> * (^)(NSArray *, NSUInteger, FSLPromiseMapWorkBlock))map {
+  return ^(NSArray *items, NSUInteger count, FSLPromiseMapWorkBlock work) {
+    return [self map:items concurrency:count work:work];
+  };
+}
+
++ (FSLPromise<NSArray *> * (^)(dispatch_queue_t, NSArray *, NSUInteger,
+                               FSLPromiseMapWorkBlock))mapOn {
+  return ^(dispatch_queue_t queue, NSArray *items, NSUInteger count, FSLPromiseMapWorkBlock work) {
+    return [self onQueue:queue map:items concurrency:count work:work];
+  };
+}
+
++ (FSLPromise<NSArray<NSError *> *> * (^)(NSArray *, NSUInteger, FSLPromiseMapWorkBlock))forEach {
+  return ^(NSArray *items, NSUInteger count, FSLPromiseMapWorkBlock work) {
+    return [self forEach:items concurrency:count work:work];
+  };
+}
+
++ (FSLPromise<NSArray<NSError *> *> * (^)(dispatch_queue_t, NSArray *, NSUInteger,
+                                          FSLPromiseMapWorkBlock))forEachOn {
+  return ^(dispatch_queue_t queue, NSArray *items, NSUInteger count, FSLPromiseMapWorkBlock work) {
+    return [self onQueue:queue forEach:items concurrency:count work:work];
+  };
+}
+
+@end
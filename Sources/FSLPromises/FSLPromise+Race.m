@@ -14,36 +14,284 @@
  limitations under the License.
  */
 
+
 #import "FSLPromise+Race.h"
 
-#import "FSLPromise+Async.h"
 #import "FSLPromisePrivate.h"
 
+/**
+ Subscription of a race to its inputs. The first input to settle resolves the race through it,
+ after which it drops the references to the race and to the inputs, so that the losing inputs
+ don't keep them alive through their observers until they resolve too.
+ */
+@interface FSLPromiseRaceSubscription : NSObject
+
+/**
+ Creates a subscription to resolve `promise` with.
+
+ @param cancelLosers Whether to detach from the losing inputs, so that they get cancelled unless
+                     anything else observes them.
+ */
+- (instancetype)initWithPromise:(FSLPromise *)promise cancelLosers:(BOOL)cancelLosers;
+
+/**
+ Whether the race has been resolved or cancelled.
+ */
+@property(nonatomic, readonly) BOOL isSettled;
+
+/**
+ Observes an input on `target`. If the race has been settled, cancels the input instead when
+ cancelling losers, unless anything else observes it.
+ */
+- (void)subscribeToPromise:(FSLPromise *)promise onTarget:(void *)target;
+
+/**
+ Resolves the race with a value or an error, unless it has been settled already.
+ */
+- (void)settleWithResolution:(nullable id)resolution;
+
+/**
+ Asynchronously starts the work block at `index` and then the next ones, one at a time, unless the
+ race has been settled by then.
+ */
+- (void)startWork:(NSArray<FSLPromiseRaceWorkBlock> *)work
+          atIndex:(NSUInteger)index
+         onTarget:(void *)target;
+
+@end
+
+@implementation FSLPromiseRaceSubscription {
+  /** The race, or nil once settled. */
+  FSLPromise *_promise;
+  /** Inputs subscribed to so far. */
+  NSMutableArray<FSLPromise *> *_promises;
+  BOOL _cancelLosers;
+}
+
+- (instancetype)initWithPromise:(FSLPromise *)promise cancelLosers:(BOOL)cancelLosers {
+  self = [super init];
+  if (self) {
+    _promise = promise;
+    _promises = [[NSMutableArray alloc] init];
+    _cancelLosers = cancelLosers;
+    // Cancelling the race detaches from all inputs regardless of `cancelLosers`, like cancelling
+    // any other combined promise does.
+    FSLPromiseRaceSubscription __weak *weakSelf = self;
+    [promise addCancellationHandler:^{
+      [weakSelf detachFromPromises:[weakSelf unsubscribe] exceptAtIndex:NSNotFound];
+    }];
+  }
+  return self;
+}
+
+- (BOOL)isSettled {
+  @synchronized(self) {
+    return _promise == nil;
+  }
+}
+
+- (void)subscribeToPromise:(FSLPromise *)promise onTarget:(void *)target {
+  BOOL isSettled;
+  @synchronized(self) {
+    isSettled = _promise == nil;
+    NSUInteger index = _promises.count;
+    [_promises addObject:promise];
+    if (!isSettled) {
+      // Observe under the lock, so that settling never detaches from an input not observed yet.
+      [promise observeOnTarget:target
+          fulfill:^(id __nullable value) {
+            [self settleWithResolution:value fromPromiseAtIndex:index];
+          }
+          reject:^(NSError *error) {
+            [self settleWithResolution:error fromPromiseAtIndex:index];
+          }];
+    }
+  }
+  if (isSettled && _cancelLosers) {
+    [promise cancelUnlessObserved];
+  }
+}
+
+- (void)settleWithResolution:(nullable id)resolution {
+  [self settleWithResolution:resolution fromPromiseAtIndex:NSNotFound];
+}
+
+- (void)startWork:(NSArray<FSLPromiseRaceWorkBlock> *)work
+          atIndex:(NSUInteger)index
+         onTarget:(void *)target {
+  FSLPromise *promise;
+  @synchronized(self) {
+    promise = _promise;
+  }
+  if (!promise || index >= work.count) {
+    return;
+  }
+  [promise dispatchOnTarget:target
+                      block:^{
+                        if (self.isSettled) {
+                          return;
+                        }
+                        id value = work[index]();
+                        if ([value isKindOfClass:[FSLPromise class]]) {
+                          [self subscribeToPromise:value onTarget:target];
+                        } else {
+                          [self settleWithResolution:value];
+                        }
+                        // Starting the next block only now lets an already resolved promise
+                        // returned by this one win the race first on a serial queue.
+                        [self startWork:work atIndex:index + 1 onTarget:target];
+                      }];
+}
+
+#pragma mark - Private
+
+/**
+ Resolves the race, unless it has been settled already, and detaches from the losers if needed.
+ */
+- (void)settleWithResolution:(nullable id)resolution fromPromiseAtIndex:(NSUInteger)index {
+  FSLPromise *promise;
+  NSArray<FSLPromise *> *promises;
+  @synchronized(self) {
+    promise = _promise;
+    promises = _promises;
+    _promise = nil;
+    _promises = nil;
+  }
+  if (!promise) {
+    return;
+  }
+  [promise fulfill:resolution];
+  if (_cancelLosers) {
+    [self detachFromPromises:promises exceptAtIndex:index];
+  }
+}
+
+/**
+ Settles the race without resolving it.
+
+ @return The inputs subscribed to, or nil if the race has been settled already.
+ */
+- (nullable NSArray<FSLPromise *> *)unsubscribe {
+  @synchronized(self) {
+    NSArray<FSLPromise *> *promises = _promise ? _promises : nil;
+    _promise = nil;
+    _promises = nil;
+    return promises;
+  }
+}
+
+- (void)detachFromPromises:(nullable NSArray<FSLPromise *> *)promises
+             exceptAtIndex:(NSUInteger)index {
+  [promises enumerateObjectsUsingBlock:^(FSLPromise *promise, NSUInteger promiseIndex,
+                                         BOOL __unused *_) {
+    if (promiseIndex != index) {
+      [promise detachObserver];
+    }
+  }];
+}
+
+@end
+
 @implementation FSLPromise (RaceAdditions)
 
 + (instancetype)race:(NSArray *)promises {
   return [self onQueue:self.defaultDispatchQueue race:promises];
 }
 
-+ (instancetype)onQueue:(dispatch_queue_t)queue race:(NSArray *)racePromises {
++ (instancetype)onQueue:(dispatch_queue_t)queue race:(NSArray *)promises {
+  return [self onQueue:queue race:promises cancelLosers:NO];
+}
+
++ (instancetype)race:(NSArray *)promises cancelLosers:(BOOL)cancelLosers {
+  return [self onQueue:self.defaultDispatchQueue race:promises cancelLosers:cancelLosers];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                   race:(NSArray *)promises
+           cancelLosers:(BOOL)cancelLosers {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) race:promises cancelLosers:cancelLosers];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor race:(NSArray *)promises {
+  return [self onExecutor:executor race:promises cancelLosers:NO];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                      race:(NSArray *)promises
+              cancelLosers:(BOOL)cancelLosers {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor)
+                   race:promises
+           cancelLosers:cancelLosers];
+}
+
++ (instancetype)raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work {
+  return [self onQueue:self.defaultDispatchQueue raceWork:work];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+               raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) raceWork:work];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                  raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) raceWork:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:race:cancelLosers:`, but observes the promises on `target`.
+ */
++ (instancetype)onTarget:(void *)target
+                    race:(NSArray *)racePromises
+            cancelLosers:(BOOL)cancelLosers {
   NSAssert(racePromises.count > 0, @"No promises to observe");
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("race");
   NSArray *promises = [racePromises copy];
-  return [self onQueue:queue
-                       async:^(FSLPromiseFulfillBlock fulfill, FSLPromiseRejectBlock reject) {
-                         for (id promise in promises) {
-                           if (![promise isKindOfClass:self]) {
-                             fulfill(promise);
-                             return;
-                           }
-                         }
-                         // Subscribe all, but only the first one to resolve will change
-                         // the resulting promise's state.
-                         for (FSLPromise *promise in promises) {
-                           [promise observeOnQueue:queue fulfill:fulfill reject:reject];
-                         }
-                       }];
+  FSLPromise *combinedPromise = [[self alloc] initPending];
+  [combinedPromise
+      dispatchOnTarget:target
+                 block:^{
+                   for (id promise in promises) {
+                     if (![promise isKindOfClass:self]) {
+                       [combinedPromise fulfill:promise];
+                       return;
+                     }
+                   }
+                   // Subscribe all, but only the first one to resolve will change
+                   // the resulting promise's state.
+                   FSLPromiseRaceSubscription *subscription =
+                       [[FSLPromiseRaceSubscription alloc] initWithPromise:combinedPromise
+                                                              cancelLosers:cancelLosers];
+                   for (FSLPromise *promise in promises) {
+                     [subscription subscribeToPromise:promise onTarget:target];
+                   }
+                 }];
+  return combinedPromise;
+}
+
+/**
+ Same as `onQueue:raceWork:`, but invokes the work on `target`.
+ */
++ (instancetype)onTarget:(void *)target raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)raceWork {
+  NSAssert(raceWork.count > 0, @"No work to race");
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("raceWork");
+  FSLPromise *combinedPromise = [[self alloc] initPending];
+  FSLPromiseRaceSubscription *subscription =
+      [[FSLPromiseRaceSubscription alloc] initWithPromise:combinedPromise cancelLosers:YES];
+  [subscription startWork:[raceWork copy] atIndex:0 onTarget:target];
+  return combinedPromise;
 }
 
 @end
@@ -62,4 +310,16 @@
   };
 }
 
++ (FSLPromise * (^)(NSArray<FSLPromiseRaceWorkBlock> *))raceWork {
+  return ^(NSArray<FSLPromiseRaceWorkBlock> *work) {
+    return [self raceWork:work];
+  };
+}
+
++ (FSLPromise * (^)(dispatch_queue_t, NSArray<FSLPromiseRaceWorkBlock> *))raceWorkOn {
+  return ^(dispatch_queue_t queue, NSArray<FSLPromiseRaceWorkBlock> *work) {
+    return [self onQueue:queue raceWork:work];
+  };
+}
+
 @end
@@ -26,13 +26,31 @@
 
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue recover:(FSLPromiseRecoverWorkBlock)recovery {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) recover:recovery];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                   recover:(FSLPromiseRecoverWorkBlock)recovery {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) recover:recovery];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:recover:`, but invokes `recovery` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target recover:(FSLPromiseRecoverWorkBlock)recovery {
   NSParameterAssert(recovery);
 
-  return [self chainOnQueue:queue
-             chainedFulfill:nil
-              chainedReject:^id(NSError *error) {
-                return recovery(error);
-              }];
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("recover");
+  return [self chainOnTarget:target
+              chainedFulfill:nil
+               chainedReject:^id(NSError *error) {
+                 return recovery(error);
+               }];
 }
 
 @end
@@ -17,6 +17,87 @@
 #import "FSLPromise+Reduce.h"
 
 #import "FSLPromisePrivate.h"
+#import "FSLPromiseResults.h"
+
+/** Max number of values combined in a row before letting other blocks run on the target. */
+static NSUInteger const FSLPromiseLazyReduceBatchCount = 256;
+
+static void FSLPromiseLazyReduce(FSLPromise *promise, void *target, NSEnumerator *items,
+                                 FSLPromiseReducerBlock reducer, id __nullable partial) {
+  NSUInteger count = 0;
+  // Stop taking values once the promise gets cancelled, without pulling one more from `items`.
+  while (promise.isPending) {
+    id item = [items nextObject];
+    if (!item) {
+      [promise fulfill:partial];
+      return;
+    }
+    partial = reducer(partial, item);
+    if ([partial isKindOfClass:[FSLPromise class]]) {
+      [(FSLPromise *)partial observeOnTarget:target
+          fulfill:^(id __nullable value) {
+            FSLPromiseLazyReduce(promise, target, items, reducer, value);
+          }
+          reject:^(NSError *error) {
+            [promise reject:error];
+          }];
+      [promise propagateCancellationToPromise:partial];
+      return;
+    }
+    if ([partial isKindOfClass:[NSError class]]) {
+      [promise reject:partial];
+      return;
+    }
+    if (++count == FSLPromiseLazyReduceBatchCount) {
+      [promise dispatchOnTarget:target
+                          block:^{
+                            FSLPromiseLazyReduce(promise, target, items, reducer, partial);
+                          }];
+      return;
+    }
+  }
+}
+
+static void FSLPromiseTreeReduce(FSLPromise *promise, void *target, NSArray *items,
+                                 FSLPromiseReducerBlock reducer, id __nullable initial) {
+  NSUInteger const count = items.count;
+  if (count == 0) {
+    [promise fulfill:initial];
+    return;
+  }
+  NSUInteger const chunksCount = MIN(count, NSProcessInfo.processInfo.activeProcessorCount);
+  FSLPromiseResults *partials = [[FSLPromiseResults alloc] initWithCount:chunksCount];
+  for (NSUInteger chunk = 0; chunk < chunksCount; ++chunk) {
+    NSUInteger const start = count * chunk / chunksCount;
+    NSUInteger const end = count * (chunk + 1) / chunksCount;
+    [promise dispatchOnTarget:target
+                        block:^{
+                          // Only the first chunk starts with the initial value, for the reducer
+                          // to combine it once.
+                          id partial = chunk == 0 ? reducer(initial, items[start]) : items[start];
+                          for (NSUInteger i = start + 1; i < end && promise.isPending; ++i) {
+                            if ([partial isKindOfClass:[NSError class]]) {
+                              break;
+                            }
+                            partial = reducer(partial, items[i]);
+                          }
+                          if ([partial isKindOfClass:[NSError class]]) {
+                            [promise reject:partial];
+                          }
+                          if (![partials setObject:partial atIndex:chunk] || !promise.isPending) {
+                            return;
+                          }
+                          id result = [partials objectAtIndex:0];
+                          for (NSUInteger i = 1; i < chunksCount; ++i) {
+                            result = reducer(result, [partials objectAtIndex:i]);
+                            if ([result isKindOfClass:[NSError class]]) {
+                              break;
+                            }
+                          }
+                          [promise fulfill:result];
+                        }];
+  }
+}
 
 @implementation FSLPromise (ReduceAdditions)
 
@@ -28,20 +109,128 @@
                  reduce:(NSArray *)items
                 combine:(FSLPromiseReducerBlock)reducer {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) reduce:items combine:reducer];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                    reduce:(NSArray *)items
+                   combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) reduce:items combine:reducer];
+}
+
+- (FSLPromise *)lazyReduce:(NSEnumerator *)items combine:(FSLPromiseReducerBlock)reducer {
+  return [self onQueue:FSLPromise.defaultDispatchQueue lazyReduce:items combine:reducer];
+}
+
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+             lazyReduce:(NSEnumerator *)items
+                combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) lazyReduce:items combine:reducer];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                lazyReduce:(NSEnumerator *)items
+                   combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) lazyReduce:items combine:reducer];
+}
+
+- (FSLPromise *)treeReduce:(NSArray *)items combine:(FSLPromiseReducerBlock)reducer {
+  return [self onQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+            treeReduce:items
+               combine:reducer];
+}
+
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+             treeReduce:(NSArray *)items
+                combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) treeReduce:items combine:reducer];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                treeReduce:(NSArray *)items
+                   combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) treeReduce:items combine:reducer];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:reduce:combine:`, but invokes `reducer` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target
+                  reduce:(NSArray *)items
+                 combine:(FSLPromiseReducerBlock)reducer {
   NSParameterAssert(items);
   NSParameterAssert(reducer);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("reduce");
   FSLPromise *promise = self;
   for (id item in items) {
-    promise = [promise chainOnQueue:queue
-                     chainedFulfill:^id(id value) {
-                       return reducer(value, item);
-                     }
-                      chainedReject:nil];
+    promise = [promise chainOnTarget:target
+                      chainedFulfill:^id(id value) {
+                        return reducer(value, item);
+                      }
+                       chainedReject:nil];
   }
   return promise;
 }
 
+/**
+ Same as `onQueue:lazyReduce:combine:`, but invokes `reducer` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target
+              lazyReduce:(NSEnumerator *)items
+                 combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(items);
+  NSParameterAssert(reducer);
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("lazyReduce");
+  FSLPromise *promise = [[[self class] alloc] initPending];
+  [self observeOnTarget:target
+      fulfill:^(id __nullable value) {
+        FSLPromiseLazyReduce(promise, target, items, reducer, value);
+      }
+      reject:^(NSError *error) {
+        [promise reject:error];
+      }];
+  [promise propagateCancellationToPromise:self];
+  return promise;
+}
+
+/**
+ Same as `onQueue:treeReduce:combine:`, but invokes `reducer` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target
+              treeReduce:(NSArray *)items
+                 combine:(FSLPromiseReducerBlock)reducer {
+  NSParameterAssert(items);
+  NSParameterAssert(reducer);
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("treeReduce");
+  NSArray *values = [items copy];
+  FSLPromise *promise = [[[self class] alloc] initPending];
+  [self observeOnTarget:target
+      fulfill:^(id __nullable value) {
+        FSLPromiseTreeReduce(promise, target, values, reducer, value);
+      }
+      reject:^(NSError *error) {
+        [promise reject:error];
+      }];
+  [promise propagateCancellationToPromise:self];
+  return promise;
+}
+
 @end
 
 @implementation FSLPromise (DotSyntax_ReduceAdditions)
@@ -58,4 +247,28 @@
   };
 }
 
+- (FSLPromise * (^)(NSEnumerator *, FSLPromiseReducerBlock))lazyReduce {
+  return ^(NSEnumerator *items, FSLPromiseReducerBlock reducer) {
+    return [self lazyReduce:items combine:reducer];
+  };
+}
+
+- (FSLPromise * (^)(dispatch_queue_t, NSEnumerator *, FSLPromiseReducerBlock))lazyReduceOn {
+  return ^(dispatch_queue_t queue, NSEnumerator *items, FSLPromiseReducerBlock reducer) {
+    return [self onQueue:queue lazyReduce:items combine:reducer];
+  };
+}
+
+- (FSLPromise * (^)(NSArray *, FSLPromiseReducerBlock))treeReduce {
+  return ^(NSArray *items, FSLPromiseReducerBlock reducer) {
+    return [self treeReduce:items combine:reducer];
+  };
+}
+
+- (FSLPromise * (^)(dispatch_queue_t, NSArray *, FSLPromiseReducerBlock))treeReduceOn {
+  return ^(dispatch_queue_t queue, NSArray *items, FSLPromiseReducerBlock reducer) {
+    return [self onQueue:queue treeReduce:items combine:reducer];
+  };
+}
+
 @end
@@ -16,30 +16,90 @@
 
 #import "FSLPromise+Retry.h"
 
+#import <time.h>
+
 #import "FSLPromisePrivate.h"
 
 NSInteger const FSLPromiseRetryDefaultAttemptsCount = 1;
 NSTimeInterval const FSLPromiseRetryDefaultDelayInterval = 1.0;
 
-static void FSLPromiseRetryAttempt(FSLPromise *promise, dispatch_queue_t queue, NSInteger count,
-                                   NSTimeInterval interval, FSLPromiseRetryPredicateBlock predicate,
+/**
+ Delays between retry attempts and the time limit for them.
+ */
+typedef struct {
+  NSTimeInterval initialDelay;
+  NSTimeInterval maxDelay;
+  FSLPromiseRetryJitter jitter;
+  /** Time of the monotonic clock past which no more attempts are made, or zero. */
+  NSTimeInterval deadlineTime;
+} FSLPromiseRetryBackoff;
+
+/**
+ Returns the current time of a monotonic clock in seconds.
+ */
+static NSTimeInterval FSLPromiseRetryNow(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (NSTimeInterval)time.tv_sec + (NSTimeInterval)time.tv_nsec / NSEC_PER_SEC;
+}
+
+/**
+ Returns the time to wait before the next retry attempt, given the time waited before the previous
+ one, or zero if there was none.
+ */
+static NSTimeInterval FSLPromiseRetryNextDelay(FSLPromiseRetryBackoff backoff,
+                                               NSTimeInterval previousDelay) {
+  NSTimeInterval delay = backoff.initialDelay;
+  switch (backoff.jitter) {
+    case FSLPromiseRetryJitterNone:
+      delay = previousDelay > 0 ? previousDelay * 2 : backoff.initialDelay;
+      break;
+    case FSLPromiseRetryJitterDecorrelated: {
+      NSTimeInterval upperDelay = 3 * (previousDelay > 0 ? previousDelay : backoff.initialDelay);
+      double random = (double)arc4random() / UINT32_MAX;
+      delay = backoff.initialDelay + random * (upperDelay - backoff.initialDelay);
+      break;
+    }
+  }
+  return MIN(delay, backoff.maxDelay);
+}
+
+static void FSLPromiseRetryAttempt(FSLPromise *promise, void *target,
+                                   NSInteger count, NSTimeInterval previousDelay,
+                                   FSLPromiseRetryBackoff backoff,
+                                   FSLPromiseRetryBudget *budget,
+                                   FSLPromiseRetryPredicateBlock predicate,
                                    FSLPromiseRetryWorkBlock work) {
   __auto_type retrier = ^(id __nullable value) {
     if ([value isKindOfClass:[NSError class]]) {
-      if (count <= 0 || (predicate && !predicate(count, value))) {
+      // The circuit breaker has rejected the attempt right away, so retrying it would be too.
+      if (FSLPromiseErrorIsCircuitOpen(value)) {
+        [promise reject:value];
+        return;
+      }
+      // Every failed attempt takes a token, whether it's going to be retried or not.
+      BOOL isRetryAllowed = budget ? [budget recordFailure] : YES;
+      NSTimeInterval delay = FSLPromiseRetryNextDelay(backoff, previousDelay);
+      if (count <= 0 || (predicate && !predicate(count, value)) || !isRetryAllowed ||
+          (backoff.deadlineTime > 0 && FSLPromiseRetryNow() + delay > backoff.deadlineTime)) {
         [promise reject:value];
       } else {
-        dispatch_after(dispatch_time(0, (int64_t)(interval * NSEC_PER_SEC)), queue, ^{
-          FSLPromiseRetryAttempt(promise, queue, count - 1, interval, predicate, work);
-        });
+        [promise dispatchAfterInterval:delay
+                              onTarget:target
+                                 block:^{
+                                   FSLPromiseRetryAttempt(promise, target, count - 1, delay,
+                                                          backoff, budget, predicate, work);
+                                 }];
       }
     } else {
+      [budget recordSuccess];
       [promise fulfill:value];
     }
   };
   id value = work();
   if ([value isKindOfClass:[FSLPromise class]]) {
-    [(FSLPromise *)value observeOnQueue:queue fulfill:retrier reject:retrier];
+    [(FSLPromise *)value observeOnTarget:target fulfill:retrier reject:retrier];
+    [promise propagateCancellationToPromise:value];
   } else  {
     retrier(value);
   }
@@ -85,11 +145,106 @@ static void FSLPromiseRetryAttempt(FSLPromise *promise, dispatch_queue_t queue,
                   delay:(NSTimeInterval)interval
               condition:(nullable FSLPromiseRetryPredicateBlock)predicate
                   retry:(FSLPromiseRetryWorkBlock)work {
+  return [self onQueue:queue
+              attempts:count
+          initialDelay:interval
+              maxDelay:interval
+                jitter:FSLPromiseRetryJitterNone
+              deadline:0
+                budget:nil
+             condition:predicate
+                 retry:work];
+}
+
++ (instancetype)attempts:(NSInteger)count
+            initialDelay:(NSTimeInterval)initialDelay
+                maxDelay:(NSTimeInterval)maxDelay
+                  jitter:(FSLPromiseRetryJitter)jitter
+                deadline:(NSTimeInterval)deadline
+                  budget:(nullable FSLPromiseRetryBudget *)budget
+               condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                   retry:(FSLPromiseRetryWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue
+              attempts:count
+          initialDelay:initialDelay
+              maxDelay:maxDelay
+                jitter:jitter
+              deadline:deadline
+                budget:budget
+             condition:predicate
+                 retry:work];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+               attempts:(NSInteger)count
+           initialDelay:(NSTimeInterval)initialDelay
+               maxDelay:(NSTimeInterval)maxDelay
+                 jitter:(FSLPromiseRetryJitter)jitter
+               deadline:(NSTimeInterval)deadline
+                 budget:(nullable FSLPromiseRetryBudget *)budget
+              condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                  retry:(FSLPromiseRetryWorkBlock)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue)
+               attempts:count
+           initialDelay:initialDelay
+               maxDelay:maxDelay
+                 jitter:jitter
+               deadline:deadline
+                 budget:budget
+              condition:predicate
+                  retry:work];
+}
+
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                  attempts:(NSInteger)count
+              initialDelay:(NSTimeInterval)initialDelay
+                  maxDelay:(NSTimeInterval)maxDelay
+                    jitter:(FSLPromiseRetryJitter)jitter
+                  deadline:(NSTimeInterval)deadline
+                    budget:(nullable FSLPromiseRetryBudget *)budget
+                 condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                     retry:(FSLPromiseRetryWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor)
+               attempts:count
+           initialDelay:initialDelay
+               maxDelay:maxDelay
+                 jitter:jitter
+               deadline:deadline
+                 budget:budget
+              condition:predicate
+                  retry:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:attempts:initialDelay:maxDelay:jitter:deadline:budget:condition:retry:`, but
+ invokes `work` on `target`.
+ */
++ (instancetype)onTarget:(void *)target
+                attempts:(NSInteger)count
+            initialDelay:(NSTimeInterval)initialDelay
+                maxDelay:(NSTimeInterval)maxDelay
+                  jitter:(FSLPromiseRetryJitter)jitter
+                deadline:(NSTimeInterval)deadline
+                  budget:(nullable FSLPromiseRetryBudget *)budget
+               condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                   retry:(FSLPromiseRetryWorkBlock)work {
   NSParameterAssert(work);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("retry");
+  FSLPromiseRetryBackoff backoff = {
+      .initialDelay = initialDelay,
+      .maxDelay = MAX(initialDelay, maxDelay),
+      .jitter = jitter,
+      .deadlineTime = deadline > 0 ? FSLPromiseRetryNow() + deadline : 0,
+  };
   FSLPromise *promise = [[self alloc] initPending];
-  FSLPromiseRetryAttempt(promise, queue, count, interval, predicate, work);
+  FSLPromiseRetryAttempt(promise, target, count, 0, backoff, budget, predicate, work);
   return promise;
 }
 
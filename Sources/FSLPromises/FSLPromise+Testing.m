@@ -16,6 +16,54 @@
 
 #import "FSLPromise+Testing.h"
 
+#import <sched.h>
+#import <stdatomic.h>
+
+/** Which group `FSLPromise.dispatchGroup` currently is. */
+typedef NS_ENUM(int, FSLPromiseDispatchGroupKind) {
+  FSLPromiseDispatchGroupKindDefault = 0,
+  FSLPromiseDispatchGroupKindNone,
+  FSLPromiseDispatchGroupKindCustom,
+};
+
+/**
+ Kind of the current group, which only the setter writes to, so that promises created with the
+ default group or with none don't write to any shared memory to find out which group to enter.
+ */
+static _Atomic(int) gFSLPromiseDispatchGroupKind;
+
+/** Current `FSLPromise.dispatchGroup`, guarded by `gFSLPromiseDispatchGroupLock`. */
+static dispatch_group_t gFSLPromiseDispatchGroup;
+
+/**
+ Spin lock for promises to retain a group set with the setter before it can get replaced and
+ released, which is hardly ever contended, since the group is only replaced by tests.
+ */
+static _Atomic(bool) gFSLPromiseDispatchGroupLock;
+
+static void FSLPromiseDispatchGroupLock(void) {
+  while (atomic_exchange_explicit(&gFSLPromiseDispatchGroupLock, true, memory_order_acquire)) {
+    sched_yield();
+  }
+}
+
+static void FSLPromiseDispatchGroupUnlock(void) {
+  atomic_store_explicit(&gFSLPromiseDispatchGroupLock, false, memory_order_release);
+}
+
+/**
+ Returns the group promises are created in by default, which never gets released, so it's safe to
+ read without the lock.
+ */
+static dispatch_group_t FSLPromiseDefaultDispatchGroup(void) {
+  static dispatch_group_t gDispatchGroup;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    gDispatchGroup = dispatch_group_create();
+  });
+  return gDispatchGroup;
+}
+
 BOOL FSLWaitForPromisesWithTimeout(NSTimeInterval timeout) {
   BOOL isTimedOut = NO;
   NSDate *timeoutDate = [NSDate dateWithTimeIntervalSinceNow:timeout];
@@ -23,6 +71,9 @@ BOOL FSLWaitForPromisesWithTimeout(NSTimeInterval timeout) {
   static int64_t const minimalTimeToWait = (int64_t)(minimalTimeout * NSEC_PER_SEC);
   dispatch_time_t waitTime = dispatch_time(DISPATCH_TIME_NOW, minimalTimeToWait);
   dispatch_group_t dispatchGroup = FSLPromise.dispatchGroup;
+  if (!dispatchGroup) {
+    return YES;
+  }
   NSRunLoop *runLoop = NSRunLoop.currentRunLoop;
   while (dispatch_group_wait(dispatchGroup, waitTime)) {
     isTimedOut = timeoutDate.timeIntervalSinceNow < 0.0;
@@ -43,13 +94,40 @@ BOOL FSLWaitForPromisesWithTimeout(NSTimeInterval timeout) {
 @dynamic value;
 @dynamic error;
 
-+ (dispatch_group_t)dispatchGroup {
-  static dispatch_group_t gDispatchGroup;
-  static dispatch_once_t onceToken;
-  dispatch_once(&onceToken, ^{
-    gDispatchGroup = dispatch_group_create();
-  });
-  return gDispatchGroup;
++ (nullable dispatch_group_t)dispatchGroup {
+#ifdef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+  return nil;
+#else
+  int const kind = atomic_load_explicit(&gFSLPromiseDispatchGroupKind, memory_order_acquire);
+  if (kind == FSLPromiseDispatchGroupKindDefault) {
+    return FSLPromiseDefaultDispatchGroup();
+  }
+  if (kind == FSLPromiseDispatchGroupKindNone) {
+    return nil;
+  }
+  FSLPromiseDispatchGroupLock();
+  dispatch_group_t dispatchGroup = gFSLPromiseDispatchGroup;
+  FSLPromiseDispatchGroupUnlock();
+  return dispatchGroup;
+#endif
+}
+
++ (void)setDispatchGroup:(nullable dispatch_group_t)dispatchGroup {
+#ifndef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+  FSLPromiseDispatchGroupKind kind = FSLPromiseDispatchGroupKindCustom;
+  if (!dispatchGroup) {
+    kind = FSLPromiseDispatchGroupKindNone;
+  } else if (dispatchGroup == FSLPromiseDefaultDispatchGroup()) {
+    kind = FSLPromiseDispatchGroupKindDefault;
+  }
+  // The previous group gets released outside of the lock, and lives on while promises use it.
+  __attribute__((objc_precise_lifetime)) dispatch_group_t previousDispatchGroup;
+  FSLPromiseDispatchGroupLock();
+  previousDispatchGroup = gFSLPromiseDispatchGroup;
+  gFSLPromiseDispatchGroup = dispatchGroup;
+  atomic_store_explicit(&gFSLPromiseDispatchGroupKind, kind, memory_order_release);
+  FSLPromiseDispatchGroupUnlock();
+#endif
 }
 
 @end
@@ -26,9 +26,54 @@
 
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue then:(FSLPromiseThenWorkBlock)work {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) then:work];
+}
+
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+                 policy:(FSLPromiseExecutionPolicy)policy
+                   then:(FSLPromiseThenWorkBlock)work {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) policy:policy then:work];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor then:(FSLPromiseThenWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) then:work];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                    policy:(FSLPromiseExecutionPolicy)policy
+                      then:(FSLPromiseThenWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) policy:policy then:work];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:then:`, but invokes `work` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target then:(FSLPromiseThenWorkBlock)work {
+  NSParameterAssert(work);
+
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("then");
+  return [self chainOnTarget:target chainedFulfill:work chainedReject:nil];
+}
+
+/**
+ Same as `onQueue:policy:then:`, but invokes `work` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target
+                  policy:(FSLPromiseExecutionPolicy)policy
+                    then:(FSLPromiseThenWorkBlock)work {
   NSParameterAssert(work);
 
-  return [self chainOnQueue:queue chainedFulfill:work chainedReject:nil];
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("then");
+  return [self chainOnTarget:target policy:policy chainedFulfill:work chainedReject:nil];
 }
 
 @end
@@ -27,21 +27,44 @@
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue timeout:(NSTimeInterval)interval {
   NSParameterAssert(queue);
 
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) timeout:interval];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor timeout:(NSTimeInterval)interval {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) timeout:interval];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:timeout:`, but resolves the promise on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target timeout:(NSTimeInterval)interval {
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("timeout");
   FSLPromise *promise = [[[self class] alloc] initPending];
-  [self observeOnQueue:queue
+  FSLPromise* __weak weakPromise = promise;
+  dispatch_block_t cancelTimer = [promise
+      dispatchAfterInterval:interval
+                   onTarget:target
+                      block:^{
+                        NSError *timedOutError =
+                            [[NSError alloc] initWithDomain:FSLPromiseErrorDomain
+                                                       code:FSLPromiseErrorCodeTimedOut
+                                                   userInfo:nil];
+                        [weakPromise reject:timedOutError];
+                      }];
+  [self observeOnTarget:target
       fulfill:^(id __nullable value) {
+        cancelTimer();
         [promise fulfill:value];
       }
       reject:^(NSError *error) {
+        cancelTimer();
         [promise reject:error];
       }];
-  FSLPromise* __weak weakPromise = promise;
-  dispatch_after(dispatch_time(0, (int64_t)(interval * NSEC_PER_SEC)), queue, ^{
-    NSError *timedOutError = [[NSError alloc] initWithDomain:FSLPromiseErrorDomain
-                                                        code:FSLPromiseErrorCodeTimedOut
-                                                    userInfo:nil];
-    [weakPromise reject:timedOutError];
-  });
+  [promise propagateCancellationToPromise:self];
   return promise;
 }
 
@@ -26,15 +26,33 @@
 
 - (FSLPromise*)onQueue:(dispatch_queue_t)queue validate:(FSLPromiseValidateWorkBlock)predicate {
   NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) validate:predicate];
+}
+
+- (FSLPromise*)onExecutor:(id<FSLPromiseExecutor>)executor
+                 validate:(FSLPromiseValidateWorkBlock)predicate {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) validate:predicate];
+}
+
+#pragma mark - Private
+
+/**
+ Same as `onQueue:validate:`, but invokes `predicate` on `target`.
+ */
+- (FSLPromise*)onTarget:(void *)target validate:(FSLPromiseValidateWorkBlock)predicate {
   NSParameterAssert(predicate);
 
+  FSL_PROMISES_INSTRUMENT_COMBINATOR("validate");
   FSLPromiseChainedFulfillBlock chainedFulfill = ^id(id value) {
     return predicate(value) ? value :
                               [[NSError alloc] initWithDomain:FSLPromiseErrorDomain
                                                          code:FSLPromiseErrorCodeValidationFailure
                                                      userInfo:nil];
   };
-  return [self chainOnQueue:queue chainedFulfill:chainedFulfill chainedReject:nil];
+  return [self chainOnTarget:target chainedFulfill:chainedFulfill chainedReject:nil];
 }
 
 @end
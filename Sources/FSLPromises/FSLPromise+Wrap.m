@@ -17,6 +17,22 @@
 #import "FSLPromise+Wrap.h"
 
 #import "FSLPromise+Async.h"
+#import "FSLPromisePrivate.h"
+
+/** Resolves `promise` with `value` the same way `async:` does, adopting the state of promises. */
+static void FSLPromiseWrapResolve(FSLPromise *promise, id __nullable value) {
+  if ([value isKindOfClass:[FSLPromise class]]) {
+    [promise adoptPromise:(FSLPromise *)value];
+  } else {
+    [promise fulfill:value];
+  }
+}
+
+/** Boxes the objects provided by a completion handler into an array, with `NSNull` for `nil`. */
+static FSLPromise2ObjectsCombineBlock const FSLPromiseWrap2ObjectsArray =
+    ^id(id __nullable value1, id __nullable value2) {
+      return @[ value1 ?: [NSNull null], value2 ?: [NSNull null] ];
+    };
 
 @implementation FSLPromise (WrapAdditions)
 
@@ -124,8 +140,24 @@
 
 + (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
      wrap2ObjectsOrErrorCompletion:(void (^)(FSLPromise2ObjectsOrErrorCompletion))work {
+  return [self onQueue:queue
+      wrap2ObjectsOrErrorCompletion:work
+                            combine:FSLPromiseWrap2ObjectsArray];
+}
+
++ (instancetype)wrap2ObjectsOrErrorCompletion:(void (^)(FSLPromise2ObjectsOrErrorCompletion))work
+                                      combine:(FSLPromise2ObjectsCombineBlock)combine {
+  return [self onQueue:self.defaultDispatchQueue
+      wrap2ObjectsOrErrorCompletion:work
+                            combine:combine];
+}
+
++ (instancetype)onQueue:(dispatch_queue_t)queue
+    wrap2ObjectsOrErrorCompletion:(void (^)(FSLPromise2ObjectsOrErrorCompletion))work
+                          combine:(FSLPromise2ObjectsCombineBlock)combine {
   NSParameterAssert(queue);
   NSParameterAssert(work);
+  NSParameterAssert(combine);
 
   return [self onQueue:queue
                  async:^(FSLPromiseFulfillBlock fulfill, FSLPromiseRejectBlock reject) {
@@ -133,7 +165,7 @@
                      if (error) {
                        reject(error);
                      } else {
-                       fulfill(@[ value1 ?: [NSNull null], value2 ?: [NSNull null] ]);
+                       fulfill(combine(value1, value2));
                      }
                    });
                  }];
@@ -256,6 +288,165 @@
                  }];
 }
 
++ (instancetype)syncWrapCompletion:(void (^)(FSLPromiseCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^{
+    [promise fulfill:nil];
+  });
+  return promise;
+}
+
++ (instancetype)syncWrapObjectCompletion:(void (^)(FSLPromiseObjectCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(id __nullable value) {
+    FSLPromiseWrapResolve(promise, value);
+  });
+  return promise;
+}
+
++ (instancetype)syncWrapErrorCompletion:(void (^)(FSLPromiseErrorCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      [promise fulfill:nil];
+    }
+  });
+  return promise;
+}
+
++ (instancetype)syncWrapObjectOrErrorCompletion:(void (^)(FSLPromiseObjectOrErrorCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(id __nullable value, NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      FSLPromiseWrapResolve(promise, value);
+    }
+  });
+  return promise;
+}
+
++ (instancetype)syncWrapErrorOrObjectCompletion:(void (^)(FSLPromiseErrorOrObjectCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(NSError *__nullable error, id __nullable value) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      FSLPromiseWrapResolve(promise, value);
+    }
+  });
+  return promise;
+}
+
++ (FSLPromise<NSArray *> *)syncWrap2ObjectsOrErrorCompletion:
+    (void (^)(FSLPromise2ObjectsOrErrorCompletion))work {
+  return [self syncWrap2ObjectsOrErrorCompletion:work combine:FSLPromiseWrap2ObjectsArray];
+}
+
++ (instancetype)syncWrap2ObjectsOrErrorCompletion:
+                    (void (^)(FSLPromise2ObjectsOrErrorCompletion))work
+                                          combine:(FSLPromise2ObjectsCombineBlock)combine {
+  NSParameterAssert(work);
+  NSParameterAssert(combine);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(id __nullable value1, id __nullable value2, NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      FSLPromiseWrapResolve(promise, combine(value1, value2));
+    }
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapBoolCompletion:(void (^)(FSLPromiseBoolCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(BOOL value) {
+    [promise fulfill:@(value)];
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapBoolOrErrorCompletion:
+    (void (^)(FSLPromiseBoolOrErrorCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(BOOL value, NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      [promise fulfill:@(value)];
+    }
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapIntegerCompletion:(void (^)(FSLPromiseIntegerCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(NSInteger value) {
+    [promise fulfill:@(value)];
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapIntegerOrErrorCompletion:
+    (void (^)(FSLPromiseIntegerOrErrorCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(NSInteger value, NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      [promise fulfill:@(value)];
+    }
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapDoubleCompletion:(void (^)(FSLPromiseDoubleCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(double value) {
+    [promise fulfill:@(value)];
+  });
+  return promise;
+}
+
++ (FSLPromise<NSNumber *> *)syncWrapDoubleOrErrorCompletion:
+    (void (^)(FSLPromiseDoubleOrErrorCompletion))work {
+  NSParameterAssert(work);
+
+  FSLPromise *promise = [[self alloc] initPending];
+  work(^(double value, NSError *__nullable error) {
+    if (error) {
+      [promise reject:error];
+    } else {
+      [promise fulfill:@(value)];
+    }
+  });
+  return promise;
+}
+
 @end
 
 @implementation FSLPromise (DotSyntax_WrapAdditions)
@@ -15,43 +15,440 @@
  */
 
 #import "FSLPromisePrivate.h"
+#import "FSLPromiseTimerWheel.h"
+
+#import <sched.h>
+#import <stdatomic.h>
 
 /** All states a promise can be in. */
-typedef NS_ENUM(NSInteger, FSLPromiseState) {
+typedef NS_ENUM(uint8_t, FSLPromiseState) {
   FSLPromiseStatePending = 0,
   FSLPromiseStateFulfilled,
   FSLPromiseStateRejected,
+  /**
+   Transient state owned by the only caller that managed to claim the resolution, until it
+   publishes either `FSLPromiseStateFulfilled` or `FSLPromiseStateRejected`.
+   */
+  FSLPromiseStateResolving,
+  /**
+   Transient state owned by the only caller that managed to claim the forwarding, until it
+   publishes `FSLPromiseStateForwarded`.
+   */
+  FSLPromiseStateForwarding,
+  /**
+   The promise has adopted another one, which it forwards all observers and pending objects to,
+   and reports the state of, while ignoring resolution attempts. It counts as one observer of the
+   promise it forwards to, so that getting cancelled only detaches from that one.
+   */
+  FSLPromiseStateForwarded,
+  /**
+   Same as `FSLPromiseStateForwarded`, once the promise doesn't count as an observer of the promise
+   it forwards to anymore.
+   */
+  FSLPromiseStateForwardedDetached,
 };
 
-typedef void (^FSLPromiseObserver)(FSLPromiseState state, id __nullable resolution);
+/** Returns whether a promise in `state` forwards to another one. */
+static BOOL FSLPromiseStateIsForwarded(FSLPromiseState state) {
+  return state == FSLPromiseStateForwarded || state == FSLPromiseStateForwardedDetached;
+}
+
+/**
+ Spin locks guarding the promise each forwarding promise points to, which gets replaced as chains
+ of forwarding promises collapse, for readers to retain it before it can get released. Picked by
+ the address of the forwarding promise.
+ */
+static _Atomic(bool) gFSLPromiseForwardingLocks[64];
+
+static _Atomic(bool) *FSLPromiseForwardingLockFor(void const *promise) {
+  NSUInteger const count = sizeof(gFSLPromiseForwardingLocks) / sizeof(*gFSLPromiseForwardingLocks);
+  return &gFSLPromiseForwardingLocks[((uintptr_t)promise >> 4) % count];
+}
+
+static void FSLPromiseForwardingLock(void const *promise) {
+  _Atomic(bool) *lock = FSLPromiseForwardingLockFor(promise);
+  while (atomic_exchange_explicit(lock, true, memory_order_acquire)) {
+    sched_yield();
+  }
+}
+
+static void FSLPromiseForwardingUnlock(void const *promise) {
+  atomic_store_explicit(FSLPromiseForwardingLockFor(promise), false, memory_order_release);
+}
+
+/**
+ Observers and blocks target either a dispatch queue or an `FSLPromiseExecutor`, the latter being
+ told apart by this bit set in the pointer, which is always clear for objects.
+ */
+static uintptr_t const FSLPromiseTargetExecutorTag = 1;
+
+/** Returns whether a target points to an executor rather than a dispatch queue. */
+static BOOL FSLPromiseTargetIsExecutor(void const *target) {
+  return ((uintptr_t)target & FSLPromiseTargetExecutorTag) != 0;
+}
+
+/** Returns the queue or the executor a target points to. */
+static void *FSLPromiseTargetObject(void *target) {
+  return (void *)((uintptr_t)target & ~FSLPromiseTargetExecutorTag);
+}
+
+/** Returns the queue a target points to, or nil if it points to an executor. */
+static dispatch_queue_t __nullable FSLPromiseTargetQueue(void *target) {
+  return FSLPromiseTargetIsExecutor(target) ? nil : (__bridge dispatch_queue_t)target;
+}
+
+void *FSLPromiseTargetWithQueue(dispatch_queue_t queue) {
+  return (__bridge void *)queue;
+}
+
+void *FSLPromiseTargetWithExecutor(id<FSLPromiseExecutor> executor) {
+  // Target the queue directly if the executor merely dispatches on one.
+  if ([executor isMemberOfClass:[FSLPromiseDispatchQueueExecutor class]]) {
+    return FSLPromiseTargetWithQueue(((FSLPromiseDispatchQueueExecutor *)executor).queue);
+  }
+  return (void *)((uintptr_t)(__bridge void *)executor | FSLPromiseTargetExecutorTag);
+}
+
+/** Retains the queue or the executor a target points to, and returns the target. */
+static void *FSLPromiseTargetRetain(void *target) {
+  void *object = (__bridge_retained void *)(__bridge id)FSLPromiseTargetObject(target);
+  return (void *)((uintptr_t)object | ((uintptr_t)target & FSLPromiseTargetExecutorTag));
+}
+
+/**
+ Node of a lock-free singly linked list of observers, pending objects and cancellation handlers.
+ All pointers are retained by the node.
+ */
+typedef struct FSLPromiseNode {
+  struct FSLPromiseNode *next;
+  /**
+   Target to notify the observer on, or NULL if the node holds a pending object or a handler.
+   */
+  void *target;
+  /** Block to invoke on fulfillment, or an arbitrary object to keep while pending. */
+  void *onFulfill;
+  /** Block to invoke on rejection, or a block to invoke synchronously on cancellation. */
+  void *onReject;
+  /** Policy to invoke the observer blocks with. */
+  FSLPromiseExecutionPolicy policy;
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  /** Key to record the latencies of the observer under, or zero if they are not recorded. */
+  uint16_t latencyKey;
+#endif
+} FSLPromiseNode;
+
+/** Returns the key to record the latencies of an observer under, or zero if none. */
+static uint16_t FSLPromiseNodeLatencyKey(FSLPromiseNode const *__unused node) {
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  return node->latencyKey;
+#else
+  return 0;
+#endif
+}
+
+/** Marker of a list which doesn't accept new nodes anymore since the promise has been resolved. */
+static FSLPromiseNode *const FSLPromiseNodeListClosed = (FSLPromiseNode *)1;
+
+/**
+ Pushes a node onto the head of the list unless the list has been closed.
+
+ @return YES if the node has been added, NO if the list has been closed.
+ */
+static BOOL FSLPromiseNodeListPush(FSLPromiseNode *_Atomic *list, FSLPromiseNode *node) {
+  FSLPromiseNode *head = atomic_load_explicit(list, memory_order_acquire);
+  do {
+    if (head == FSLPromiseNodeListClosed) {
+      return NO;
+    }
+    node->next = head;
+  } while (!atomic_compare_exchange_weak_explicit(list, &head, node, memory_order_release,
+                                                  memory_order_acquire));
+  return YES;
+}
+
+/**
+ Reverses a detached list, so that the nodes are visited in the order they were pushed.
+ */
+static FSLPromiseNode *FSLPromiseNodeListReverse(FSLPromiseNode *node) {
+  FSLPromiseNode *reversed = NULL;
+  while (node) {
+    FSLPromiseNode *next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+  return reversed;
+}
+
+/**
+ Releases everything a node holds.
+ */
+static void FSLPromiseNodeClear(FSLPromiseNode *node) {
+  id __unused target = (__bridge_transfer id)FSLPromiseTargetObject(node->target);
+  id __unused onFulfill = (__bridge_transfer id)node->onFulfill;
+  id __unused onReject = (__bridge_transfer id)node->onReject;
+  node->target = node->onFulfill = node->onReject = NULL;
+}
+
+/** Maximum number of promise blocks invoked synchronously one from another. */
+static NSUInteger const FSLPromiseInlineExecutionMaxDepth = 32;
+
+/** Block deferred by the trampoline of the current thread. */
+typedef struct FSLPromiseTrampolineEntry {
+  struct FSLPromiseTrampolineEntry *next;
+  /** Retained block to invoke. */
+  void *block;
+} FSLPromiseTrampolineEntry;
+
+/** Per-thread state of the promise block running on the current thread, if any. */
+typedef struct FSLPromiseInlineContext {
+  /** Target the current block runs on, or NULL if none. */
+  void *target;
+  /** Number of blocks currently invoked synchronously one from another. */
+  NSUInteger depth;
+  /** Blocks deferred after reaching the maximum depth, in the order to invoke them. */
+  FSLPromiseTrampolineEntry *head;
+  FSLPromiseTrampolineEntry *tail;
+} FSLPromiseInlineContext;
+
+static _Thread_local FSLPromiseInlineContext gFSLPromiseInlineContext;
+
+/**
+ Returns YES if the current thread runs a promise block dispatched on `target` with the policy
+ `FSLPromiseExecutionPolicyInline`.
+ */
+static BOOL FSLPromiseIsRunningOnTarget(void *target) {
+  return gFSLPromiseInlineContext.target == target;
+}
+
+/**
+ Invokes a block dispatched on `target` with the policy `FSLPromiseExecutionPolicyInline`, letting
+ the blocks invoked from it run synchronously, and then runs the ones deferred by the trampoline.
+ */
+static void FSLPromiseRunOnTarget(void *target, dispatch_block_t block) {
+  FSLPromiseInlineContext *context = &gFSLPromiseInlineContext;
+  FSLPromiseInlineContext previousContext = *context;
+  *context = (FSLPromiseInlineContext){.target = target};
+  block();
+  while (context->head) {
+    FSLPromiseTrampolineEntry *entry = context->head;
+    context->head = entry->next;
+    if (!context->head) {
+      context->tail = NULL;
+    }
+    dispatch_block_t deferredBlock = (__bridge_transfer dispatch_block_t)entry->block;
+    free(entry);
+    deferredBlock();
+  }
+  *context = previousContext;
+}
+
+/**
+ Invokes a block synchronously if the current thread runs a promise block on `target`, or defers it
+ until that block returns if the maximum depth has been reached.
+
+ @return NO if the block has to be dispatched asynchronously instead.
+ */
+static BOOL FSLPromiseRunInline(void *target, dispatch_block_t block) {
+  FSLPromiseInlineContext *context = &gFSLPromiseInlineContext;
+  if (!FSLPromiseIsRunningOnTarget(target)) {
+    return NO;
+  }
+  if (context->depth < FSLPromiseInlineExecutionMaxDepth) {
+    ++context->depth;
+    block();
+    --context->depth;
+  } else {
+    FSLPromiseTrampolineEntry *entry = malloc(sizeof(FSLPromiseTrampolineEntry));
+    entry->next = NULL;
+    entry->block = (__bridge_retained void *)[block copy];
+    if (context->tail) {
+      context->tail->next = entry;
+    } else {
+      context->head = entry;
+    }
+    context->tail = entry;
+  }
+  return YES;
+}
+
+/** Observers of a promise to notify with a single block dispatched on their target. */
+typedef struct FSLPromiseBatch {
+  /** Target shared by the observers. */
+  void *target;
+  /** List of observers, in order of registration. */
+  FSLPromiseNode *head;
+  FSLPromiseNode *tail;
+  /** Whether any of the observers expects the inline policy. */
+  BOOL hasInlinePolicy;
+} FSLPromiseBatch;
+
+/** Number of batches to keep on stack while dispatching observers before allocating more. */
+static NSUInteger const FSLPromiseInlineBatchCount = 4;
+
+/**
+ Dispatches a block on `target` within `group`, unless the group is nil.
+ */
+static void FSLPromiseDispatchAsync(dispatch_group_t __nullable group, void *target,
+                                    dispatch_block_t block) {
+  FSL_PROMISES_INSTRUMENT_DISPATCH(FSLPromiseTargetQueue(target));
+  if (FSLPromiseTargetIsExecutor(target)) {
+    id<FSLPromiseExecutor> executor = (__bridge id)FSLPromiseTargetObject(target);
+    if (group) {
+      dispatch_group_enter(group);
+    }
+    [executor executeBlock:^{
+      block();
+      if (group) {
+        dispatch_group_leave(group);
+      }
+      // Blocks may use the target they run on, so keep the executor alive until they return, as
+      // dispatch queues do.
+      (void)executor;
+    }];
+  } else if (group) {
+    dispatch_group_async(group, (__bridge dispatch_queue_t)target, block);
+  } else {
+    dispatch_async((__bridge dispatch_queue_t)target, block);
+  }
+}
+
+/**
+ Dispatches either `onFulfill` or `onReject` of an observer of `promise` on `target` according to
+ `state` and `policy`.
+ */
+static void FSLPromiseDispatch(FSLPromise *__unused promise, dispatch_group_t __nullable group,
+                               void *target, FSLPromiseExecutionPolicy policy,
+                               uint16_t __unused latencyKey, FSLPromiseState state,
+                               id __nullable resolution, FSLPromiseOnFulfillBlock onFulfill,
+                               FSLPromiseOnRejectBlock onReject) {
+  uint64_t const __unused dispatchTime = latencyKey ? FSL_PROMISES_LATENCY_NOW() : 0;
+  dispatch_queue_t __unused queue = FSLPromiseTargetQueue(target);
+  dispatch_block_t block = nil;
+  switch (state) {
+    case FSLPromiseStatePending:
+    case FSLPromiseStateResolving:
+    case FSLPromiseStateForwarding:
+    case FSLPromiseStateForwarded:
+    case FSLPromiseStateForwardedDetached:
+      NSCAssert(NO, @"Cannot dispatch observers of a pending promise.");
+      return;
+    case FSLPromiseStateFulfilled:
+      block = ^{
+        FSL_PROMISES_INSTRUMENT_CONTINUATION(promise, queue);
+        FSL_PROMISES_MEASURE_CONTINUATION(latencyKey, dispatchTime);
+        onFulfill(resolution);
+      };
+      break;
+    case FSLPromiseStateRejected:
+      block = ^{
+        FSL_PROMISES_INSTRUMENT_CONTINUATION(promise, queue);
+        FSL_PROMISES_MEASURE_CONTINUATION(latencyKey, dispatchTime);
+        onReject(resolution);
+      };
+      break;
+  }
+  switch (policy) {
+    case FSLPromiseExecutionPolicyAsync:
+      FSLPromiseDispatchAsync(group, target, block);
+      break;
+    case FSLPromiseExecutionPolicyInline:
+      if (!FSLPromiseRunInline(target, block)) {
+        FSLPromiseDispatchAsync(group, target, ^{
+          FSLPromiseRunOnTarget(target, block);
+        });
+      }
+      break;
+  }
+}
+
+static NSTimeInterval const FSLPromiseDefaultTimerTickInterval = 0.01;
 
 static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
+static FSLPromiseTimerWheel *gFSLPromiseTimerWheel;
+
+/**
+ Promises being cancelled on the current thread, if any. Cancellation handlers cancel upstream
+ promises in turn, so those are appended here instead of recursing, to avoid overflowing the stack
+ when cancelling long chains.
+ */
+static _Thread_local void *gFSLPromiseCancelledPromises;
+
+/**
+ Weak reference to a promise forwarding to the promise keeping it, to have it forward to the one
+ the latter forwards to in turn, if any.
+ */
+@interface FSLPromiseForwarder : NSObject
+
+@property(nonatomic, weak, readonly, nullable) FSLPromise *promise;
+
+- (instancetype)initWithPromise:(FSLPromise *)promise NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+@implementation FSLPromiseForwarder
+
+- (instancetype)initWithPromise:(FSLPromise *)promise {
+  self = [super init];
+  if (self) {
+    _promise = promise;
+  }
+  return self;
+}
 
+@end
+
+/**
+ Instance variables are laid out to keep a pending promise with a single observer within a single
+ 80-byte allocation: the value and the error share one slot keyed by the state, and the first
+ observer or pending object is stored inline, so that only the subsequent ones are spilled into
+ separately allocated nodes.
+ */
 @implementation FSLPromise {
   /** Current state of the promise. */
-  FSLPromiseState _state;
-  /**
-   Set of arbitrary objects to keep strongly while the promise is pending.
-   Becomes nil after the promise has been resolved.
-   */
-  NSMutableSet *__nullable _pendingObjects;
+  _Atomic(FSLPromiseState) _state;
+  /** Whether `_inlineNode` has been taken by an observer or a pending object. */
+  atomic_flag _inlineNodeClaimed;
+  /** Policy to invoke the observers with, stored as `FSLPromiseExecutionPolicy`. */
+  uint8_t _executionPolicy;
+  /** Whether the pending promise has been registered with the leak detector. */
+  BOOL _leakDetectorTracked;
+  /** Number of observers registered so far, minus the ones that have lost interest. */
+  _Atomic(uint32_t) _observersCount;
   /**
-   Value to fulfill the promise with.
-   Can be nil if the promise is still pending, was resolved with nil or after it has been rejected.
+   Value to fulfill the promise with, or error to reject it with, or promise to forward to,
+   depending on the state. Can be nil if the promise is still pending or was fulfilled with nil.
+   Written once by the resolver before the state is published.
    */
-  id __nullable _value;
+  id __nullable _resolution;
   /**
-   Error to reject the promise with.
-   Can be nil if the promise is still pending or after it has been fulfilled.
+   List of observers to notify and arbitrary objects to keep strongly while the promise is pending,
+   in reverse order of registration. Gets closed after the promise has been resolved.
    */
-  NSError *__nullable _error;
-  /** List of observers to notify when the promise gets resolved. */
-  NSMutableArray<FSLPromiseObserver> *_observers;
+  FSLPromiseNode *_Atomic _observers;
+  /** Storage for the first node of the `_observers` list, to avoid a heap allocation. */
+  FSLPromiseNode _inlineNode;
+#ifndef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+  /** Dispatch group the promise has entered while pending, if any. */
+  dispatch_group_t __nullable _dispatchGroup;
+#endif
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  /** Time the pending promise was recorded to be created at, or zero if it wasn't. */
+  uint64_t _creationTime;
+  /** Key to record the pending latency under, or zero if it isn't recorded. */
+  uint16_t _latencyKey;
+  /** Time to measure the pending latency from. */
+  uint64_t _latencyCreationTime;
+#endif
 }
 
 + (void)initialize {
   if (self == [FSLPromise class]) {
     gFSLPromiseDefaultDispatchQueue = dispatch_get_main_queue();
+    gFSLPromiseTimerWheel =
+        [[FSLPromiseTimerWheel alloc] initWithTickInterval:FSLPromiseDefaultTimerTickInterval];
   }
 }
 
@@ -69,6 +466,28 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
   }
 }
 
++ (NSTimeInterval)timerTickInterval {
+  return [self timerWheel].tickInterval;
+}
+
++ (void)setTimerTickInterval:(NSTimeInterval)interval {
+  NSParameterAssert(interval > 0);
+
+  // The timers scheduled on the previous wheel keep it alive until they fire or get cancelled.
+  FSLPromiseTimerWheel *timerWheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:interval];
+  @synchronized(self) {
+    gFSLPromiseTimerWheel = timerWheel;
+  }
+}
+
+- (FSLPromiseExecutionPolicy)executionPolicy {
+  return (FSLPromiseExecutionPolicy)_executionPolicy;
+}
+
+- (void)setExecutionPolicy:(FSLPromiseExecutionPolicy)executionPolicy {
+  _executionPolicy = (uint8_t)executionPolicy;
+}
+
 + (instancetype)pendingPromise {
   return [[self alloc] initPending];
 }
@@ -81,18 +500,7 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
   if ([value isKindOfClass:[NSError class]]) {
     [self reject:(NSError *)value];
   } else {
-    @synchronized(self) {
-      if (_state == FSLPromiseStatePending) {
-        _state = FSLPromiseStateFulfilled;
-        _value = value;
-        _pendingObjects = nil;
-        for (FSLPromiseObserver observer in _observers) {
-          observer(_state, _value);
-        }
-        _observers = nil;
-        dispatch_group_leave(FSLPromise.dispatchGroup);
-      }
-    }
+    [self resolveWithState:FSLPromiseStateFulfilled resolution:value];
   }
 }
 
@@ -103,18 +511,23 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
     // Give up on invalid error type in Release mode.
     @throw error;  // NOLINT
   }
-  @synchronized(self) {
-    if (_state == FSLPromiseStatePending) {
-      _state = FSLPromiseStateRejected;
-      _error = error;
-      _pendingObjects = nil;
-      for (FSLPromiseObserver observer in _observers) {
-        observer(_state, _error);
-      }
-      _observers = nil;
-      dispatch_group_leave(FSLPromise.dispatchGroup);
-    }
+  [self resolveWithState:FSLPromiseStateRejected resolution:error];
+}
+
+- (void)cancel {
+  if (gFSLPromiseCancelledPromises) {
+    [(__bridge NSMutableArray *)gFSLPromiseCancelledPromises addObject:self];
+    return;
   }
+  NSMutableArray<FSLPromise *> *promises = [[NSMutableArray alloc] initWithObjects:self, nil];
+  gFSLPromiseCancelledPromises = (__bridge void *)promises;
+  NSError *error = [[NSError alloc] initWithDomain:FSLPromiseErrorDomain
+                                              code:FSLPromiseErrorCodeCancelled
+                                          userInfo:nil];
+  for (NSUInteger i = 0; i < promises.count; ++i) {
+    [promises[i] resolveWithState:FSLPromiseStateRejected resolution:error];
+  }
+  gFSLPromiseCancelledPromises = NULL;
 }
 
 #pragma mark - NSObject
@@ -136,7 +549,22 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
 - (instancetype)initPending {
   self = [super init];
   if (self) {
-    dispatch_group_enter(FSLPromise.dispatchGroup);
+    atomic_init(&_state, FSLPromiseStatePending);
+    atomic_init(&_observersCount, 0);
+    atomic_init(&_observers, NULL);
+#ifndef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+    _dispatchGroup = FSLPromise.dispatchGroup;
+    if (_dispatchGroup) {
+      dispatch_group_enter(_dispatchGroup);
+    }
+#endif
+    _leakDetectorTracked = FSLPromiseLeakDetectorTrack((__bridge void const *)self);
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+    _creationTime = FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKindCreated,
+                                                    (__bridge void const *)self, NULL, 0, NULL);
+    _latencyKey = FSLPromiseLatencyCurrentKey();
+    _latencyCreationTime = FSLPromiseLatencyNow();
+#endif
   }
   return self;
 }
@@ -144,131 +572,343 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
 - (instancetype)initWithResolution:(nullable id)resolution {
   self = [super init];
   if (self) {
-    if ([resolution isKindOfClass:[NSError class]]) {
-      _state = FSLPromiseStateRejected;
-      _error = (NSError *)resolution;
-    } else {
-      _state = FSLPromiseStateFulfilled;
-      _value = resolution;
-    }
+    _resolution = resolution;
+    atomic_init(&_state, [resolution isKindOfClass:[NSError class]] ? FSLPromiseStateRejected
+                                                                     : FSLPromiseStateFulfilled);
+    atomic_init(&_observers, FSLPromiseNodeListClosed);
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+    // Close the span right away, as nothing else would.
+    uint64_t const creationTime = FSLPromiseInstrumentationRecord(
+        FSLPromiseInstrumentationEventKindCreated, (__bridge void const *)self, NULL, 0, NULL);
+    FSLPromiseInstrumentationRecord(
+        atomic_load_explicit(&_state, memory_order_relaxed) == FSLPromiseStateFulfilled
+            ? FSLPromiseInstrumentationEventKindFulfilled
+            : FSLPromiseInstrumentationEventKindRejected,
+        (__bridge void const *)self, NULL, creationTime, NULL);
+#endif
   }
   return self;
 }
 
 - (void)dealloc {
-  if (_state == FSLPromiseStatePending) {
-    dispatch_group_leave(FSLPromise.dispatchGroup);
+  if (atomic_load_explicit(&_state, memory_order_relaxed) == FSLPromiseStatePending) {
+    FSLPromiseNode *node = atomic_load_explicit(&_observers, memory_order_relaxed);
+    while (node) {
+      FSLPromiseNode *next = node->next;
+      [self freeNode:node];
+      node = next;
+    }
+    [self leaveDispatchGroup];
+    [self untrackLeakDeallocated:YES];
   }
 }
 
 - (BOOL)isPending {
-  @synchronized(self) {
-    return _state == FSLPromiseStatePending;
+  switch (atomic_load_explicit(&_state, memory_order_acquire)) {
+    case FSLPromiseStatePending:
+    case FSLPromiseStateResolving:
+    case FSLPromiseStateForwarding:
+      return YES;
+    case FSLPromiseStateFulfilled:
+    case FSLPromiseStateRejected:
+      return NO;
+    case FSLPromiseStateForwarded:
+    case FSLPromiseStateForwardedDetached:
+      return [self forwardedPromise].isPending;
   }
 }
 
 - (BOOL)isFulfilled {
-  @synchronized(self) {
-    return _state == FSLPromiseStateFulfilled;
+  FSLPromiseState state = atomic_load_explicit(&_state, memory_order_acquire);
+  if (FSLPromiseStateIsForwarded(state)) {
+    return [self forwardedPromise].isFulfilled;
   }
+  return state == FSLPromiseStateFulfilled;
 }
 
 - (BOOL)isRejected {
-  @synchronized(self) {
-    return _state == FSLPromiseStateRejected;
+  FSLPromiseState state = atomic_load_explicit(&_state, memory_order_acquire);
+  if (FSLPromiseStateIsForwarded(state)) {
+    return [self forwardedPromise].isRejected;
   }
+  return state == FSLPromiseStateRejected;
 }
 
 - (nullable id)value {
-  @synchronized(self) {
-    return _value;
+  FSLPromiseState state = atomic_load_explicit(&_state, memory_order_acquire);
+  if (FSLPromiseStateIsForwarded(state)) {
+    return [self forwardedPromise].value;
   }
+  return state == FSLPromiseStateFulfilled ? _resolution : nil;
 }
 
 - (NSError *__nullable)error {
-  @synchronized(self) {
-    return _error;
+  FSLPromiseState state = atomic_load_explicit(&_state, memory_order_acquire);
+  if (FSLPromiseStateIsForwarded(state)) {
+    return [self forwardedPromise].error;
   }
+  return state == FSLPromiseStateRejected ? _resolution : nil;
 }
 
 - (void)addPendingObject:(id)object {
   NSParameterAssert(object);
 
-  @synchronized(self) {
-    if (_state == FSLPromiseStatePending) {
-      if (!_pendingObjects) {
-        _pendingObjects = [[NSMutableSet alloc] init];
-      }
-      [_pendingObjects addObject:object];
+  if (atomic_load_explicit(&_observers, memory_order_acquire) != FSLPromiseNodeListClosed) {
+    FSLPromiseNode *node = [self newNode];
+    node->onFulfill = (__bridge_retained void *)object;
+    if (FSLPromiseNodeListPush(&_observers, node)) {
+      return;
     }
+    [self freeNode:node];
   }
+  [[self forwardedPromise] addPendingObject:object];
+}
+
+- (void)addCancellationHandler:(dispatch_block_t)handler {
+  NSParameterAssert(handler);
+
+  if (atomic_load_explicit(&_observers, memory_order_acquire) != FSLPromiseNodeListClosed) {
+    FSLPromiseNode *node = [self newNode];
+    node->onReject = (__bridge_retained void *)[handler copy];
+    if (FSLPromiseNodeListPush(&_observers, node)) {
+      return;
+    }
+    [self freeNode:node];
+  }
+  FSLPromise *forwardedPromise = [self forwardedPromise];
+  if (forwardedPromise) {
+    [forwardedPromise addCancellationHandler:handler];
+  } else if (FSLPromiseErrorIsCancelled(self.error)) {
+    handler();
+  }
+}
+
+- (void)propagateCancellationToPromise:(FSLPromise *)promise {
+  NSParameterAssert(promise);
+
+  // Don't let the receiver keep the upstream promise alive.
+  FSLPromise __weak *weakPromise = promise;
+  [self addCancellationHandler:^{
+    [weakPromise detachObserver];
+  }];
+}
+
+- (void)detachObserver {
+  if (atomic_fetch_sub_explicit(&_observersCount, 1, memory_order_acq_rel) == 1) {
+    // Only detaches from the promise forwarded to, if any.
+    [self cancel];
+  }
+}
+
+- (void)cancelUnlessObserved {
+  atomic_fetch_add_explicit(&_observersCount, 1, memory_order_relaxed);
+  [self detachObserver];
+}
+
+- (void)observeOnQueue:(dispatch_queue_t)queue
+               fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                reject:(FSLPromiseOnRejectBlock)onReject {
+  [self observeOnQueue:queue policy:self.executionPolicy fulfill:onFulfill reject:onReject];
 }
 
 - (void)observeOnQueue:(dispatch_queue_t)queue
+                policy:(FSLPromiseExecutionPolicy)policy
                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
                 reject:(FSLPromiseOnRejectBlock)onReject {
   NSParameterAssert(queue);
+
+  [self observeOnTarget:FSLPromiseTargetWithQueue(queue)
+                 policy:policy
+                fulfill:onFulfill
+                 reject:onReject];
+}
+
+- (void)observeOnTarget:(void *)target
+                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                 reject:(FSLPromiseOnRejectBlock)onReject {
+  [self observeOnTarget:target policy:self.executionPolicy fulfill:onFulfill reject:onReject];
+}
+
+- (void)observeOnTarget:(void *)target
+                 policy:(FSLPromiseExecutionPolicy)policy
+                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                 reject:(FSLPromiseOnRejectBlock)onReject {
+  NSParameterAssert(target);
   NSParameterAssert(onFulfill);
   NSParameterAssert(onReject);
 
-  @synchronized(self) {
-    switch (_state) {
-      case FSLPromiseStatePending: {
-        if (!_observers) {
-          _observers = [[NSMutableArray alloc] init];
-        }
-        [_observers addObject:^(FSLPromiseState state, id __nullable resolution) {
-          dispatch_group_async(FSLPromise.dispatchGroup, queue, ^{
-            switch (state) {
-              case FSLPromiseStatePending:
-                break;
-              case FSLPromiseStateFulfilled:
-                onFulfill(resolution);
-                break;
-              case FSLPromiseStateRejected:
-                onReject(resolution);
-                break;
-            }
-          });
-        }];
-        break;
-      }
-      case FSLPromiseStateFulfilled: {
-        dispatch_group_async(FSLPromise.dispatchGroup, queue, ^{
-          onFulfill(self->_value);
-        });
-        break;
-      }
-      case FSLPromiseStateRejected: {
-        dispatch_group_async(FSLPromise.dispatchGroup, queue, ^{
-          onReject(self->_error);
-        });
-        break;
-      }
+  FSL_PROMISES_INSTRUMENT(Observed, self);
+  atomic_fetch_add_explicit(&_observersCount, 1, memory_order_relaxed);
+  [self addObserverOnTarget:target policy:policy fulfill:onFulfill reject:onReject];
+}
+
+/**
+ Same as `observeOnTarget:policy:fulfill:reject:`, but without counting the observer, which is
+ counted by the promise forwarding to the receiver it was registered on instead.
+ */
+- (void)addObserverOnTarget:(void *)target
+                     policy:(FSLPromiseExecutionPolicy)policy
+                    fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                     reject:(FSLPromiseOnRejectBlock)onReject {
+  if (atomic_load_explicit(&_observers, memory_order_acquire) != FSLPromiseNodeListClosed) {
+    FSLPromiseNode *node = [self newNode];
+    node->target = FSLPromiseTargetRetain(target);
+    node->onFulfill = (__bridge_retained void *)[onFulfill copy];
+    node->onReject = (__bridge_retained void *)[onReject copy];
+    node->policy = policy;
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+    node->latencyKey = FSL_PROMISES_LATENCY_KEY();
+#endif
+    if (FSLPromiseNodeListPush(&_observers, node)) {
+      return;
     }
+    // Lost the race against the resolution, which is guaranteed to be published by now.
+    [self freeNode:node];
+  }
+  FSLPromise *forwardedPromise = [self forwardedPromise];
+  if (forwardedPromise) {
+    [forwardedPromise addObserverOnTarget:target policy:policy fulfill:onFulfill reject:onReject];
+    return;
+  }
+  FSLPromiseState state = atomic_load_explicit(&_state, memory_order_acquire);
+  FSLPromiseDispatch(self, [self enteredDispatchGroup], target, policy,
+                     FSL_PROMISES_LATENCY_KEY(), state, _resolution, onFulfill, onReject);
+}
+
+- (void)adoptPromise:(FSLPromise *)promise {
+  NSParameterAssert(promise);
+
+  // Never the other way around, since `promise` may be shared with other observers, which must not
+  // get the resolution of the receiver, e.g. its cancellation.
+  [self forwardToPromise:promise];
+}
+
+- (void)dispatchOnQueue:(dispatch_queue_t)queue block:(dispatch_block_t)block {
+  NSParameterAssert(queue);
+  NSParameterAssert(block);
+
+  FSLPromiseDispatchAsync([self enteredDispatchGroup], FSLPromiseTargetWithQueue(queue), block);
+}
+
+- (void)dispatchOnTarget:(void *)target block:(dispatch_block_t)block {
+  NSParameterAssert(target);
+  NSParameterAssert(block);
+
+  FSLPromiseDispatchAsync([self enteredDispatchGroup], target, block);
+}
+
+- (dispatch_block_t)dispatchAfterInterval:(NSTimeInterval)interval
+                                  onQueue:(dispatch_queue_t)queue
+                                    block:(dispatch_block_t)block {
+  NSParameterAssert(queue);
+  NSParameterAssert(block);
+
+  if (interval <= 0) {
+    // Nothing to wait for, so don't delay the block until the next tick of the wheel.
+    FSLPromiseDispatchAsync([self enteredDispatchGroup], FSLPromiseTargetWithQueue(queue), block);
+    return ^{
+    };
+  }
+  FSLPromiseTimerWheel *timerWheel = [FSLPromise timerWheel];
+  dispatch_block_t cancel;
+  if (interval < timerWheel.tickInterval) {
+    // The wheel would round the interval up to a whole tick, so use a timer of its own instead.
+    // Unlike dispatch_after, a timer source releases the block as soon as it gets cancelled.
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    dispatch_source_set_timer(timer, dispatch_time(0, (int64_t)(interval * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER, 0);
+    // The handler retains the timer until it gets cancelled, which releases the handler.
+    dispatch_source_set_event_handler(timer, ^{
+      dispatch_source_cancel(timer);
+      block();
+    });
+    dispatch_resume(timer);
+    cancel = ^{
+      dispatch_source_cancel(timer);
+    };
+  } else {
+    // Unlike dispatch_after, the wheel releases the block as soon as the timer gets cancelled.
+    FSLPromiseTimer *timer = [timerWheel scheduleAfterInterval:interval onQueue:queue block:block];
+    cancel = ^{
+      [timer cancel];
+    };
   }
+  [self addCancellationHandler:cancel];
+  return cancel;
+}
+
+- (dispatch_block_t)dispatchAfterInterval:(NSTimeInterval)interval
+                                 onTarget:(void *)target
+                                    block:(dispatch_block_t)block {
+  NSParameterAssert(target);
+  NSParameterAssert(block);
+
+  if (!FSLPromiseTargetIsExecutor(target)) {
+    return [self dispatchAfterInterval:interval
+                               onQueue:(__bridge dispatch_queue_t)target
+                                 block:block];
+  }
+  if (interval <= 0) {
+    FSLPromiseDispatchAsync([self enteredDispatchGroup], target, block);
+    return ^{
+    };
+  }
+  // Timers only fire on queues, so hop from one over to the executor, keeping it alive meanwhile.
+  id<FSLPromiseExecutor> executor = (__bridge id)FSLPromiseTargetObject(target);
+  return [self dispatchAfterInterval:interval
+                             onQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+                               block:^{
+                                 FSLPromiseDispatchAsync(nil, target, block);
+                                 (void)executor;
+                               }];
+}
+
+- (FSLPromise *)chainOnQueue:(dispatch_queue_t)queue
+              chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+               chainedReject:(FSLPromiseChainedRejectBlock)chainedReject {
+  return [self chainOnQueue:queue
+                     policy:self.executionPolicy
+             chainedFulfill:chainedFulfill
+              chainedReject:chainedReject];
 }
 
 - (FSLPromise *)chainOnQueue:(dispatch_queue_t)queue
+                      policy:(FSLPromiseExecutionPolicy)policy
               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject {
   NSParameterAssert(queue);
 
+  return [self chainOnTarget:FSLPromiseTargetWithQueue(queue)
+                      policy:policy
+              chainedFulfill:chainedFulfill
+               chainedReject:chainedReject];
+}
+
+- (FSLPromise *)chainOnTarget:(void *)target
+               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject {
+  return [self chainOnTarget:target
+                      policy:self.executionPolicy
+              chainedFulfill:chainedFulfill
+               chainedReject:chainedReject];
+}
+
+- (FSLPromise *)chainOnTarget:(void *)target
+                       policy:(FSLPromiseExecutionPolicy)policy
+               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject {
   FSLPromise *promise = [[[self class] alloc] initPending];
+  promise->_executionPolicy = _executionPolicy;
+  FSL_PROMISES_INSTRUMENT_CHAIN(promise, self);
   __auto_type resolver = ^(id __nullable value) {
     if ([value isKindOfClass:[FSLPromise class]]) {
-      [(FSLPromise *)value observeOnQueue:queue
-          fulfill:^(id __nullable value) {
-            [promise fulfill:value];
-          }
-          reject:^(NSError *error) {
-            [promise reject:error];
-          }];
+      [promise adoptPromise:(FSLPromise *)value];
     } else {
       [promise fulfill:value];
     }
   };
-  [self observeOnQueue:queue
+  [self observeOnTarget:target
+      policy:policy
       fulfill:^(id __nullable value) {
         value = chainedFulfill ? chainedFulfill(value) : value;
         resolver(value);
@@ -277,9 +917,339 @@ static dispatch_queue_t gFSLPromiseDefaultDispatchQueue;
         id value = chainedReject ? chainedReject(error) : error;
         resolver(value);
       }];
+  [promise propagateCancellationToPromise:self];
   return promise;
 }
 
+/**
+ Returns the inline node if it hasn't been taken yet, or a newly allocated one otherwise.
+ */
+- (FSLPromiseNode *)newNode {
+  FSLPromiseNode *node = &_inlineNode;
+  if (atomic_flag_test_and_set_explicit(&_inlineNodeClaimed, memory_order_relaxed)) {
+    node = malloc(sizeof(FSLPromiseNode));
+  }
+  *node = (FSLPromiseNode){0};
+  return node;
+}
+
+/**
+ Releases everything a node holds and frees it unless it is the inline node.
+ */
+- (void)freeNode:(FSLPromiseNode *)node {
+  FSLPromiseNodeClear(node);
+  if (node != &_inlineNode) {
+    free(node);
+  }
+}
+
+/**
+ Claims the resolution with a single CAS, publishes it and then notifies the observers detached
+ from the list, outside of any critical section.
+ */
+- (void)resolveWithState:(FSLPromiseState)state resolution:(nullable id)resolution {
+  FSLPromiseState expected = FSLPromiseStatePending;
+  if (!atomic_compare_exchange_strong_explicit(&_state, &expected, FSLPromiseStateResolving,
+                                               memory_order_acquire, memory_order_relaxed)) {
+    // A promise forwarding to another one only stops observing that one when cancelled.
+    if (state == FSLPromiseStateRejected && FSLPromiseErrorIsCancelled(resolution) &&
+        [self forwardedPromise]) {
+      [self detachFromForwardedPromise];
+    }
+    return;
+  }
+  _resolution = resolution;
+  atomic_store_explicit(&_state, state, memory_order_release);
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  FSLPromiseInstrumentationRecord(state == FSLPromiseStateFulfilled
+                                      ? FSLPromiseInstrumentationEventKindFulfilled
+                                      : FSLPromiseInstrumentationEventKindRejected,
+                                  (__bridge void const *)self, NULL, _creationTime, NULL);
+  FSLPromiseLatencyRecord(FSLPromiseLatencyMetricPending, _latencyKey, _latencyCreationTime);
+#endif
+  FSLPromiseNode *node = FSLPromiseNodeListReverse(
+      atomic_exchange_explicit(&_observers, FSLPromiseNodeListClosed, memory_order_acq_rel));
+  [self dispatchObservers:node state:state resolution:resolution];
+  [self leaveDispatchGroup];
+  [self untrackLeakDeallocated:NO];
+}
+
+/**
+ Splits the list of observers into batches by target, preserving their order, and dispatches a
+ single block per target to notify all observers of a batch, instead of one block per observer.
+ Observers with the inline policy are notified right away if the current thread runs on their
+ target.
+ */
+- (void)dispatchObservers:(FSLPromiseNode *)node
+                    state:(FSLPromiseState)state
+               resolution:(nullable id)resolution {
+  FSLPromiseBatch inlineBatches[FSLPromiseInlineBatchCount];
+  FSLPromiseBatch *batches = inlineBatches;
+  NSUInteger batchesCount = 0;
+  NSUInteger batchesCapacity = FSLPromiseInlineBatchCount;
+  BOOL isCancelled = state == FSLPromiseStateRejected && FSLPromiseErrorIsCancelled(resolution);
+  while (node) {
+    FSLPromiseNode *next = node->next;
+    node->next = NULL;
+    if (!node->target) {
+      // Pending objects are simply released, and so are cancellation handlers unless cancelled.
+      if (node->onReject && isCancelled) {
+        ((__bridge dispatch_block_t)node->onReject)();
+      }
+      [self freeNode:node];
+    } else if (node->policy == FSLPromiseExecutionPolicyInline &&
+               FSLPromiseIsRunningOnTarget(node->target)) {
+      FSLPromiseDispatch(self, nil, node->target, node->policy,
+                         FSLPromiseNodeLatencyKey(node), state, resolution,
+                         (__bridge FSLPromiseOnFulfillBlock)node->onFulfill,
+                         (__bridge FSLPromiseOnRejectBlock)node->onReject);
+      [self freeNode:node];
+    } else {
+      // Most observers share the target of the previous one, so start looking from the end.
+      FSLPromiseBatch *batch = NULL;
+      for (NSUInteger i = batchesCount; i > 0; --i) {
+        if (batches[i - 1].target == node->target) {
+          batch = &batches[i - 1];
+          break;
+        }
+      }
+      if (!batch) {
+        if (batchesCount == batchesCapacity) {
+          batchesCapacity *= 2;
+          if (batches == inlineBatches) {
+            batches = malloc(batchesCapacity * sizeof(FSLPromiseBatch));
+            memcpy(batches, inlineBatches, sizeof(inlineBatches));
+          } else {
+            batches = realloc(batches, batchesCapacity * sizeof(FSLPromiseBatch));
+          }
+        }
+        batch = &batches[batchesCount++];
+        *batch = (FSLPromiseBatch){.target = node->target, .head = node};
+      } else {
+        batch->tail->next = node;
+      }
+      batch->tail = node;
+      batch->hasInlinePolicy |= node->policy == FSLPromiseExecutionPolicyInline;
+    }
+    node = next;
+  }
+  dispatch_group_t dispatchGroup = [self enteredDispatchGroup];
+  for (NSUInteger i = 0; i < batchesCount; ++i) {
+    void *target = batches[i].target;
+    dispatch_queue_t __unused queue = FSLPromiseTargetQueue(target);
+    FSLPromiseNode *head = batches[i].head;
+    uint64_t const dispatchTime = FSL_PROMISES_LATENCY_NOW();
+    // The block retains the receiver, which owns the inline node.
+    dispatch_block_t block = ^{
+      FSL_PROMISES_INSTRUMENT_CONTINUATION(self, queue);
+      [self notifyObservers:head state:state resolution:resolution dispatchTime:dispatchTime];
+    };
+    if (batches[i].hasInlinePolicy) {
+      FSLPromiseDispatchAsync(dispatchGroup, target, ^{
+        FSLPromiseRunOnTarget(target, block);
+      });
+    } else {
+      FSLPromiseDispatchAsync(dispatchGroup, target, block);
+    }
+  }
+  if (batches != inlineBatches) {
+    free(batches);
+  }
+}
+
+/**
+ Synchronously notifies a batch of observers dispatched at `dispatchTime` in order and frees their
+ nodes.
+ */
+- (void)notifyObservers:(FSLPromiseNode *)node
+                  state:(FSLPromiseState)state
+             resolution:(nullable id)resolution
+           dispatchTime:(uint64_t)dispatchTime {
+  while (node) {
+    FSLPromiseNode *next = node->next;
+    FSL_PROMISES_MEASURE_CONTINUATION(FSLPromiseNodeLatencyKey(node), dispatchTime);
+    if (state == FSLPromiseStateFulfilled) {
+      ((__bridge FSLPromiseOnFulfillBlock)node->onFulfill)(resolution);
+    } else {
+      ((__bridge FSLPromiseOnRejectBlock)node->onReject)(resolution);
+    }
+    [self freeNode:node];
+    node = next;
+  }
+}
+
+/**
+ Returns the wheel to schedule new timers on.
+ */
++ (FSLPromiseTimerWheel *)timerWheel {
+  @synchronized(self) {
+    return gFSLPromiseTimerWheel;
+  }
+}
+
+/**
+ Returns the promise the receiver forwards to, waiting for the forwarding to be published if it's
+ in progress, or nil if the receiver doesn't forward.
+ */
+- (nullable FSLPromise *)forwardedPromise {
+  FSLPromiseState state;
+  while ((state = atomic_load_explicit(&_state, memory_order_acquire)) ==
+         FSLPromiseStateForwarding) {
+    // The forwarding thread is a couple of instructions away from publishing the target.
+    sched_yield();
+  }
+  if (!FSLPromiseStateIsForwarded(state)) {
+    return nil;
+  }
+  FSLPromiseForwardingLock((__bridge void const *)self);
+  FSLPromise *forwardedPromise = _resolution;
+  FSLPromiseForwardingUnlock((__bridge void const *)self);
+  return forwardedPromise;
+}
+
+/**
+ Makes the pending receiver forward to the root of `promise`, i.e. the last promise in the chain
+ of forwarded ones: moves its observers and pending objects over there and redirects any further
+ ones, as well as state reads. The receiver counts as one observer of the root, and keeps track of
+ the promises forwarding to it, which get to forward to the root directly. That keeps recursive
+ chains of adopted promises flat, so that the intermediate ones can be released as soon as they are
+ not referenced anymore.
+
+ @return NO if the receiver isn't pending anymore or is the root of `promise` itself.
+ */
+- (BOOL)forwardToPromise:(FSLPromise *)promise {
+  FSLPromise *root = promise;
+  for (FSLPromise *next = [root forwardedPromise]; next; next = [root forwardedPromise]) {
+    root = next;
+  }
+  FSLPromiseState expected = FSLPromiseStatePending;
+  if (root == self ||
+      !atomic_compare_exchange_strong_explicit(&_state, &expected, FSLPromiseStateForwarding,
+                                               memory_order_acquire, memory_order_relaxed)) {
+    return NO;
+  }
+  // Count as an observer before anything can detach the receiver from the root.
+  atomic_fetch_add_explicit(&root->_observersCount, 1, memory_order_relaxed);
+  _resolution = root;
+  atomic_store_explicit(&_state, FSLPromiseStateForwarded, memory_order_release);
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKindForwarded,
+                                  (__bridge void const *)self, (__bridge void const *)root,
+                                  _creationTime, NULL);
+#endif
+  [root addForwarder:[[FSLPromiseForwarder alloc] initWithPromise:self]];
+  FSLPromiseNode *node = FSLPromiseNodeListReverse(
+      atomic_exchange_explicit(&_observers, FSLPromiseNodeListClosed, memory_order_acq_rel));
+  while (node) {
+    FSLPromiseNode *next = node->next;
+    id object = (__bridge id)node->onFulfill;
+    if (node->target) {
+      [root addObserverOnTarget:node->target
+                         policy:node->policy
+                        fulfill:(__bridge FSLPromiseOnFulfillBlock)node->onFulfill
+                         reject:(__bridge FSLPromiseOnRejectBlock)node->onReject];
+    } else if ([object isKindOfClass:[FSLPromiseForwarder class]]) {
+      [((FSLPromiseForwarder *)object).promise reforwardToPromise:root forwarder:object];
+    } else if (object) {
+      [root addPendingObject:object];
+    } else {
+      [root addCancellationHandler:(__bridge dispatch_block_t)node->onReject];
+    }
+    [self freeNode:node];
+    node = next;
+  }
+  [self leaveDispatchGroup];
+  // The promise forwarded to is the one to keep track of from now on.
+  [self untrackLeakDeallocated:NO];
+  return YES;
+}
+
+/**
+ Keeps track of a promise forwarding to the receiver, to have it forward to the promise the
+ receiver forwards to instead, if the receiver ever does.
+ */
+- (void)addForwarder:(FSLPromiseForwarder *)forwarder {
+  if (atomic_load_explicit(&_observers, memory_order_acquire) != FSLPromiseNodeListClosed) {
+    FSLPromiseNode *node = [self newNode];
+    node->onFulfill = (__bridge_retained void *)forwarder;
+    if (FSLPromiseNodeListPush(&_observers, node)) {
+      return;
+    }
+    [self freeNode:node];
+  }
+  FSLPromise *forwardedPromise = [self forwardedPromise];
+  if (forwardedPromise) {
+    [forwarder.promise reforwardToPromise:forwardedPromise forwarder:forwarder];
+  }
+}
+
+/**
+ Makes the receiver forward to `promise`, which the promise the receiver forwards to has started
+ forwarding to, so that the latter can be released. Moves the count of the receiver as an observer
+ over to `promise`, unless the receiver has detached already.
+ */
+- (void)reforwardToPromise:(FSLPromise *)promise forwarder:(FSLPromiseForwarder *)forwarder {
+  FSLPromiseForwardingLock((__bridge void const *)self);
+  BOOL const isAttached =
+      atomic_load_explicit(&_state, memory_order_relaxed) == FSLPromiseStateForwarded;
+  if (isAttached) {
+    atomic_fetch_add_explicit(&promise->_observersCount, 1, memory_order_relaxed);
+  }
+  FSLPromise *previousPromise = _resolution;
+  _resolution = promise;
+  FSLPromiseForwardingUnlock((__bridge void const *)self);
+  [promise addForwarder:forwarder];
+  if (isAttached) {
+    [previousPromise detachObserver];
+  }
+}
+
+/**
+ Stops counting as an observer of the promise the receiver forwards to, which gets cancelled if
+ nothing else observes it anymore.
+ */
+- (void)detachFromForwardedPromise {
+  FSLPromise *forwardedPromise;
+  FSLPromiseForwardingLock((__bridge void const *)self);
+  if (atomic_load_explicit(&_state, memory_order_relaxed) == FSLPromiseStateForwarded) {
+    atomic_store_explicit(&_state, FSLPromiseStateForwardedDetached, memory_order_relaxed);
+    forwardedPromise = _resolution;
+  }
+  FSLPromiseForwardingUnlock((__bridge void const *)self);
+  [forwardedPromise detachObserver];
+}
+
+/**
+ Returns the dispatch group the receiver was created in, if any.
+ */
+- (nullable dispatch_group_t)enteredDispatchGroup {
+#ifdef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+  return nil;
+#else
+  return _dispatchGroup;
+#endif
+}
+
+/**
+ Leaves the dispatch group entered on creation, once the receiver is not pending anymore.
+ */
+- (void)leaveDispatchGroup {
+#ifndef FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED
+  if (_dispatchGroup) {
+    dispatch_group_leave(_dispatchGroup);
+  }
+#endif
+}
+
+/**
+ Unregisters the receiver from the leak detector, once it is not pending anymore.
+ */
+- (void)untrackLeakDeallocated:(BOOL)deallocated {
+  if (_leakDetectorTracked) {
+    FSLPromiseLeakDetectorUntrack((__bridge void const *)self, deallocated);
+  }
+}
+
 @end
 
 @implementation FSLPromise (DotSyntaxAdditions)
@@ -0,0 +1,313 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseCircuitBreaker.h"
+
+#import <stdatomic.h>
+#import <time.h>
+
+#import "FSLPromise+Timeout.h"
+#import "FSLPromisePrivate.h"
+
+/** Number of buckets the window is split into, each counting the results for a part of it. */
+static NSUInteger const FSLPromiseCircuitBreakerBucketsCount = 10;
+
+/** Max count of successes or failures per bucket, past which it saturates. */
+static uint64_t const FSLPromiseCircuitBreakerMaxBucketCount = 0xFFFF;
+
+/** Max number of probes the state word can hold. */
+static uint64_t const FSLPromiseCircuitBreakerMaxProbesCount = 0x3FFF;
+
+/**
+ Returns the current time of a monotonic clock in milliseconds.
+ */
+static uint64_t FSLPromiseCircuitBreakerNow(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000 + (uint64_t)time.tv_nsec / NSEC_PER_MSEC;
+}
+
+// The state word packs the state in the low 2 bits, the number of probes taken in the next 14
+// and the time the state was entered at, in milliseconds, in the high 48, so that it can be
+// updated with a single atomic compare-and-swap.
+
+NS_INLINE uint64_t FSLPromiseCircuitBreakerStateWord(FSLPromiseCircuitBreakerState state,
+                                                     uint64_t probesCount, uint64_t time) {
+  return (time << 16) | (probesCount << 2) | (uint64_t)state;
+}
+
+NS_INLINE FSLPromiseCircuitBreakerState FSLPromiseCircuitBreakerStateWordState(uint64_t word) {
+  return (FSLPromiseCircuitBreakerState)(word & 0x3);
+}
+
+NS_INLINE uint64_t FSLPromiseCircuitBreakerStateWordProbesCount(uint64_t word) {
+  return (word >> 2) & FSLPromiseCircuitBreakerMaxProbesCount;
+}
+
+NS_INLINE uint64_t FSLPromiseCircuitBreakerStateWordTime(uint64_t word) {
+  return word >> 16;
+}
+
+// Each bucket word packs the number of successes in the low 16 bits, the number of failures in
+// the next 16 and the epoch of the bucket, i.e. the time divided by the bucket interval, in the
+// high 32.
+
+NS_INLINE uint64_t FSLPromiseCircuitBreakerBucketWord(uint32_t epoch, uint64_t failuresCount,
+                                                      uint64_t successesCount) {
+  return ((uint64_t)epoch << 32) | (failuresCount << 16) | successesCount;
+}
+
+@implementation FSLPromiseCircuitBreaker {
+  _Atomic(uint64_t) _stateWord;
+  _Atomic(uint64_t) _buckets[FSLPromiseCircuitBreakerBucketsCount];
+  double _threshold;
+  NSUInteger _minResultsCount;
+  /** Time covered by each bucket, in milliseconds. */
+  uint64_t _bucketInterval;
+  /** Time to stay open for, in milliseconds. */
+  uint64_t _coolDownInterval;
+  uint64_t _probesCount;
+}
+
+- (instancetype)initWithFailureRateThreshold:(double)threshold
+                              minResultsCount:(NSUInteger)count
+                               windowInterval:(NSTimeInterval)windowInterval
+                             coolDownInterval:(NSTimeInterval)coolDownInterval
+                                  probesCount:(NSUInteger)probesCount {
+  self = [super init];
+  if (self) {
+    _threshold = threshold;
+    _minResultsCount = MAX(count, (NSUInteger)1);
+    _bucketInterval =
+        MAX((uint64_t)(windowInterval * 1000 / FSLPromiseCircuitBreakerBucketsCount), 1);
+    _coolDownInterval = (uint64_t)(MAX(coolDownInterval, 0) * 1000);
+    _probesCount = MIN(MAX(probesCount, (NSUInteger)1), FSLPromiseCircuitBreakerMaxProbesCount);
+    atomic_init(&_stateWord, FSLPromiseCircuitBreakerStateWord(
+                                 FSLPromiseCircuitBreakerStateClosed, 0,
+                                 FSLPromiseCircuitBreakerNow()));
+    for (NSUInteger i = 0; i < FSLPromiseCircuitBreakerBucketsCount; ++i) {
+      atomic_init(&_buckets[i], 0);
+    }
+  }
+  return self;
+}
+
+- (FSLPromiseCircuitBreakerState)state {
+  return FSLPromiseCircuitBreakerStateWordState(
+      atomic_load_explicit(&_stateWord, memory_order_relaxed));
+}
+
+- (FSLPromise *)execute:(FSLPromiseCircuitBreakerWorkBlock)work {
+  return [self onQueue:FSLPromise.defaultDispatchQueue execute:work];
+}
+
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue execute:(FSLPromiseCircuitBreakerWorkBlock)work {
+  return [self onQueue:queue timeout:0 execute:work];
+}
+
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+                timeout:(NSTimeInterval)interval
+                execute:(FSLPromiseCircuitBreakerWorkBlock)work {
+  NSParameterAssert(queue);
+
+  return [self onTarget:FSLPromiseTargetWithQueue(queue) timeout:interval execute:work];
+}
+
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                   timeout:(NSTimeInterval)interval
+                   execute:(FSLPromiseCircuitBreakerWorkBlock)work {
+  NSParameterAssert(executor);
+
+  return [self onTarget:FSLPromiseTargetWithExecutor(executor) timeout:interval execute:work];
+}
+
+/**
+ Same as `onQueue:timeout:execute:`, but invokes `work` on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target
+                 timeout:(NSTimeInterval)interval
+                 execute:(FSLPromiseCircuitBreakerWorkBlock)work {
+  NSParameterAssert(work);
+
+  if (![self allowsWork]) {
+    return [[FSLPromise alloc]
+        initWithResolution:[[NSError alloc] initWithDomain:FSLPromiseErrorDomain
+                                                      code:FSLPromiseErrorCodeCircuitOpen
+                                                  userInfo:nil]];
+  }
+  FSLPromise *promise = [[FSLPromise alloc] initPending];
+  [promise dispatchOnTarget:target
+                      block:^{
+                        if (!promise.isPending) {
+                          [self releaseProbe];
+                          return;
+                        }
+                        id value = work();
+                        FSLPromise *workPromise =
+                            [value isKindOfClass:[FSLPromise class]]
+                                ? (FSLPromise *)value
+                                : [[FSLPromise alloc] initWithResolution:value];
+                        if (interval > 0) {
+                          workPromise = [workPromise onTarget:target timeout:interval];
+                        }
+                        [workPromise observeOnTarget:target
+                            fulfill:^(id __nullable result) {
+                              [self recordSuccess];
+                              [promise fulfill:result];
+                            }
+                            reject:^(NSError *error) {
+                              // Cancellation says nothing about the health of the dependency.
+                              if (FSLPromiseErrorIsCancelled(error)) {
+                                [self releaseProbe];
+                              } else {
+                                [self recordFailure];
+                              }
+                              [promise reject:error];
+                            }];
+                        [promise propagateCancellationToPromise:workPromise];
+                      }];
+  return promise;
+}
+
+- (BOOL)allowsWork {
+  uint64_t word = atomic_load_explicit(&_stateWord, memory_order_relaxed);
+  while (YES) {
+    uint64_t newWord;
+    switch (FSLPromiseCircuitBreakerStateWordState(word)) {
+      case FSLPromiseCircuitBreakerStateClosed:
+        return YES;
+      case FSLPromiseCircuitBreakerStateOpen: {
+        uint64_t now = FSLPromiseCircuitBreakerNow();
+        if (now < FSLPromiseCircuitBreakerStateWordTime(word) + _coolDownInterval) {
+          return NO;
+        }
+        newWord = FSLPromiseCircuitBreakerStateWord(FSLPromiseCircuitBreakerStateHalfOpen, 1, now);
+        break;
+      }
+      case FSLPromiseCircuitBreakerStateHalfOpen: {
+        uint64_t probesCount = FSLPromiseCircuitBreakerStateWordProbesCount(word);
+        if (probesCount >= _probesCount) {
+          return NO;
+        }
+        newWord = FSLPromiseCircuitBreakerStateWord(FSLPromiseCircuitBreakerStateHalfOpen,
+                                                    probesCount + 1,
+                                                    FSLPromiseCircuitBreakerStateWordTime(word));
+        break;
+      }
+    }
+    if (atomic_compare_exchange_weak_explicit(&_stateWord, &word, newWord, memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      return YES;
+    }
+  }
+}
+
+- (void)recordSuccess {
+  [self recordResult:YES];
+}
+
+- (void)recordFailure {
+  [self recordResult:NO];
+}
+
+#pragma mark - Private
+
+- (void)recordResult:(BOOL)isSuccess {
+  uint64_t now = FSLPromiseCircuitBreakerNow();
+  [self addResult:isSuccess atTime:now];
+  uint64_t word = atomic_load_explicit(&_stateWord, memory_order_relaxed);
+  while (YES) {
+    uint64_t newWord;
+    switch (FSLPromiseCircuitBreakerStateWordState(word)) {
+      case FSLPromiseCircuitBreakerStateClosed:
+        if (isSuccess || ![self isFailureRateExceededAtTime:now]) {
+          return;
+        }
+        newWord = FSLPromiseCircuitBreakerStateWord(FSLPromiseCircuitBreakerStateOpen, 0, now);
+        break;
+      case FSLPromiseCircuitBreakerStateOpen:
+        // Results of work let through before the breaker opened.
+        return;
+      case FSLPromiseCircuitBreakerStateHalfOpen:
+        newWord = FSLPromiseCircuitBreakerStateWord(
+            isSuccess ? FSLPromiseCircuitBreakerStateClosed : FSLPromiseCircuitBreakerStateOpen, 0,
+            now);
+        break;
+    }
+    if (atomic_compare_exchange_weak_explicit(&_stateWord, &word, newWord, memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      if (FSLPromiseCircuitBreakerStateWordState(newWord) == FSLPromiseCircuitBreakerStateClosed) {
+        // Start over, so that the failures which opened the breaker don't open it again.
+        for (NSUInteger i = 0; i < FSLPromiseCircuitBreakerBucketsCount; ++i) {
+          atomic_store_explicit(&_buckets[i], 0, memory_order_relaxed);
+        }
+      }
+      return;
+    }
+  }
+}
+
+/**
+ Gives back a probe taken for work which hasn't produced a result.
+ */
+- (void)releaseProbe {
+  uint64_t word = atomic_load_explicit(&_stateWord, memory_order_relaxed);
+  while (FSLPromiseCircuitBreakerStateWordState(word) == FSLPromiseCircuitBreakerStateHalfOpen &&
+         FSLPromiseCircuitBreakerStateWordProbesCount(word) > 0 &&
+         !atomic_compare_exchange_weak_explicit(&_stateWord, &word, word - (1 << 2),
+                                                memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+- (void)addResult:(BOOL)isSuccess atTime:(uint64_t)time {
+  uint64_t epoch = time / _bucketInterval;
+  _Atomic(uint64_t) *bucket = &_buckets[epoch % FSLPromiseCircuitBreakerBucketsCount];
+  uint64_t word = atomic_load_explicit(bucket, memory_order_relaxed);
+  uint64_t newWord;
+  do {
+    BOOL isStale = (word >> 32) != (uint32_t)epoch;
+    uint64_t failuresCount = isStale ? 0 : (word >> 16) & FSLPromiseCircuitBreakerMaxBucketCount;
+    uint64_t successesCount = isStale ? 0 : word & FSLPromiseCircuitBreakerMaxBucketCount;
+    if (isSuccess) {
+      successesCount = MIN(successesCount + 1, FSLPromiseCircuitBreakerMaxBucketCount);
+    } else {
+      failuresCount = MIN(failuresCount + 1, FSLPromiseCircuitBreakerMaxBucketCount);
+    }
+    newWord = FSLPromiseCircuitBreakerBucketWord((uint32_t)epoch, failuresCount, successesCount);
+  } while (newWord != word &&
+           !atomic_compare_exchange_weak_explicit(bucket, &word, newWord, memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+- (BOOL)isFailureRateExceededAtTime:(uint64_t)time {
+  uint32_t epoch = (uint32_t)(time / _bucketInterval);
+  uint64_t failuresCount = 0;
+  uint64_t resultsCount = 0;
+  for (NSUInteger i = 0; i < FSLPromiseCircuitBreakerBucketsCount; ++i) {
+    uint64_t word = atomic_load_explicit(&_buckets[i], memory_order_relaxed);
+    // Skip the buckets left from earlier windows.
+    if (word == 0 || epoch - (uint32_t)(word >> 32) >= FSLPromiseCircuitBreakerBucketsCount) {
+      continue;
+    }
+    uint64_t bucketFailuresCount = (word >> 16) & FSLPromiseCircuitBreakerMaxBucketCount;
+    failuresCount += bucketFailuresCount;
+    resultsCount += bucketFailuresCount + (word & FSLPromiseCircuitBreakerMaxBucketCount);
+  }
+  return resultsCount >= _minResultsCount && failuresCount >= _threshold * resultsCount;
+}
+
+@end
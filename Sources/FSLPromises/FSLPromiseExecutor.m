@@ -0,0 +1,38 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseExecutor.h"
+
+@implementation FSLPromiseDispatchQueueExecutor
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue {
+  NSParameterAssert(queue);
+
+  self = [super init];
+  if (self) {
+    _queue = queue;
+  }
+  return self;
+}
+
+- (void)executeBlock:(dispatch_block_t)block {
+  NSParameterAssert(block);
+
+  dispatch_async(_queue, block);
+}
+
+@end
@@ -0,0 +1,254 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromisePrivate.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+#import <string.h>
+#import <time.h>
+
+/** Number of events to buffer per thread before handing them to the sink. */
+static NSUInteger const FSLPromiseInstrumentationBufferCapacity = 256;
+
+/** Number of distinct queue labels to keep copies of per thread. */
+static NSUInteger const FSLPromiseInstrumentationLabelCapacity = 32;
+
+/** Copy of a queue label, which outlives the queue. */
+typedef struct {
+  char const *label;
+  char *copy;
+} FSLPromiseInstrumentationLabel;
+
+/** Events recorded on a thread and not handed to the sink yet. */
+typedef struct FSLPromiseInstrumentationBuffer {
+  /**
+   Guards the events and their count, which are flushed by other threads at times, so it's hardly
+   ever contended.
+   */
+  pthread_mutex_t mutex;
+  FSLPromiseInstrumentationEvent events[FSLPromiseInstrumentationBufferCapacity];
+  NSUInteger count;
+  uint64_t threadID;
+  /** Copies of the labels of the queues seen on the thread, never freed, for events to refer to. */
+  FSLPromiseInstrumentationLabel labels[FSLPromiseInstrumentationLabelCapacity];
+  NSUInteger labelsCount;
+  /** Buffers of the other threads, guarded by `gFSLPromiseInstrumentationBuffersMutex`. */
+  struct FSLPromiseInstrumentationBuffer *previous;
+  struct FSLPromiseInstrumentationBuffer *next;
+} FSLPromiseInstrumentationBuffer;
+
+/** Current `FSLPromiseInstrumentation.sink`, retained forever to read it without locks. */
+static void *_Atomic gFSLPromiseInstrumentationSink;
+
+/** Buffer of the current thread, also registered under `gFSLPromiseInstrumentationBufferKey`. */
+static _Thread_local FSLPromiseInstrumentationBuffer *gFSLPromiseInstrumentationBuffer;
+
+/** Whether the sink is handling events on the current thread, to drop the ones it records. */
+static _Thread_local BOOL gFSLPromiseInstrumentationIsFlushing;
+
+/** Buffers of all threads, to flush them at once. */
+static FSLPromiseInstrumentationBuffer *gFSLPromiseInstrumentationBuffers;
+static pthread_mutex_t gFSLPromiseInstrumentationBuffersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Key to flush and free the buffer of a thread once it exits. */
+static pthread_key_t gFSLPromiseInstrumentationBufferKey;
+
+static _Atomic(uint64_t) gFSLPromiseInstrumentationLastThreadID;
+
+static uint64_t FSLPromiseInstrumentationNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+/**
+ Hands the buffered events to the current sink, or drops them if there's none anymore. Must be
+ called with the mutex of the buffer locked.
+ */
+static void FSLPromiseInstrumentationFlushBuffer(FSLPromiseInstrumentationBuffer *buffer) {
+  if (buffer->count == 0) {
+    return;
+  }
+  id<FSLPromiseInstrumentationSink> sink = (__bridge id<FSLPromiseInstrumentationSink>)
+      atomic_load_explicit(&gFSLPromiseInstrumentationSink, memory_order_acquire);
+  gFSLPromiseInstrumentationIsFlushing = YES;
+  [sink promiseInstrumentationDidRecordEvents:buffer->events count:buffer->count];
+  buffer->count = 0;
+  gFSLPromiseInstrumentationIsFlushing = NO;
+}
+
+/**
+ Returns a copy of `label` valid forever, or NULL if too many distinct labels have been seen on the
+ current thread already.
+ */
+static char const *__nullable FSLPromiseInstrumentationCopyLabel(
+    FSLPromiseInstrumentationBuffer *buffer, char const *label) {
+  for (NSUInteger i = 0; i < buffer->labelsCount; ++i) {
+    // The label of a released queue may be reused for another one.
+    if (buffer->labels[i].label == label && strcmp(buffer->labels[i].copy, label) == 0) {
+      return buffer->labels[i].copy;
+    }
+  }
+  if (buffer->labelsCount == FSLPromiseInstrumentationLabelCapacity) {
+    return NULL;
+  }
+  char *copy = strdup(label);
+  buffer->labels[buffer->labelsCount++] = (FSLPromiseInstrumentationLabel){label, copy};
+  return copy;
+}
+
+static void FSLPromiseInstrumentationDestroyBuffer(void *context) {
+  FSLPromiseInstrumentationBuffer *buffer = context;
+  pthread_mutex_lock(&gFSLPromiseInstrumentationBuffersMutex);
+  if (buffer->previous) {
+    buffer->previous->next = buffer->next;
+  } else {
+    gFSLPromiseInstrumentationBuffers = buffer->next;
+  }
+  if (buffer->next) {
+    buffer->next->previous = buffer->previous;
+  }
+  pthread_mutex_unlock(&gFSLPromiseInstrumentationBuffersMutex);
+  pthread_mutex_lock(&buffer->mutex);
+  FSLPromiseInstrumentationFlushBuffer(buffer);
+  pthread_mutex_unlock(&buffer->mutex);
+  // Later destructors recording any events on this thread get a new buffer.
+  gFSLPromiseInstrumentationBuffer = NULL;
+  pthread_mutex_destroy(&buffer->mutex);
+  free(buffer);
+}
+
+static FSLPromiseInstrumentationBuffer *FSLPromiseInstrumentationCurrentBuffer(void) {
+  FSLPromiseInstrumentationBuffer *buffer = gFSLPromiseInstrumentationBuffer;
+  if (!buffer) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      pthread_key_create(&gFSLPromiseInstrumentationBufferKey,
+                         FSLPromiseInstrumentationDestroyBuffer);
+    });
+    buffer = calloc(1, sizeof(*buffer));
+    pthread_mutex_init(&buffer->mutex, NULL);
+    buffer->threadID = 1 + atomic_fetch_add_explicit(&gFSLPromiseInstrumentationLastThreadID, 1,
+                                                     memory_order_relaxed);
+    pthread_mutex_lock(&gFSLPromiseInstrumentationBuffersMutex);
+    buffer->next = gFSLPromiseInstrumentationBuffers;
+    if (buffer->next) {
+      buffer->next->previous = buffer;
+    }
+    gFSLPromiseInstrumentationBuffers = buffer;
+    pthread_mutex_unlock(&gFSLPromiseInstrumentationBuffersMutex);
+    pthread_setspecific(gFSLPromiseInstrumentationBufferKey, buffer);
+    gFSLPromiseInstrumentationBuffer = buffer;
+  }
+  return buffer;
+}
+
+static uint64_t FSLPromiseInstrumentationAppend(FSLPromiseInstrumentationBuffer *buffer,
+                                                FSLPromiseInstrumentationEventKind kind,
+                                                void const *__nullable object,
+                                                void const *__nullable parent,
+                                                uint64_t creationTime,
+                                                char const *__nullable name) {
+  uint64_t const now = FSLPromiseInstrumentationNow();
+  pthread_mutex_lock(&buffer->mutex);
+  buffer->events[buffer->count++] = (FSLPromiseInstrumentationEvent){
+      .kind = kind,
+      .timestamp = now,
+      .threadID = buffer->threadID,
+      .object = (uintptr_t)object,
+      .parent = (uintptr_t)parent,
+      .pendingInterval = creationTime ? now - creationTime : 0,
+      .name = name,
+  };
+  if (buffer->count == FSLPromiseInstrumentationBufferCapacity) {
+    FSLPromiseInstrumentationFlushBuffer(buffer);
+  }
+  pthread_mutex_unlock(&buffer->mutex);
+  return now;
+}
+
+uint64_t FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKind kind,
+                                         void const *__nullable object,
+                                         void const *__nullable parent, uint64_t creationTime,
+                                         char const *__nullable name) {
+  if (!atomic_load_explicit(&gFSLPromiseInstrumentationSink, memory_order_relaxed)) {
+    return 0;
+  }
+  if (gFSLPromiseInstrumentationIsFlushing) {
+    return FSLPromiseInstrumentationNow();
+  }
+  return FSLPromiseInstrumentationAppend(FSLPromiseInstrumentationCurrentBuffer(), kind, object,
+                                         parent, creationTime, name);
+}
+
+void FSLPromiseInstrumentationRecordOnQueue(FSLPromiseInstrumentationEventKind kind,
+                                            void const *__nullable object,
+                                            dispatch_queue_t __nullable queue) {
+  if (!atomic_load_explicit(&gFSLPromiseInstrumentationSink, memory_order_relaxed) ||
+      gFSLPromiseInstrumentationIsFlushing) {
+    return;
+  }
+  FSLPromiseInstrumentationBuffer *buffer = FSLPromiseInstrumentationCurrentBuffer();
+  // Blocks run by executors other than dispatch queues are left unnamed.
+  char const *label =
+      queue ? FSLPromiseInstrumentationCopyLabel(buffer, dispatch_queue_get_label(queue)) : NULL;
+  FSLPromiseInstrumentationAppend(buffer, kind, object, NULL, 0, label);
+}
+
+@implementation FSLPromiseInstrumentation
+
++ (BOOL)isEnabled {
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+  return YES;
+#else
+  return NO;
+#endif
+}
+
++ (nullable id<FSLPromiseInstrumentationSink>)sink {
+  return (__bridge id<FSLPromiseInstrumentationSink>)atomic_load_explicit(
+      &gFSLPromiseInstrumentationSink, memory_order_acquire);
+}
+
++ (void)setSink:(nullable id<FSLPromiseInstrumentationSink>)sink {
+  // Previous sinks are leaked intentionally, so that concurrent flushes never get a released one.
+  atomic_store_explicit(&gFSLPromiseInstrumentationSink, (__bridge_retained void *)sink,
+                        memory_order_release);
+}
+
++ (void)flush {
+  FSLPromiseInstrumentationBuffer *buffer = gFSLPromiseInstrumentationBuffer;
+  if (buffer) {
+    pthread_mutex_lock(&buffer->mutex);
+    FSLPromiseInstrumentationFlushBuffer(buffer);
+    pthread_mutex_unlock(&buffer->mutex);
+  }
+}
+
++ (void)flushAllThreads {
+  pthread_mutex_lock(&gFSLPromiseInstrumentationBuffersMutex);
+  for (FSLPromiseInstrumentationBuffer *buffer = gFSLPromiseInstrumentationBuffers; buffer;
+       buffer = buffer->next) {
+    pthread_mutex_lock(&buffer->mutex);
+    FSLPromiseInstrumentationFlushBuffer(buffer);
+    pthread_mutex_unlock(&buffer->mutex);
+  }
+  pthread_mutex_unlock(&gFSLPromiseInstrumentationBuffersMutex);
+}
+
+@end
@@ -0,0 +1,478 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseLatencyHistograms.h"
+
+#import "FSLPromisePrivate.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+#import <string.h>
+#import <time.h>
+
+/** Number of buckets per power of two, which gives the relative precision. */
+static NSUInteger const FSLPromiseLatencySubBucketsCount = 16;
+static NSUInteger const FSLPromiseLatencySubBucketBits = 4;
+
+/** Latencies in nanoseconds are clamped to fit in that many bits. */
+static NSUInteger const FSLPromiseLatencyMaxBits = 40;
+
+static NSUInteger const FSLPromiseLatencyBucketsCount =
+    (FSLPromiseLatencyMaxBits - FSLPromiseLatencySubBucketBits + 1) *
+    FSLPromiseLatencySubBucketsCount;
+
+static NSUInteger const FSLPromiseLatencyMetricsCount = FSLPromiseLatencyMetricRun + 1;
+
+/** Max number of distinct combinators and labels, including none at index zero. */
+static NSUInteger const FSLPromiseLatencyMaxCombinatorsCount = 64;
+static NSUInteger const FSLPromiseLatencyMaxLabelsCount = 256;
+
+/** Max number of distinct combinator and label pairs, including the invalid key zero. */
+static NSUInteger const FSLPromiseLatencyMaxKeysCount = 1024;
+
+/** Histogram of one metric for one key on one thread. */
+typedef struct {
+  _Atomic(uint64_t) count;
+  _Atomic(uint64_t) sum;
+  _Atomic(uint64_t) buckets[FSLPromiseLatencyBucketsCount];
+} FSLPromiseLatencyCounts;
+
+/**
+ Histograms written by a single thread and read by snapshots. Once the thread exits, the storage
+ gets reused by another one, keeping the counts.
+ */
+typedef struct FSLPromiseLatencyThread {
+  struct FSLPromiseLatencyThread *next;
+  atomic_bool isInUse;
+  /** Histograms per key and metric, allocated on first use. */
+  FSLPromiseLatencyCounts *_Atomic counts[FSLPromiseLatencyMaxKeysCount]
+                                         [FSLPromiseLatencyMetricsCount];
+} FSLPromiseLatencyThread;
+
+static atomic_bool gFSLPromiseLatencyEnabled;
+
+/** Guards the registration of combinators, labels and keys, as well as snapshots and resets. */
+static pthread_mutex_t gFSLPromiseLatencyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static char const *_Atomic gFSLPromiseLatencyCombinators[FSLPromiseLatencyMaxCombinatorsCount];
+static _Atomic(NSUInteger) gFSLPromiseLatencyCombinatorsCount = 1;
+
+static NSString *gFSLPromiseLatencyLabels[FSLPromiseLatencyMaxLabelsCount];
+static NSMutableDictionary<NSString *, NSNumber *> *gFSLPromiseLatencyLabelIndexes;
+
+/** Key of each combinator and label pair, or zero if none has been assigned yet. */
+static _Atomic(uint16_t) gFSLPromiseLatencyKeys[FSLPromiseLatencyMaxCombinatorsCount]
+                                               [FSLPromiseLatencyMaxLabelsCount];
+static uint8_t gFSLPromiseLatencyKeyCombinators[FSLPromiseLatencyMaxKeysCount];
+static uint8_t gFSLPromiseLatencyKeyLabels[FSLPromiseLatencyMaxKeysCount];
+static NSUInteger gFSLPromiseLatencyKeysCount = 1;
+
+/** Counts subtracted from snapshots, as of the last reset. */
+static FSLPromiseLatencyCounts
+    *gFSLPromiseLatencyBaseline[FSLPromiseLatencyMaxKeysCount][FSLPromiseLatencyMetricsCount];
+
+static FSLPromiseLatencyThread *_Atomic gFSLPromiseLatencyThreads;
+static _Thread_local FSLPromiseLatencyThread *gFSLPromiseLatencyCurrentThread;
+static pthread_key_t gFSLPromiseLatencyThreadKey;
+
+/** Combinator index in the upper byte and label index in the lower one. */
+static _Thread_local uint16_t gFSLPromiseLatencyContext;
+
+static uint64_t FSLPromiseLatencyClock(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+static BOOL FSLPromiseLatencyIsEnabled(void) {
+  return atomic_load_explicit(&gFSLPromiseLatencyEnabled, memory_order_relaxed);
+}
+
+static NSUInteger FSLPromiseLatencyBucketIndex(uint64_t latency) {
+  latency = MIN(latency, (1ull << FSLPromiseLatencyMaxBits) - 1);
+  if (latency < FSLPromiseLatencySubBucketsCount) {
+    return (NSUInteger)latency;
+  }
+  NSUInteger const shift = (NSUInteger)(63 - __builtin_clzll(latency)) -
+                           FSLPromiseLatencySubBucketBits;
+  return (shift + 1) * FSLPromiseLatencySubBucketsCount +
+         (NSUInteger)(latency >> shift) - FSLPromiseLatencySubBucketsCount;
+}
+
+static uint64_t FSLPromiseLatencyBucketLowerBound(NSUInteger index) {
+  if (index < FSLPromiseLatencySubBucketsCount) {
+    return index;
+  }
+  NSUInteger const shift = index / FSLPromiseLatencySubBucketsCount - 1;
+  return (uint64_t)(index % FSLPromiseLatencySubBucketsCount + FSLPromiseLatencySubBucketsCount)
+         << shift;
+}
+
+/** Only the owning thread writes the counts, so a plain load and store is enough. */
+static void FSLPromiseLatencyIncrement(_Atomic(uint64_t) *counter, uint64_t delta) {
+  atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + delta,
+                        memory_order_relaxed);
+}
+
+/** Subtracts a baseline from merged counts, which only ever grow and so can't get below it. */
+static void FSLPromiseLatencySubtract(_Atomic(uint64_t) *counter, _Atomic(uint64_t) *baseline) {
+  atomic_store_explicit(counter,
+                        atomic_load_explicit(counter, memory_order_relaxed) -
+                            atomic_load_explicit(baseline, memory_order_relaxed),
+                        memory_order_relaxed);
+}
+
+static void FSLPromiseLatencyReleaseThread(void *thread) {
+  gFSLPromiseLatencyCurrentThread = NULL;
+  atomic_store_explicit(&((FSLPromiseLatencyThread *)thread)->isInUse, false,
+                        memory_order_release);
+}
+
+static FSLPromiseLatencyThread *FSLPromiseLatencyCurrentThread(void) {
+  FSLPromiseLatencyThread *thread = gFSLPromiseLatencyCurrentThread;
+  if (thread) {
+    return thread;
+  }
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    pthread_key_create(&gFSLPromiseLatencyThreadKey, FSLPromiseLatencyReleaseThread);
+  });
+  for (thread = atomic_load_explicit(&gFSLPromiseLatencyThreads, memory_order_acquire); thread;
+       thread = thread->next) {
+    bool expected = false;
+    if (atomic_compare_exchange_strong_explicit(&thread->isInUse, &expected, true,
+                                                memory_order_acquire, memory_order_relaxed)) {
+      break;
+    }
+  }
+  if (!thread) {
+    thread = calloc(1, sizeof(*thread));
+    atomic_init(&thread->isInUse, true);
+    thread->next = atomic_load_explicit(&gFSLPromiseLatencyThreads, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&gFSLPromiseLatencyThreads, &thread->next, thread,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+  }
+  pthread_setspecific(gFSLPromiseLatencyThreadKey, thread);
+  gFSLPromiseLatencyCurrentThread = thread;
+  return thread;
+}
+
+/** Returns the index of a combinator, registering it if needed, or zero if there are too many. */
+static uint8_t FSLPromiseLatencyCombinatorIndex(char const *name) {
+  NSUInteger count =
+      atomic_load_explicit(&gFSLPromiseLatencyCombinatorsCount, memory_order_acquire);
+  // Combinator names are string literals, so the same pointers keep coming back.
+  for (NSUInteger i = 1; i < count; ++i) {
+    if (atomic_load_explicit(&gFSLPromiseLatencyCombinators[i], memory_order_relaxed) == name) {
+      return (uint8_t)i;
+    }
+  }
+  uint8_t index = 0;
+  pthread_mutex_lock(&gFSLPromiseLatencyMutex);
+  count = atomic_load_explicit(&gFSLPromiseLatencyCombinatorsCount, memory_order_relaxed);
+  for (NSUInteger i = 1; i < count; ++i) {
+    if (strcmp(gFSLPromiseLatencyCombinators[i], name) == 0) {
+      index = (uint8_t)i;
+      break;
+    }
+  }
+  if (!index && count < FSLPromiseLatencyMaxCombinatorsCount) {
+    index = (uint8_t)count;
+    atomic_store_explicit(&gFSLPromiseLatencyCombinators[count], name, memory_order_relaxed);
+    atomic_store_explicit(&gFSLPromiseLatencyCombinatorsCount, count + 1, memory_order_release);
+  }
+  pthread_mutex_unlock(&gFSLPromiseLatencyMutex);
+  return index;
+}
+
+/** Returns the index of a label, registering it if needed, or zero if there are too many. */
+static uint8_t FSLPromiseLatencyLabelIndex(NSString *label) {
+  uint8_t index = 0;
+  pthread_mutex_lock(&gFSLPromiseLatencyMutex);
+  if (!gFSLPromiseLatencyLabelIndexes) {
+    gFSLPromiseLatencyLabelIndexes = [[NSMutableDictionary alloc] init];
+  }
+  NSNumber *labelIndex = gFSLPromiseLatencyLabelIndexes[label];
+  if (labelIndex) {
+    index = labelIndex.unsignedCharValue;
+  } else if (gFSLPromiseLatencyLabelIndexes.count + 1 < FSLPromiseLatencyMaxLabelsCount) {
+    index = (uint8_t)(gFSLPromiseLatencyLabelIndexes.count + 1);
+    gFSLPromiseLatencyLabels[index] = [label copy];
+    gFSLPromiseLatencyLabelIndexes[gFSLPromiseLatencyLabels[index]] = @(index);
+  }
+  pthread_mutex_unlock(&gFSLPromiseLatencyMutex);
+  return index;
+}
+
+/** Merges the counts of all threads for a key and a metric into `merged`. */
+static void FSLPromiseLatencyMerge(uint16_t key, FSLPromiseLatencyMetric metric,
+                                   FSLPromiseLatencyCounts *merged) {
+  for (FSLPromiseLatencyThread *thread =
+           atomic_load_explicit(&gFSLPromiseLatencyThreads, memory_order_acquire);
+       thread; thread = thread->next) {
+    FSLPromiseLatencyCounts *counts =
+        atomic_load_explicit(&thread->counts[key][metric], memory_order_acquire);
+    if (!counts) {
+      continue;
+    }
+    FSLPromiseLatencyIncrement(&merged->count,
+                               atomic_load_explicit(&counts->count, memory_order_relaxed));
+    FSLPromiseLatencyIncrement(&merged->sum,
+                               atomic_load_explicit(&counts->sum, memory_order_relaxed));
+    for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+      FSLPromiseLatencyIncrement(&merged->buckets[i],
+                                 atomic_load_explicit(&counts->buckets[i], memory_order_relaxed));
+    }
+  }
+}
+
+uint64_t FSLPromiseLatencyNow(void) {
+  return FSLPromiseLatencyIsEnabled() ? FSLPromiseLatencyClock() : 0;
+}
+
+uint16_t FSLPromiseLatencyCurrentKey(void) {
+  if (!FSLPromiseLatencyIsEnabled()) {
+    return 0;
+  }
+  uint16_t const context = gFSLPromiseLatencyContext;
+  uint8_t const combinator = (uint8_t)(context >> 8);
+  uint8_t const label = (uint8_t)context;
+  _Atomic(uint16_t) *slot = &gFSLPromiseLatencyKeys[combinator][label];
+  uint16_t key = atomic_load_explicit(slot, memory_order_acquire);
+  if (!key) {
+    pthread_mutex_lock(&gFSLPromiseLatencyMutex);
+    key = atomic_load_explicit(slot, memory_order_relaxed);
+    if (!key && gFSLPromiseLatencyKeysCount < FSLPromiseLatencyMaxKeysCount) {
+      key = (uint16_t)gFSLPromiseLatencyKeysCount++;
+      gFSLPromiseLatencyKeyCombinators[key] = combinator;
+      gFSLPromiseLatencyKeyLabels[key] = label;
+      atomic_store_explicit(slot, key, memory_order_release);
+    }
+    pthread_mutex_unlock(&gFSLPromiseLatencyMutex);
+  }
+  return key;
+}
+
+uint64_t FSLPromiseLatencyRecord(FSLPromiseLatencyMetric metric, uint16_t key,
+                                 uint64_t startTime) {
+  if (!key || !startTime || !FSLPromiseLatencyIsEnabled()) {
+    return 0;
+  }
+  uint64_t const now = FSLPromiseLatencyClock();
+  uint64_t const latency = now > startTime ? now - startTime : 0;
+  FSLPromiseLatencyThread *thread = FSLPromiseLatencyCurrentThread();
+  FSLPromiseLatencyCounts *counts =
+      atomic_load_explicit(&thread->counts[key][metric], memory_order_relaxed);
+  if (!counts) {
+    counts = calloc(1, sizeof(*counts));
+    atomic_store_explicit(&thread->counts[key][metric], counts, memory_order_release);
+  }
+  FSLPromiseLatencyIncrement(&counts->count, 1);
+  FSLPromiseLatencyIncrement(&counts->sum, latency);
+  FSLPromiseLatencyIncrement(&counts->buckets[FSLPromiseLatencyBucketIndex(latency)], 1);
+  return now;
+}
+
+uint16_t FSLPromiseLatencyEnterCombinator(char const *name) {
+  uint16_t const context = gFSLPromiseLatencyContext;
+  // Attribute everything to the outermost combinator, which is the one called by the user.
+  if (!(context >> 8) && FSLPromiseLatencyIsEnabled()) {
+    gFSLPromiseLatencyContext =
+        (uint16_t)(FSLPromiseLatencyCombinatorIndex(name) << 8 | (context & 0xFF));
+  }
+  return context;
+}
+
+void FSLPromiseLatencyRestoreContext(uint16_t context) {
+  gFSLPromiseLatencyContext = context;
+}
+
+FSLPromiseLatencyContinuation FSLPromiseLatencyBeginContinuation(uint16_t key,
+                                                                 uint64_t dispatchTime) {
+  FSLPromiseLatencyContinuation continuation = {
+      .key = key,
+      .previousContext = gFSLPromiseLatencyContext,
+  };
+  if (key && FSLPromiseLatencyIsEnabled()) {
+    continuation.startTime =
+        dispatchTime ? FSLPromiseLatencyRecord(FSLPromiseLatencyMetricQueueWait, key, dispatchTime)
+                     : FSLPromiseLatencyClock();
+    // Let the label flow down to whatever the observer creates.
+    gFSLPromiseLatencyContext = gFSLPromiseLatencyKeyLabels[key];
+  }
+  return continuation;
+}
+
+void FSLPromiseLatencyEndContinuation(FSLPromiseLatencyContinuation const *continuation) {
+  FSLPromiseLatencyRecord(FSLPromiseLatencyMetricRun, continuation->key, continuation->startTime);
+  gFSLPromiseLatencyContext = continuation->previousContext;
+}
+
+@interface FSLPromiseLatencyHistogram ()
+
+- (instancetype)initWithMetric:(FSLPromiseLatencyMetric)metric
+                    combinator:(nullable NSString *)combinator
+                         label:(nullable NSString *)label
+                        counts:(FSLPromiseLatencyCounts const *)counts NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation FSLPromiseLatencyHistogram {
+  uint64_t _buckets[FSLPromiseLatencyBucketsCount];
+}
+
+- (instancetype)initWithMetric:(FSLPromiseLatencyMetric)metric
+                    combinator:(nullable NSString *)combinator
+                         label:(nullable NSString *)label
+                        counts:(FSLPromiseLatencyCounts const *)counts {
+  self = [super init];
+  if (self) {
+    _metric = metric;
+    _combinator = [combinator copy];
+    _label = [label copy];
+    _count = atomic_load_explicit(&counts->count, memory_order_relaxed);
+    _totalInterval =
+        (NSTimeInterval)atomic_load_explicit(&counts->sum, memory_order_relaxed) / NSEC_PER_SEC;
+    for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+      _buckets[i] = atomic_load_explicit(&counts->buckets[i], memory_order_relaxed);
+    }
+  }
+  return self;
+}
+
+- (NSTimeInterval)intervalAtPercentile:(double)percentile {
+  uint64_t total = 0;
+  for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+    total += _buckets[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  // The total may differ from `count` slightly, since threads keep recording while merging.
+  uint64_t const rank = MAX((uint64_t)ceil(MIN(MAX(percentile, 0), 100) / 100 * total), 1u);
+  uint64_t cumulativeCount = 0;
+  for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+    cumulativeCount += _buckets[i];
+    if (cumulativeCount >= rank) {
+      return (NSTimeInterval)FSLPromiseLatencyBucketLowerBound(i + 1) / NSEC_PER_SEC;
+    }
+  }
+  return (NSTimeInterval)FSLPromiseLatencyBucketLowerBound(FSLPromiseLatencyBucketsCount) /
+         NSEC_PER_SEC;
+}
+
+- (void)enumerateBucketsUsingBlock:(void (^)(NSTimeInterval lowerBound, NSTimeInterval upperBound,
+                                             uint64_t count))block {
+  NSParameterAssert(block);
+
+  for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+    if (_buckets[i]) {
+      block((NSTimeInterval)FSLPromiseLatencyBucketLowerBound(i) / NSEC_PER_SEC,
+            (NSTimeInterval)FSLPromiseLatencyBucketLowerBound(i + 1) / NSEC_PER_SEC, _buckets[i]);
+    }
+  }
+}
+
+- (NSString *)description {
+  static NSString *const metricNames[] = {@"pending", @"queue wait", @"run"};
+  return [NSString stringWithFormat:@"<%@ %p> %@ %@%@%@: count %llu, p50 %.6fs, p99 %.6fs",
+                                    NSStringFromClass([self class]), self,
+                                    metricNames[self.metric], self.combinator ?: @"-",
+                                    self.label ? @" " : @"", self.label ?: @"",
+                                    (unsigned long long)self.count,
+                                    [self intervalAtPercentile:50], [self intervalAtPercentile:99]];
+}
+
+@end
+
+@implementation FSLPromiseLatencyHistograms
+
++ (BOOL)isEnabled {
+  return FSLPromiseLatencyIsEnabled();
+}
+
++ (void)setEnabled:(BOOL)enabled {
+  atomic_store_explicit(&gFSLPromiseLatencyEnabled, enabled, memory_order_relaxed);
+}
+
++ (void)performWithLabel:(NSString *)label work:(NS_NOESCAPE void (^)(void))work {
+  NSParameterAssert(label);
+  NSParameterAssert(work);
+
+  if (!FSLPromiseLatencyIsEnabled()) {
+    work();
+    return;
+  }
+  uint16_t const context = gFSLPromiseLatencyContext;
+  gFSLPromiseLatencyContext = (uint16_t)((context & 0xFF00) | FSLPromiseLatencyLabelIndex(label));
+  work();
+  gFSLPromiseLatencyContext = context;
+}
+
++ (NSArray<FSLPromiseLatencyHistogram *> *)snapshot {
+  NSMutableArray<FSLPromiseLatencyHistogram *> *histograms = [[NSMutableArray alloc] init];
+  FSLPromiseLatencyCounts *merged = malloc(sizeof(*merged));
+  pthread_mutex_lock(&gFSLPromiseLatencyMutex);
+  for (uint16_t key = 1; key < gFSLPromiseLatencyKeysCount; ++key) {
+    for (NSUInteger metric = 0; metric < FSLPromiseLatencyMetricsCount; ++metric) {
+      memset(merged, 0, sizeof(*merged));
+      FSLPromiseLatencyMerge(key, metric, merged);
+      FSLPromiseLatencyCounts *baseline = gFSLPromiseLatencyBaseline[key][metric];
+      if (baseline) {
+        FSLPromiseLatencySubtract(&merged->count, &baseline->count);
+        FSLPromiseLatencySubtract(&merged->sum, &baseline->sum);
+        for (NSUInteger i = 0; i < FSLPromiseLatencyBucketsCount; ++i) {
+          FSLPromiseLatencySubtract(&merged->buckets[i], &baseline->buckets[i]);
+        }
+      }
+      if (atomic_load_explicit(&merged->count, memory_order_relaxed) == 0) {
+        continue;
+      }
+      uint8_t const combinator = gFSLPromiseLatencyKeyCombinators[key];
+      uint8_t const label = gFSLPromiseLatencyKeyLabels[key];
+      char const *combinatorName = atomic_load_explicit(
+          &gFSLPromiseLatencyCombinators[combinator], memory_order_relaxed);
+      [histograms addObject:[[FSLPromiseLatencyHistogram alloc]
+                                initWithMetric:(FSLPromiseLatencyMetric)metric
+                                    combinator:combinator ? @(combinatorName) : nil
+                                         label:label ? gFSLPromiseLatencyLabels[label] : nil
+                                        counts:merged]];
+    }
+  }
+  pthread_mutex_unlock(&gFSLPromiseLatencyMutex);
+  free(merged);
+  return histograms;
+}
+
++ (void)reset {
+  pthread_mutex_lock(&gFSLPromiseLatencyMutex);
+  for (uint16_t key = 1; key < gFSLPromiseLatencyKeysCount; ++key) {
+    for (NSUInteger metric = 0; metric < FSLPromiseLatencyMetricsCount; ++metric) {
+      FSLPromiseLatencyCounts *baseline = gFSLPromiseLatencyBaseline[key][metric];
+      if (!baseline) {
+        baseline = malloc(sizeof(*baseline));
+        gFSLPromiseLatencyBaseline[key][metric] = baseline;
+      }
+      memset(baseline, 0, sizeof(*baseline));
+      FSLPromiseLatencyMerge(key, metric, baseline);
+    }
+  }
+  pthread_mutex_unlock(&gFSLPromiseLatencyMutex);
+}
+
+@end
@@ -0,0 +1,404 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseLeakDetector.h"
+
+#import "FSLPromisePrivate.h"
+
+#import <execinfo.h>
+#import <objc/runtime.h>
+#import <pthread.h>
+#import <stdatomic.h>
+#import <string.h>
+#import <time.h>
+
+/** Number of independently locked parts of the registry. Must be a power of two. */
+static NSUInteger const FSLPromiseLeakDetectorShardsCount = 16;
+
+/** Number of slots a shard starts with once used. Must be a power of two. */
+static NSUInteger const FSLPromiseLeakDetectorInitialShardCapacity = 64;
+
+/** Max number of frames of a sampled creation call stack. */
+static int const FSLPromiseLeakDetectorMaxFramesCount = 32;
+
+/** Number of latest promises deallocated while pending to keep. */
+static NSUInteger const FSLPromiseLeakDetectorMaxDeallocatedCount = 1024;
+
+/** Sampled creation call stack. */
+typedef struct {
+  int count;
+  void *frames[];
+} FSLPromiseLeakDetectorCallStack;
+
+/** Slot of the registry, which is free if `address` is zero. */
+typedef struct {
+  uintptr_t address;
+  __unsafe_unretained Class promiseClass;
+  uint64_t creationTime;
+  /** Time the promise was deallocated at, once it has been. */
+  uint64_t deallocationTime;
+  FSLPromiseLeakDetectorCallStack *__nullable callStack;
+} FSLPromiseLeakDetectorEntry;
+
+/**
+ Open addressing hash table with linear probing, padded to a cache line to keep the shards from
+ sharing one.
+ */
+typedef struct {
+  pthread_mutex_t mutex;
+  FSLPromiseLeakDetectorEntry *__nullable entries;
+  NSUInteger capacity;
+  NSUInteger count;
+} __attribute__((aligned(64))) FSLPromiseLeakDetectorShard;
+
+static FSLPromiseLeakDetectorShard gFSLPromiseLeakDetectorShards[FSLPromiseLeakDetectorShardsCount];
+
+static atomic_bool gFSLPromiseLeakDetectorEnabled;
+
+static _Atomic(NSUInteger) gFSLPromiseLeakDetectorCallStackSamplingInterval = 100;
+
+/** Number of promises tracked on the current thread since the last sampled one. */
+static _Thread_local NSUInteger gFSLPromiseLeakDetectorUnsampledCount;
+
+/** Ring buffer of the latest promises deallocated while pending. */
+static FSLPromiseLeakDetectorEntry
+    gFSLPromiseLeakDetectorDeallocated[FSLPromiseLeakDetectorMaxDeallocatedCount];
+static NSUInteger gFSLPromiseLeakDetectorDeallocatedStart;
+static NSUInteger gFSLPromiseLeakDetectorDeallocatedCount;
+static pthread_mutex_t gFSLPromiseLeakDetectorDeallocatedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t FSLPromiseLeakDetectorNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+static void FSLPromiseLeakDetectorSetUp(void) {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    for (NSUInteger i = 0; i < FSLPromiseLeakDetectorShardsCount; ++i) {
+      pthread_mutex_init(&gFSLPromiseLeakDetectorShards[i].mutex, NULL);
+    }
+  });
+}
+
+/** Spreads the addresses, which are aligned and allocated close to each other, over 64 bits. */
+static uint64_t FSLPromiseLeakDetectorHash(uintptr_t address) {
+  return (uint64_t)(address >> 4) * 0x9E3779B97F4A7C15ull;
+}
+
+static FSLPromiseLeakDetectorShard *FSLPromiseLeakDetectorShardForAddress(uintptr_t address) {
+  uint64_t const hash = FSLPromiseLeakDetectorHash(address);
+  return &gFSLPromiseLeakDetectorShards[hash >> 60 & (FSLPromiseLeakDetectorShardsCount - 1)];
+}
+
+static NSUInteger FSLPromiseLeakDetectorSlot(FSLPromiseLeakDetectorShard *shard,
+                                             uintptr_t address) {
+  return (NSUInteger)(FSLPromiseLeakDetectorHash(address) >> 20) & (shard->capacity - 1);
+}
+
+/** Places an entry in a free slot of the shard, which must have one. */
+static void FSLPromiseLeakDetectorPlace(FSLPromiseLeakDetectorShard *shard,
+                                        FSLPromiseLeakDetectorEntry entry) {
+  NSUInteger slot = FSLPromiseLeakDetectorSlot(shard, entry.address);
+  while (shard->entries[slot].address) {
+    slot = (slot + 1) & (shard->capacity - 1);
+  }
+  shard->entries[slot] = entry;
+}
+
+/** Adds an entry to the shard, growing it to keep it at most half full. */
+static void FSLPromiseLeakDetectorInsert(FSLPromiseLeakDetectorShard *shard,
+                                         FSLPromiseLeakDetectorEntry entry) {
+  if ((shard->count + 1) * 2 > shard->capacity) {
+    FSLPromiseLeakDetectorEntry *entries = shard->entries;
+    NSUInteger const capacity = shard->capacity;
+    shard->capacity = capacity ? capacity * 2 : FSLPromiseLeakDetectorInitialShardCapacity;
+    shard->entries = calloc(shard->capacity, sizeof(*shard->entries));
+    for (NSUInteger i = 0; i < capacity; ++i) {
+      if (entries[i].address) {
+        FSLPromiseLeakDetectorPlace(shard, entries[i]);
+      }
+    }
+    free(entries);
+  }
+  FSLPromiseLeakDetectorPlace(shard, entry);
+  ++shard->count;
+}
+
+/**
+ Removes the entry for `address` from the shard, shifting the entries probed past it back to keep
+ the probe sequences intact without tombstones.
+
+ @return Whether the shard had the entry.
+ */
+static BOOL FSLPromiseLeakDetectorRemove(FSLPromiseLeakDetectorShard *shard, uintptr_t address,
+                                         FSLPromiseLeakDetectorEntry *removedEntry) {
+  if (shard->count == 0) {
+    return NO;
+  }
+  NSUInteger const mask = shard->capacity - 1;
+  NSUInteger slot = FSLPromiseLeakDetectorSlot(shard, address);
+  while (shard->entries[slot].address != address) {
+    if (!shard->entries[slot].address) {
+      return NO;
+    }
+    slot = (slot + 1) & mask;
+  }
+  *removedEntry = shard->entries[slot];
+  for (NSUInteger next = (slot + 1) & mask; shard->entries[next].address;
+       next = (next + 1) & mask) {
+    NSUInteger const home = FSLPromiseLeakDetectorSlot(shard, shard->entries[next].address);
+    // Move the entry into the hole unless its home slot lies cyclically in (slot, next].
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      shard->entries[slot] = shard->entries[next];
+      slot = next;
+    }
+  }
+  shard->entries[slot] = (FSLPromiseLeakDetectorEntry){0};
+  --shard->count;
+  return YES;
+}
+
+BOOL FSLPromiseLeakDetectorTrack(void const *promise) {
+  if (!atomic_load_explicit(&gFSLPromiseLeakDetectorEnabled, memory_order_relaxed)) {
+    return NO;
+  }
+  FSLPromiseLeakDetectorEntry entry = {
+      .address = (uintptr_t)promise,
+      .promiseClass = object_getClass((__bridge id)promise),
+      .creationTime = FSLPromiseLeakDetectorNow(),
+  };
+  NSUInteger const samplingInterval = atomic_load_explicit(
+      &gFSLPromiseLeakDetectorCallStackSamplingInterval, memory_order_relaxed);
+  if (samplingInterval && ++gFSLPromiseLeakDetectorUnsampledCount >= samplingInterval) {
+    gFSLPromiseLeakDetectorUnsampledCount = 0;
+    void *frames[FSLPromiseLeakDetectorMaxFramesCount + 1];
+    // Skip the frame of this function.
+    int const count = backtrace(frames, FSLPromiseLeakDetectorMaxFramesCount + 1) - 1;
+    if (count > 0) {
+      entry.callStack = malloc(sizeof(*entry.callStack) + sizeof(void *) * (size_t)count);
+      entry.callStack->count = count;
+      memcpy(entry.callStack->frames, frames + 1, sizeof(void *) * (size_t)count);
+    }
+  }
+  FSLPromiseLeakDetectorShard *shard = FSLPromiseLeakDetectorShardForAddress(entry.address);
+  pthread_mutex_lock(&shard->mutex);
+  FSLPromiseLeakDetectorInsert(shard, entry);
+  pthread_mutex_unlock(&shard->mutex);
+  return YES;
+}
+
+void FSLPromiseLeakDetectorUntrack(void const *promise, BOOL deallocated) {
+  FSLPromiseLeakDetectorEntry entry;
+  FSLPromiseLeakDetectorShard *shard = FSLPromiseLeakDetectorShardForAddress((uintptr_t)promise);
+  pthread_mutex_lock(&shard->mutex);
+  BOOL const removed = FSLPromiseLeakDetectorRemove(shard, (uintptr_t)promise, &entry);
+  pthread_mutex_unlock(&shard->mutex);
+  if (!removed) {
+    // Forgotten by a reset.
+    return;
+  }
+  if (!deallocated) {
+    free(entry.callStack);
+    return;
+  }
+  entry.deallocationTime = FSLPromiseLeakDetectorNow();
+  FSLPromiseLeakDetectorCallStack *droppedCallStack = NULL;
+  pthread_mutex_lock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+  NSUInteger const index = (gFSLPromiseLeakDetectorDeallocatedStart +
+                            gFSLPromiseLeakDetectorDeallocatedCount) %
+                           FSLPromiseLeakDetectorMaxDeallocatedCount;
+  if (gFSLPromiseLeakDetectorDeallocatedCount == FSLPromiseLeakDetectorMaxDeallocatedCount) {
+    // Overwrite the oldest one.
+    droppedCallStack = gFSLPromiseLeakDetectorDeallocated[index].callStack;
+    gFSLPromiseLeakDetectorDeallocatedStart =
+        (gFSLPromiseLeakDetectorDeallocatedStart + 1) % FSLPromiseLeakDetectorMaxDeallocatedCount;
+  } else {
+    ++gFSLPromiseLeakDetectorDeallocatedCount;
+  }
+  gFSLPromiseLeakDetectorDeallocated[index] = entry;
+  pthread_mutex_unlock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+  free(droppedCallStack);
+}
+
+@interface FSLPromiseLeak ()
+
+- (instancetype)initWithEntry:(FSLPromiseLeakDetectorEntry const *)entry
+              pendingInterval:(uint64_t)pendingInterval NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation FSLPromiseLeak {
+  /** Copy of the sampled creation call stack, if any. */
+  FSLPromiseLeakDetectorCallStack *_callStack;
+}
+
+- (instancetype)initWithEntry:(FSLPromiseLeakDetectorEntry const *)entry
+              pendingInterval:(uint64_t)pendingInterval {
+  self = [super init];
+  if (self) {
+    _address = entry->address;
+    _promiseClass = entry->promiseClass;
+    _pendingInterval = (NSTimeInterval)pendingInterval / NSEC_PER_SEC;
+    _deallocated = entry->deallocationTime != 0;
+    if (entry->callStack) {
+      size_t const size =
+          sizeof(*entry->callStack) + sizeof(void *) * (size_t)entry->callStack->count;
+      _callStack = malloc(size);
+      memcpy(_callStack, entry->callStack, size);
+    }
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_callStack);
+}
+
+- (nullable NSArray<NSString *> *)creationCallStackSymbols {
+  if (!_callStack) {
+    return nil;
+  }
+  char **symbols = backtrace_symbols(_callStack->frames, _callStack->count);
+  if (!symbols) {
+    return nil;
+  }
+  NSMutableArray<NSString *> *callStackSymbols =
+      [[NSMutableArray alloc] initWithCapacity:(NSUInteger)_callStack->count];
+  for (int i = 0; i < _callStack->count; ++i) {
+    [callStackSymbols addObject:@(symbols[i])];
+  }
+  free(symbols);
+  return callStackSymbols;
+}
+
+- (NSString *)description {
+  NSString *description = [NSString
+      stringWithFormat:@"<%@ %p> %@ %#lx %@ for %.3fs", NSStringFromClass([self class]), self,
+                       NSStringFromClass(self.promiseClass), (unsigned long)self.address,
+                       self.isDeallocated ? @"deallocated after pending" : @"pending",
+                       self.pendingInterval];
+  NSArray<NSString *> *callStackSymbols = self.creationCallStackSymbols;
+  if (callStackSymbols) {
+    description = [description
+        stringByAppendingFormat:@", created at:\n%@",
+                                [callStackSymbols componentsJoinedByString:@"\n"]];
+  }
+  return description;
+}
+
+@end
+
+@implementation FSLPromiseLeakDetector
+
++ (BOOL)isEnabled {
+  return atomic_load_explicit(&gFSLPromiseLeakDetectorEnabled, memory_order_relaxed);
+}
+
++ (void)setEnabled:(BOOL)enabled {
+  FSLPromiseLeakDetectorSetUp();
+  atomic_store_explicit(&gFSLPromiseLeakDetectorEnabled, enabled, memory_order_release);
+}
+
++ (NSUInteger)callStackSamplingInterval {
+  return atomic_load_explicit(&gFSLPromiseLeakDetectorCallStackSamplingInterval,
+                              memory_order_relaxed);
+}
+
++ (void)setCallStackSamplingInterval:(NSUInteger)interval {
+  atomic_store_explicit(&gFSLPromiseLeakDetectorCallStackSamplingInterval, interval,
+                        memory_order_relaxed);
+}
+
++ (NSUInteger)pendingPromisesCount {
+  FSLPromiseLeakDetectorSetUp();
+  NSUInteger count = 0;
+  for (NSUInteger i = 0; i < FSLPromiseLeakDetectorShardsCount; ++i) {
+    FSLPromiseLeakDetectorShard *shard = &gFSLPromiseLeakDetectorShards[i];
+    pthread_mutex_lock(&shard->mutex);
+    count += shard->count;
+    pthread_mutex_unlock(&shard->mutex);
+  }
+  return count;
+}
+
++ (NSArray<FSLPromiseLeak *> *)pendingPromisesOlderThan:(NSTimeInterval)interval {
+  FSLPromiseLeakDetectorSetUp();
+  uint64_t const minPendingInterval = (uint64_t)(MAX(interval, 0) * NSEC_PER_SEC);
+  NSMutableArray<FSLPromiseLeak *> *leaks = [[NSMutableArray alloc] init];
+  // Lock one shard at a time, so that promises keep getting created and resolved meanwhile.
+  for (NSUInteger i = 0; i < FSLPromiseLeakDetectorShardsCount; ++i) {
+    FSLPromiseLeakDetectorShard *shard = &gFSLPromiseLeakDetectorShards[i];
+    pthread_mutex_lock(&shard->mutex);
+    uint64_t const now = FSLPromiseLeakDetectorNow();
+    for (NSUInteger slot = 0; slot < shard->capacity; ++slot) {
+      FSLPromiseLeakDetectorEntry const *entry = &shard->entries[slot];
+      if (entry->address && now - entry->creationTime >= minPendingInterval) {
+        [leaks addObject:[[FSLPromiseLeak alloc] initWithEntry:entry
+                                               pendingInterval:now - entry->creationTime]];
+      }
+    }
+    pthread_mutex_unlock(&shard->mutex);
+  }
+  [leaks sortUsingComparator:^NSComparisonResult(FSLPromiseLeak *lhs, FSLPromiseLeak *rhs) {
+    return [@(rhs.pendingInterval) compare:@(lhs.pendingInterval)];
+  }];
+  return leaks;
+}
+
++ (NSArray<FSLPromiseLeak *> *)deallocatedPendingPromises {
+  NSMutableArray<FSLPromiseLeak *> *leaks = [[NSMutableArray alloc] init];
+  pthread_mutex_lock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+  for (NSUInteger i = 0; i < gFSLPromiseLeakDetectorDeallocatedCount; ++i) {
+    FSLPromiseLeakDetectorEntry const *entry =
+        &gFSLPromiseLeakDetectorDeallocated[(gFSLPromiseLeakDetectorDeallocatedStart + i) %
+                                            FSLPromiseLeakDetectorMaxDeallocatedCount];
+    [leaks addObject:[[FSLPromiseLeak alloc]
+                         initWithEntry:entry
+                       pendingInterval:entry->deallocationTime - entry->creationTime]];
+  }
+  pthread_mutex_unlock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+  return leaks;
+}
+
++ (void)reset {
+  FSLPromiseLeakDetectorSetUp();
+  for (NSUInteger i = 0; i < FSLPromiseLeakDetectorShardsCount; ++i) {
+    FSLPromiseLeakDetectorShard *shard = &gFSLPromiseLeakDetectorShards[i];
+    pthread_mutex_lock(&shard->mutex);
+    for (NSUInteger slot = 0; slot < shard->capacity; ++slot) {
+      free(shard->entries[slot].callStack);
+    }
+    free(shard->entries);
+    shard->entries = NULL;
+    shard->capacity = 0;
+    shard->count = 0;
+    pthread_mutex_unlock(&shard->mutex);
+  }
+  pthread_mutex_lock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+  for (NSUInteger i = 0; i < gFSLPromiseLeakDetectorDeallocatedCount; ++i) {
+    free(gFSLPromiseLeakDetectorDeallocated[(gFSLPromiseLeakDetectorDeallocatedStart + i) %
+                                            FSLPromiseLeakDetectorMaxDeallocatedCount]
+             .callStack);
+  }
+  gFSLPromiseLeakDetectorDeallocatedStart = 0;
+  gFSLPromiseLeakDetectorDeallocatedCount = 0;
+  pthread_mutex_unlock(&gFSLPromiseLeakDetectorDeallocatedMutex);
+}
+
+@end
@@ -0,0 +1,79 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseResults.h"
+
+#import <stdatomic.h>
+
+@implementation FSLPromiseResults {
+  id __strong *_objects;
+  atomic_size_t _remainingCount;
+  atomic_size_t _errorsCount;
+}
+
+- (instancetype)initWithCount:(NSUInteger)count {
+  self = [super init];
+  if (self) {
+    _count = count;
+    _objects = (id __strong *)calloc(MAX(count, 1), sizeof(id));
+    atomic_init(&_remainingCount, count);
+    atomic_init(&_errorsCount, 0);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  for (NSUInteger i = 0; i < _count; ++i) {
+    _objects[i] = nil;
+  }
+  free(_objects);
+}
+
+- (NSUInteger)errorsCount {
+  return atomic_load_explicit(&_errorsCount, memory_order_relaxed);
+}
+
+- (NSArray *)array {
+  NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:_count];
+  for (NSUInteger i = 0; i < _count; ++i) {
+    [array addObject:_objects[i] ?: [NSNull null]];
+  }
+  return array;
+}
+
+- (nullable id)objectAtIndex:(NSUInteger)index {
+  NSParameterAssert(index < _count);
+
+  return _objects[index];
+}
+
+- (BOOL)setObject:(nullable id)object atIndex:(NSUInteger)index {
+  NSParameterAssert(index < _count);
+
+  _objects[index] = object;
+  // Publishes the result to whoever sets the last one.
+  return atomic_fetch_sub_explicit(&_remainingCount, 1, memory_order_acq_rel) == 1;
+}
+
+- (BOOL)setError:(NSError *)error atIndex:(NSUInteger)index {
+  NSParameterAssert(error);
+
+  atomic_fetch_add_explicit(&_errorsCount, 1, memory_order_relaxed);
+  return [self setObject:error atIndex:index];
+}
+
+@end
@@ -0,0 +1,68 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseRetryBudget.h"
+
+#import <stdatomic.h>
+
+/** Tokens are counted in fixed point, for the bucket to be updated with a single atomic. */
+static int64_t const FSLPromiseRetryBudgetTokenScale = 1000;
+
+@implementation FSLPromiseRetryBudget {
+  _Atomic(int64_t) _scaledTokens;
+  int64_t _scaledMaxTokens;
+  int64_t _scaledTokenRatio;
+}
+
+- (instancetype)initWithMaxTokens:(NSUInteger)maxTokens tokenRatio:(double)tokenRatio {
+  self = [super init];
+  if (self) {
+    _maxTokens = MAX(maxTokens, (NSUInteger)1);
+    _tokenRatio = MAX(tokenRatio, 0);
+    _scaledMaxTokens = (int64_t)_maxTokens * FSLPromiseRetryBudgetTokenScale;
+    _scaledTokenRatio = (int64_t)(_tokenRatio * FSLPromiseRetryBudgetTokenScale);
+    atomic_init(&_scaledTokens, _scaledMaxTokens);
+  }
+  return self;
+}
+
+- (double)tokens {
+  return (double)atomic_load_explicit(&_scaledTokens, memory_order_relaxed) /
+         FSLPromiseRetryBudgetTokenScale;
+}
+
+- (void)recordSuccess {
+  int64_t tokens = atomic_load_explicit(&_scaledTokens, memory_order_relaxed);
+  while (tokens < _scaledMaxTokens &&
+         !atomic_compare_exchange_weak_explicit(&_scaledTokens, &tokens,
+                                                MIN(tokens + _scaledTokenRatio, _scaledMaxTokens),
+                                                memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+- (BOOL)recordFailure {
+  int64_t tokens = atomic_load_explicit(&_scaledTokens, memory_order_relaxed);
+  int64_t newTokens;
+  do {
+    newTokens = MAX(tokens - FSLPromiseRetryBudgetTokenScale, 0);
+  } while (newTokens != tokens &&
+           !atomic_compare_exchange_weak_explicit(&_scaledTokens, &tokens, newTokens,
+                                                  memory_order_relaxed, memory_order_relaxed));
+  return newTokens * 2 > _scaledMaxTokens;
+}
+
+@end
@@ -0,0 +1,233 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// For pthread_setaffinity_np().
+#define _GNU_SOURCE
+#endif
+
+#import "FSLPromiseShardedExecutor.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+#if defined(__linux__)
+#import <sched.h>
+#endif
+
+/** Block passed to a shard. */
+typedef struct FSLPromiseShardEntry {
+  struct FSLPromiseShardEntry *next;
+  void *block;
+} FSLPromiseShardEntry;
+
+/**
+ State shared by a shard executor and its thread, which outlives the executor until the thread
+ exits.
+ */
+typedef struct {
+  /** Guards all the fields below but the references count. */
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+  /** Blocks to invoke, in order. */
+  FSLPromiseShardEntry *head;
+  FSLPromiseShardEntry *tail;
+  /** Whether the executor got deallocated. */
+  BOOL isStopping;
+  /** One for the thread, plus one for the executor. */
+  _Atomic(NSUInteger) referencesCount;
+  NSUInteger index;
+  BOOL isPinned;
+} FSLPromiseShardState;
+
+static void FSLPromiseShardRelease(FSLPromiseShardState *shard) {
+  if (atomic_fetch_sub_explicit(&shard->referencesCount, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+  pthread_cond_destroy(&shard->condition);
+  pthread_mutex_destroy(&shard->mutex);
+  free(shard);
+}
+
+/**
+ Pins the current thread to the processor at `index`, modulo the number of processors it is
+ allowed to run on.
+ */
+static void FSLPromiseShardPinCurrentThread(NSUInteger index) {
+#if defined(__linux__)
+  cpu_set_t allowedProcessors;
+  if (sched_getaffinity(0, sizeof(allowedProcessors), &allowedProcessors) != 0) {
+    return;
+  }
+  int const count = CPU_COUNT(&allowedProcessors);
+  if (count == 0) {
+    return;
+  }
+  NSUInteger position = index % (NSUInteger)count;
+  for (int processor = 0; processor < CPU_SETSIZE; ++processor) {
+    if (CPU_ISSET(processor, &allowedProcessors) && position-- == 0) {
+      cpu_set_t processors;
+      CPU_ZERO(&processors);
+      CPU_SET(processor, &processors);
+      pthread_setaffinity_np(pthread_self(), sizeof(processors), &processors);
+      return;
+    }
+  }
+#endif
+}
+
+static void *FSLPromiseShardMain(void *context) {
+  FSLPromiseShardState *shard = context;
+  if (shard->isPinned) {
+    FSLPromiseShardPinCurrentThread(shard->index);
+  }
+  @autoreleasepool {
+    NSThread.currentThread.name =
+        [NSString stringWithFormat:@"com.google.FSLPromises.ShardedExecutor.%lu",
+                                   (unsigned long)shard->index];
+  }
+  while (YES) {
+    pthread_mutex_lock(&shard->mutex);
+    while (!shard->head && !shard->isStopping) {
+      pthread_cond_wait(&shard->condition, &shard->mutex);
+    }
+    // Take all the blocks at once, to lock once per batch rather than once per block.
+    FSLPromiseShardEntry *entry = shard->head;
+    shard->head = shard->tail = NULL;
+    pthread_mutex_unlock(&shard->mutex);
+    if (!entry) {
+      break;
+    }
+    while (entry) {
+      FSLPromiseShardEntry *next = entry->next;
+      @autoreleasepool {
+        ((__bridge_transfer dispatch_block_t)entry->block)();
+      }
+      free(entry);
+      entry = next;
+    }
+  }
+  FSLPromiseShardRelease(shard);
+  return NULL;
+}
+
+/** Serial executor running blocks in order on a thread of its own. */
+@interface FSLPromiseShardExecutor : NSObject <FSLPromiseExecutor>
+
+- (instancetype)initWithIndex:(NSUInteger)index
+                     isPinned:(BOOL)isPinned NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+@implementation FSLPromiseShardExecutor {
+  FSLPromiseShardState *_shard;
+}
+
+- (instancetype)initWithIndex:(NSUInteger)index isPinned:(BOOL)isPinned {
+  self = [super init];
+  if (self) {
+    _shard = calloc(1, sizeof(*_shard));
+    pthread_mutex_init(&_shard->mutex, NULL);
+    pthread_cond_init(&_shard->condition, NULL);
+    atomic_init(&_shard->referencesCount, 2);
+    _shard->index = index;
+    _shard->isPinned = isPinned;
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    int const __unused error = pthread_create(&thread, &attributes, FSLPromiseShardMain, _shard);
+    NSAssert(error == 0, @"Failed to create a thread: %d", error);
+    pthread_attr_destroy(&attributes);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  pthread_mutex_lock(&_shard->mutex);
+  _shard->isStopping = YES;
+  pthread_cond_signal(&_shard->condition);
+  pthread_mutex_unlock(&_shard->mutex);
+  FSLPromiseShardRelease(_shard);
+}
+
+- (void)executeBlock:(dispatch_block_t)block {
+  NSParameterAssert(block);
+
+  FSLPromiseShardEntry *entry = malloc(sizeof(*entry));
+  *entry = (FSLPromiseShardEntry){.block = (__bridge_retained void *)[block copy]};
+  pthread_mutex_lock(&_shard->mutex);
+  if (_shard->tail) {
+    _shard->tail->next = entry;
+  } else {
+    _shard->head = entry;
+    pthread_cond_signal(&_shard->condition);
+  }
+  _shard->tail = entry;
+  pthread_mutex_unlock(&_shard->mutex);
+}
+
+@end
+
+@implementation FSLPromiseShardedExecutor {
+  NSArray<FSLPromiseShardExecutor *> *_shards;
+}
+
+- (instancetype)init {
+  return [self initWithShardsCount:NSProcessInfo.processInfo.activeProcessorCount
+            pinsShardsToProcessors:NO];
+}
+
+- (instancetype)initWithShardsCount:(NSUInteger)shardsCount
+             pinsShardsToProcessors:(BOOL)pinsShardsToProcessors {
+  NSParameterAssert(shardsCount > 0);
+
+  self = [super init];
+  if (self) {
+    _shardsCount = shardsCount;
+    _pinsShardsToProcessors = pinsShardsToProcessors;
+    NSMutableArray<FSLPromiseShardExecutor *> *shards =
+        [[NSMutableArray alloc] initWithCapacity:shardsCount];
+    for (NSUInteger i = 0; i < shardsCount; ++i) {
+      [shards addObject:[[FSLPromiseShardExecutor alloc] initWithIndex:i
+                                                              isPinned:pinsShardsToProcessors]];
+    }
+    _shards = [shards copy];
+  }
+  return self;
+}
+
+- (NSUInteger)shardIndexForKey:(id<NSObject>)key {
+  NSParameterAssert(key);
+
+  // Hashes of common keys, e.g. of numbers, are far from uniform, so scramble them first, and then
+  // map the upper bits to a shard without a division.
+  uint64_t const hash = ((uint64_t)key.hash * 0x9e3779b97f4a7c15ull) >> 32;
+  return (NSUInteger)((hash * _shardsCount) >> 32);
+}
+
+- (id<FSLPromiseExecutor>)executorForKey:(id<NSObject>)key {
+  return _shards[[self shardIndexForKey:key]];
+}
+
+- (void)executeBlock:(dispatch_block_t)block forKey:(id<NSObject>)key {
+  [[self executorForKey:key] executeBlock:block];
+}
+
+@end
@@ -0,0 +1,245 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseTimerWheel.h"
+
+#import <pthread.h>
+#import <time.h>
+
+static NSUInteger const FSLPromiseTimerWheelDefaultSlotsCount = 1024;
+
+/**
+ Returns the current time of a monotonic clock in nanoseconds.
+ */
+static uint64_t FSLPromiseTimerWheelNow(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * NSEC_PER_SEC + (uint64_t)time.tv_nsec;
+}
+
+@interface FSLPromiseTimer () {
+ @package
+  // All guarded by the lock of the wheel.
+  /** Block to dispatch, released once the timer fires or gets cancelled. */
+  dispatch_block_t __nullable _block;
+  dispatch_queue_t __nullable _queue;
+  /** Number of times the cursor has yet to pass the slot before the timer expires. */
+  uint64_t _rounds;
+  /** Slot the timer is linked into, or `NSNotFound` once removed from the wheel. */
+  NSUInteger _slot;
+  /** Neighbours within the slot, retained by the wheel. */
+  FSLPromiseTimer *__unsafe_unretained __nullable _previous;
+  FSLPromiseTimer *__unsafe_unretained __nullable _next;
+}
+
+/** Wheel the timer is scheduled on. */
+@property(nonatomic, readonly) FSLPromiseTimerWheel *wheel;
+
+- (instancetype)initWithWheel:(FSLPromiseTimerWheel *)wheel
+                        queue:(dispatch_queue_t)queue
+                        block:(dispatch_block_t)block NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@interface FSLPromiseTimerWheel ()
+
+/**
+ Removes a timer from the wheel, unless it has fired already.
+ */
+- (void)cancelTimer:(FSLPromiseTimer *)timer;
+
+@end
+
+@implementation FSLPromiseTimer
+
+- (instancetype)initWithWheel:(FSLPromiseTimerWheel *)wheel
+                        queue:(dispatch_queue_t)queue
+                        block:(dispatch_block_t)block {
+  self = [super init];
+  if (self) {
+    _wheel = wheel;
+    _queue = queue;
+    _block = [block copy];
+    _slot = NSNotFound;
+  }
+  return self;
+}
+
+- (void)cancel {
+  [_wheel cancelTimer:self];
+}
+
+@end
+
+@implementation FSLPromiseTimerWheel {
+  pthread_mutex_t _lock;
+  /** Heads of the lists of timers per slot. The wheel retains every timer linked in. */
+  FSLPromiseTimer *__unsafe_unretained __nullable *_slots;
+  NSUInteger _slotsCount;
+  /** Total number of timers linked in. */
+  NSUInteger _timersCount;
+  uint64_t _tickNanoseconds;
+  /** Number of ticks processed since the wheel has been started. */
+  uint64_t _ticks;
+  /** Time the wheel has been started at. */
+  uint64_t _startTime;
+  /** Ticking source, suspended while the wheel is empty. */
+  dispatch_source_t _source;
+  BOOL _isRunning;
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval {
+  return [self initWithTickInterval:tickInterval slotsCount:FSLPromiseTimerWheelDefaultSlotsCount];
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval
+                          slotsCount:(NSUInteger)slotsCount {
+  NSParameterAssert(tickInterval > 0);
+  NSParameterAssert(slotsCount > 0);
+
+  self = [super init];
+  if (self) {
+    pthread_mutex_init(&_lock, NULL);
+    _tickInterval = tickInterval;
+    _tickNanoseconds = MAX((uint64_t)(tickInterval * NSEC_PER_SEC), 1);
+    _slotsCount = slotsCount;
+    _slots = (FSLPromiseTimer *__unsafe_unretained *)calloc(slotsCount, sizeof(id));
+    dispatch_queue_t queue =
+        dispatch_queue_create("com.google.FSLPromises.TimerWheel", DISPATCH_QUEUE_SERIAL);
+    _source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    FSLPromiseTimerWheel __weak *weakSelf = self;
+    dispatch_source_set_event_handler(_source, ^{
+      [weakSelf tick];
+    });
+  }
+  return self;
+}
+
+- (void)dealloc {
+  // Timers retain the wheel, so it's empty by now, and a suspended source can't be released.
+  if (!_isRunning) {
+    dispatch_resume(_source);
+  }
+  dispatch_source_cancel(_source);
+  free(_slots);
+  pthread_mutex_destroy(&_lock);
+}
+
+- (FSLPromiseTimer *)scheduleAfterInterval:(NSTimeInterval)interval
+                                   onQueue:(dispatch_queue_t)queue
+                                     block:(dispatch_block_t)block {
+  NSParameterAssert(queue);
+  NSParameterAssert(block);
+
+  FSLPromiseTimer *timer = [[FSLPromiseTimer alloc] initWithWheel:self queue:queue block:block];
+  uint64_t ticks = (uint64_t)ceil(MAX(interval, 0) * NSEC_PER_SEC / _tickNanoseconds);
+  pthread_mutex_lock(&_lock);
+  if (!_isRunning) {
+    _isRunning = YES;
+    _ticks = 0;
+    _startTime = FSLPromiseTimerWheelNow();
+    dispatch_source_set_timer(_source, dispatch_time(DISPATCH_TIME_NOW, (int64_t)_tickNanoseconds),
+                              _tickNanoseconds, _tickNanoseconds / 10);
+    dispatch_resume(_source);
+  }
+  // The cursor lags behind the clock if the ticks get delayed, so count from the current time.
+  uint64_t elapsedTicks = (FSLPromiseTimerWheelNow() - _startTime) / _tickNanoseconds;
+  uint64_t expiration = MAX(elapsedTicks, _ticks) + MAX(ticks, 1);
+  timer->_rounds = (expiration - _ticks - 1) / _slotsCount;
+  timer->_slot = (NSUInteger)(expiration % _slotsCount);
+  timer->_next = _slots[timer->_slot];
+  if (timer->_next) {
+    timer->_next->_previous = timer;
+  }
+  _slots[timer->_slot] = (__bridge FSLPromiseTimer *)(__bridge_retained void *)timer;
+  ++_timersCount;
+  pthread_mutex_unlock(&_lock);
+  return timer;
+}
+
+- (void)cancelTimer:(FSLPromiseTimer *)timer {
+  dispatch_block_t __unused block;
+  pthread_mutex_lock(&_lock);
+  if (timer->_slot != NSNotFound) {
+    block = timer->_block;
+    timer->_block = nil;
+    [self unlinkTimer:timer];
+  }
+  pthread_mutex_unlock(&_lock);
+  // The block and the timer get released outside of the lock.
+}
+
+#pragma mark - Private
+
+/**
+ Removes a timer from its slot and returns the reference the wheel held. Must be called under lock.
+ */
+- (FSLPromiseTimer *)unlinkTimer:(FSLPromiseTimer *)timer {
+  if (timer->_previous) {
+    timer->_previous->_next = timer->_next;
+  } else {
+    _slots[timer->_slot] = timer->_next;
+  }
+  if (timer->_next) {
+    timer->_next->_previous = timer->_previous;
+  }
+  timer->_previous = timer->_next = nil;
+  timer->_slot = NSNotFound;
+  --_timersCount;
+  return (__bridge_transfer FSLPromiseTimer *)(__bridge void *)timer;
+}
+
+/**
+ Advances the cursor up to the current time and dispatches the blocks of the expired timers.
+ */
+- (void)tick {
+  NSMutableArray<FSLPromiseTimer *> *expiredTimers;
+  pthread_mutex_lock(&_lock);
+  if (!_isRunning) {
+    // A stale tick after the source has been suspended.
+    pthread_mutex_unlock(&_lock);
+    return;
+  }
+  uint64_t elapsedTicks = (FSLPromiseTimerWheelNow() - _startTime) / _tickNanoseconds;
+  while (_ticks < elapsedTicks && _timersCount > 0) {
+    ++_ticks;
+    FSLPromiseTimer *__unsafe_unretained timer = _slots[_ticks % _slotsCount];
+    while (timer) {
+      FSLPromiseTimer *__unsafe_unretained next = timer->_next;
+      if (timer->_rounds == 0) {
+        expiredTimers = expiredTimers ?: [[NSMutableArray alloc] init];
+        [expiredTimers addObject:[self unlinkTimer:timer]];
+      } else {
+        --timer->_rounds;
+      }
+      timer = next;
+    }
+  }
+  if (_timersCount == 0) {
+    _isRunning = NO;
+    dispatch_suspend(_source);
+  }
+  pthread_mutex_unlock(&_lock);
+  // Nobody else touches the unlinked timers anymore.
+  for (FSLPromiseTimer *timer in expiredTimers) {
+    dispatch_async(timer->_queue, timer->_block);
+    timer->_block = nil;
+    timer->_queue = nil;
+  }
+}
+
+@end
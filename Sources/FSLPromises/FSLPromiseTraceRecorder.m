@@ -0,0 +1,293 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseTraceRecorder.h"
+
+#import <unistd.h>
+
+/** Number of events to make room for at a time while unbounded. */
+static NSUInteger const FSLPromiseTraceRecorderInitialCapacity = 1024;
+
+/** An event along with its position in the recording, to keep the order stable when sorting. */
+typedef struct {
+  FSLPromiseInstrumentationEvent event;
+  NSUInteger index;
+} FSLPromiseTraceRecorderEntry;
+
+static int FSLPromiseTraceRecorderCompareEntries(void const *lhs, void const *rhs) {
+  FSLPromiseTraceRecorderEntry const *left = lhs;
+  FSLPromiseTraceRecorderEntry const *right = rhs;
+  if (left->event.timestamp != right->event.timestamp) {
+    return left->event.timestamp < right->event.timestamp ? -1 : 1;
+  }
+  return left->index < right->index ? -1 : left->index > right->index ? 1 : 0;
+}
+
+static NSString *FSLPromiseTraceRecorderID(uintptr_t object) {
+  return [NSString stringWithFormat:@"0x%lx", (unsigned long)object];
+}
+
+static NSString *FSLPromiseTraceRecorderName(char const *__nullable name, NSString *defaultName) {
+  return name && *name ? @(name) : defaultName;
+}
+
+@implementation FSLPromiseTraceRecorder {
+  /** Storage for the events, used as a ring buffer starting at `_start` once full if bounded. */
+  FSLPromiseInstrumentationEvent *_events;
+  NSUInteger _storageCapacity;
+  NSUInteger _start;
+  NSUInteger _eventsCount;
+  NSUInteger _droppedEventsCount;
+}
+
+- (instancetype)init {
+  return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+  self = [super init];
+  if (self) {
+    _capacity = capacity;
+    _storageCapacity = capacity ?: FSLPromiseTraceRecorderInitialCapacity;
+    _events = malloc(_storageCapacity * sizeof(*_events));
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_events);
+}
+
+- (NSUInteger)eventsCount {
+  @synchronized(self) {
+    return _eventsCount;
+  }
+}
+
+- (NSUInteger)droppedEventsCount {
+  @synchronized(self) {
+    return _droppedEventsCount;
+  }
+}
+
+- (void)promiseInstrumentationDidRecordEvents:(FSLPromiseInstrumentationEvent const *)events
+                                        count:(NSUInteger)count {
+  @synchronized(self) {
+    for (NSUInteger i = 0; i < count; ++i) {
+      if (_eventsCount == _storageCapacity) {
+        if (_capacity) {
+          // Overwrite the oldest event.
+          _events[_start] = events[i];
+          _start = (_start + 1) % _storageCapacity;
+          ++_droppedEventsCount;
+          continue;
+        }
+        _storageCapacity *= 2;
+        _events = realloc(_events, _storageCapacity * sizeof(*_events));
+      }
+      _events[(_start + _eventsCount++) % _storageCapacity] = events[i];
+    }
+  }
+}
+
+- (void)reset {
+  @synchronized(self) {
+    _start = 0;
+    _eventsCount = 0;
+    _droppedEventsCount = 0;
+  }
+}
+
+- (BOOL)writeTraceToFile:(NSString *)path error:(NSError **)error {
+  return [[self traceData] writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+- (NSData *)traceData {
+  [FSLPromiseInstrumentation flushAllThreads];
+  NSUInteger count = 0;
+  NSUInteger droppedEventsCount = 0;
+  FSLPromiseTraceRecorderEntry *entries = NULL;
+  @synchronized(self) {
+    count = _eventsCount;
+    droppedEventsCount = _droppedEventsCount;
+    entries = malloc(MAX(count, 1u) * sizeof(*entries));
+    for (NSUInteger i = 0; i < count; ++i) {
+      entries[i] = (FSLPromiseTraceRecorderEntry){_events[(_start + i) % _storageCapacity], i};
+    }
+  }
+  // Batches from different threads arrive in no particular order.
+  qsort(entries, count, sizeof(*entries), FSLPromiseTraceRecorderCompareEntries);
+
+  NSNumber *processID = @(getpid());
+  NSMutableArray<NSDictionary *> *traceEvents = [[NSMutableArray alloc] initWithCapacity:count];
+  // Where and when each promise got resolved, to draw flow arrows to its continuations from.
+  NSMutableDictionary<NSNumber *, NSDictionary *> *resolutions = [[NSMutableDictionary alloc] init];
+  NSMutableDictionary<NSNumber *, NSNumber *> *parents = [[NSMutableDictionary alloc] init];
+  NSUInteger flowsCount = 0;
+  for (NSUInteger i = 0; i < count; ++i) {
+    FSLPromiseInstrumentationEvent const *event = &entries[i].event;
+    NSDictionary *location = @{
+      @"ts" : @((double)event->timestamp / NSEC_PER_USEC),
+      @"pid" : processID,
+      @"tid" : @(event->threadID),
+    };
+    NSString *promiseID = FSLPromiseTraceRecorderID(event->object);
+    NSMutableDictionary *traceEvent = [location mutableCopy];
+    switch (event->kind) {
+      case FSLPromiseInstrumentationEventKindCreated:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"b",
+          @"cat" : @"promise",
+          @"name" : @"promise",
+          @"id" : promiseID,
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindChained:
+        parents[@(event->object)] = @(event->parent);
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"n",
+          @"cat" : @"promise",
+          @"name" : @"chained",
+          @"id" : promiseID,
+          @"args" : @{@"parent" : FSLPromiseTraceRecorderID(event->parent)},
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindObserved:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"n",
+          @"cat" : @"promise",
+          @"name" : @"observed",
+          @"id" : promiseID,
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindFulfilled:
+      case FSLPromiseInstrumentationEventKindRejected: {
+        resolutions[@(event->object)] = location;
+        NSMutableDictionary *args = [@{
+          @"state" : event->kind == FSLPromiseInstrumentationEventKindFulfilled ? @"fulfilled"
+                                                                                : @"rejected",
+          @"pending_us" : @((double)event->pendingInterval / NSEC_PER_USEC),
+        } mutableCopy];
+        NSNumber *parent = parents[@(event->object)];
+        if (parent) {
+          args[@"parent"] = FSLPromiseTraceRecorderID(parent.unsignedLongValue);
+          [parents removeObjectForKey:@(event->object)];
+        }
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"e",
+          @"cat" : @"promise",
+          @"name" : @"promise",
+          @"id" : promiseID,
+          @"args" : args,
+        }];
+        break;
+      }
+      case FSLPromiseInstrumentationEventKindForwarded: {
+        // The span ends here, while the adopted promise is the one getting resolved.
+        NSMutableDictionary *args = [@{
+          @"state" : @"forwarded",
+          @"adopted" : FSLPromiseTraceRecorderID(event->parent),
+          @"pending_us" : @((double)event->pendingInterval / NSEC_PER_USEC),
+        } mutableCopy];
+        NSNumber *parent = parents[@(event->object)];
+        if (parent) {
+          args[@"parent"] = FSLPromiseTraceRecorderID(parent.unsignedLongValue);
+          [parents removeObjectForKey:@(event->object)];
+        }
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"e",
+          @"cat" : @"promise",
+          @"name" : @"promise",
+          @"id" : promiseID,
+          @"args" : args,
+        }];
+        break;
+      }
+      case FSLPromiseInstrumentationEventKindDispatched:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"i",
+          @"s" : @"t",
+          @"cat" : @"queue",
+          @"name" : @"dispatch",
+          @"args" : @{@"queue" : FSLPromiseTraceRecorderName(event->name, @"")},
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindContinuationBegan: {
+        NSDictionary *resolution = resolutions[@(event->object)];
+        if (resolution) {
+          NSNumber *flowID = @(++flowsCount);
+          NSMutableDictionary *flowStart = [resolution mutableCopy];
+          [flowStart addEntriesFromDictionary:@{
+            @"ph" : @"s",
+            @"cat" : @"flow",
+            @"name" : @"resolution",
+            @"id" : flowID,
+          }];
+          [traceEvents addObject:flowStart];
+          NSMutableDictionary *flowEnd = [location mutableCopy];
+          [flowEnd addEntriesFromDictionary:@{
+            @"ph" : @"f",
+            @"bp" : @"e",
+            @"cat" : @"flow",
+            @"name" : @"resolution",
+            @"id" : flowID,
+          }];
+          [traceEvents addObject:flowEnd];
+        }
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"B",
+          @"cat" : @"continuation",
+          @"name" : FSLPromiseTraceRecorderName(event->name, @"continuation"),
+          @"args" : @{@"promise" : promiseID},
+        }];
+        break;
+      }
+      case FSLPromiseInstrumentationEventKindContinuationEnded:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"E",
+          @"cat" : @"continuation",
+          @"name" : FSLPromiseTraceRecorderName(event->name, @"continuation"),
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindCombinatorEntered:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"B",
+          @"cat" : @"combinator",
+          @"name" : FSLPromiseTraceRecorderName(event->name, @"combinator"),
+        }];
+        break;
+      case FSLPromiseInstrumentationEventKindCombinatorExited:
+        [traceEvent addEntriesFromDictionary:@{
+          @"ph" : @"E",
+          @"cat" : @"combinator",
+          @"name" : FSLPromiseTraceRecorderName(event->name, @"combinator"),
+        }];
+        break;
+    }
+    [traceEvents addObject:traceEvent];
+  }
+  free(entries);
+
+  NSDictionary *trace = @{
+    @"traceEvents" : traceEvents,
+    @"displayTimeUnit" : @"ns",
+    @"otherData" : @{@"droppedEvents" : @(droppedEventsCount)},
+  };
+  return [NSJSONSerialization dataWithJSONObject:trace options:0 error:nil];
+}
+
+@end
@@ -0,0 +1,369 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseWorkStealingExecutor.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+/** Initial number of blocks a deque holds before growing. */
+static int64_t const FSLPromiseWorkStealingInitialCapacity = 64;
+
+/**
+ Circular array of retained blocks. Arrays outgrown by a deque are kept until the pool is freed,
+ since thieves may still read from them.
+ */
+typedef struct FSLPromiseWorkStealingBuffer {
+  struct FSLPromiseWorkStealingBuffer *previous;
+  int64_t capacity;
+  void *_Atomic blocks[];
+} FSLPromiseWorkStealingBuffer;
+
+/**
+ Chase-Lev deque, from "Correct and Efficient Work-Stealing for Weak Memory Models" by Lê et al.
+ Only the owning thread pushes and takes blocks at the bottom, while other threads steal them at
+ the top.
+ */
+typedef struct {
+  _Atomic(int64_t) top;
+  _Atomic(int64_t) bottom;
+  FSLPromiseWorkStealingBuffer *_Atomic buffer;
+} FSLPromiseWorkStealingDeque;
+
+/** Block passed from outside of the pool. */
+typedef struct FSLPromiseWorkStealingEntry {
+  struct FSLPromiseWorkStealingEntry *next;
+  void *block;
+} FSLPromiseWorkStealingEntry;
+
+struct FSLPromiseWorkStealingPool;
+
+typedef struct {
+  struct FSLPromiseWorkStealingPool *pool;
+  FSLPromiseWorkStealingDeque deque;
+  NSUInteger index;
+  /** State of the generator picking the first thread to steal from. */
+  uint32_t randomState;
+} FSLPromiseWorkStealingWorker;
+
+/**
+ State shared by an executor and its threads, which outlives the executor until all the threads
+ exit.
+ */
+typedef struct FSLPromiseWorkStealingPool {
+  /** Guards the blocks passed from outside of the pool, and the threads going to sleep. */
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+  FSLPromiseWorkStealingEntry *head;
+  FSLPromiseWorkStealingEntry *tail;
+  /** Number of blocks passed from outside of the pool, to check for some without locking. */
+  _Atomic(NSUInteger) entriesCount;
+  /** Number of threads about to sleep or sleeping, which pushing a block has to wake up. */
+  _Atomic(NSUInteger) sleepersCount;
+  /** Whether the executor got deallocated, guarded by the mutex. */
+  BOOL isStopping;
+  /** Number of threads still running, plus one for the executor. */
+  _Atomic(NSUInteger) referencesCount;
+  NSUInteger workersCount;
+  FSLPromiseWorkStealingWorker workers[];
+} FSLPromiseWorkStealingPool;
+
+/** Worker the current thread runs, if any. */
+static _Thread_local FSLPromiseWorkStealingWorker *gFSLPromiseWorkStealingCurrentWorker;
+
+static FSLPromiseWorkStealingBuffer *FSLPromiseWorkStealingBufferCreate(int64_t capacity) {
+  FSLPromiseWorkStealingBuffer *buffer =
+      calloc(1, sizeof(*buffer) + (size_t)capacity * sizeof(*buffer->blocks));
+  buffer->capacity = capacity;
+  return buffer;
+}
+
+static void *FSLPromiseWorkStealingBufferGet(FSLPromiseWorkStealingBuffer *buffer,
+                                            int64_t index) {
+  return atomic_load_explicit(&buffer->blocks[index & (buffer->capacity - 1)],
+                              memory_order_relaxed);
+}
+
+static void FSLPromiseWorkStealingBufferPut(FSLPromiseWorkStealingBuffer *buffer, int64_t index,
+                                            void *block) {
+  atomic_store_explicit(&buffer->blocks[index & (buffer->capacity - 1)], block,
+                        memory_order_relaxed);
+}
+
+/** Pushes a retained block at the bottom. Must be called by the owning thread. */
+static void FSLPromiseWorkStealingDequePush(FSLPromiseWorkStealingDeque *deque, void *block) {
+  int64_t const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  int64_t const top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  FSLPromiseWorkStealingBuffer *buffer =
+      atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+  if (bottom - top > buffer->capacity - 1) {
+    FSLPromiseWorkStealingBuffer *grownBuffer =
+        FSLPromiseWorkStealingBufferCreate(buffer->capacity * 2);
+    for (int64_t i = top; i < bottom; ++i) {
+      FSLPromiseWorkStealingBufferPut(grownBuffer, i, FSLPromiseWorkStealingBufferGet(buffer, i));
+    }
+    grownBuffer->previous = buffer;
+    buffer = grownBuffer;
+    atomic_store_explicit(&deque->buffer, buffer, memory_order_release);
+  }
+  FSLPromiseWorkStealingBufferPut(buffer, bottom, block);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+/**
+ Takes the latest block pushed at the bottom, or returns NULL if none. Must be called by the
+ owning thread.
+ */
+static void *FSLPromiseWorkStealingDequeTake(FSLPromiseWorkStealingDeque *deque) {
+  int64_t const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  FSLPromiseWorkStealingBuffer *buffer =
+      atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+  atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+  void *block = NULL;
+  if (top <= bottom) {
+    block = FSLPromiseWorkStealingBufferGet(buffer, bottom);
+    if (top == bottom) {
+      // Last block, which a thief may be stealing at the same time.
+      if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                   memory_order_seq_cst, memory_order_relaxed)) {
+        block = NULL;
+      }
+      atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+  } else {
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+  }
+  return block;
+}
+
+/** Steals the oldest block pushed at the top, or returns NULL if none. */
+static void *FSLPromiseWorkStealingDequeSteal(FSLPromiseWorkStealingDeque *deque) {
+  for (;;) {
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t const bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) {
+      return NULL;
+    }
+    FSLPromiseWorkStealingBuffer *buffer =
+        atomic_load_explicit(&deque->buffer, memory_order_acquire);
+    void *block = FSLPromiseWorkStealingBufferGet(buffer, top);
+    if (atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                memory_order_seq_cst, memory_order_relaxed)) {
+      return block;
+    }
+    // Another thread took that block, so try the next one.
+  }
+}
+
+/** Pops the oldest block passed from outside of the pool, or returns NULL if none. */
+static void *FSLPromiseWorkStealingPoolPopEntryLocked(FSLPromiseWorkStealingPool *pool) {
+  FSLPromiseWorkStealingEntry *entry = pool->head;
+  if (!entry) {
+    return NULL;
+  }
+  pool->head = entry->next;
+  if (!pool->head) {
+    pool->tail = NULL;
+  }
+  atomic_fetch_sub_explicit(&pool->entriesCount, 1, memory_order_relaxed);
+  void *block = entry->block;
+  free(entry);
+  return block;
+}
+
+/**
+ Returns a block passed from outside of the pool or stolen from another thread, or NULL if none.
+ */
+static void *FSLPromiseWorkStealingFindBlock(FSLPromiseWorkStealingWorker *worker, BOOL isLocked) {
+  FSLPromiseWorkStealingPool *pool = worker->pool;
+  void *block = NULL;
+  if (isLocked) {
+    block = FSLPromiseWorkStealingPoolPopEntryLocked(pool);
+  } else if (atomic_load_explicit(&pool->entriesCount, memory_order_relaxed) > 0) {
+    pthread_mutex_lock(&pool->mutex);
+    block = FSLPromiseWorkStealingPoolPopEntryLocked(pool);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+  if (block) {
+    return block;
+  }
+  // Start from a random thread, so that thieves don't all go after the same one.
+  uint32_t random = worker->randomState;
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  worker->randomState = random;
+  NSUInteger const count = pool->workersCount;
+  for (NSUInteger i = 0; i < count && !block; ++i) {
+    FSLPromiseWorkStealingWorker *victim = &pool->workers[(random + i) % count];
+    if (victim != worker) {
+      block = FSLPromiseWorkStealingDequeSteal(&victim->deque);
+    }
+  }
+  return block;
+}
+
+/** Wakes up a sleeping thread, if any, to steal a block just pushed. */
+static void FSLPromiseWorkStealingPoolSignal(FSLPromiseWorkStealingPool *pool) {
+  // Pairs with the increment of the sleepers count before a last look for blocks.
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&pool->sleepersCount, memory_order_relaxed) > 0) {
+    pthread_mutex_lock(&pool->mutex);
+    pthread_cond_signal(&pool->condition);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+}
+
+static void FSLPromiseWorkStealingPoolRelease(FSLPromiseWorkStealingPool *pool) {
+  if (atomic_fetch_sub_explicit(&pool->referencesCount, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+  for (NSUInteger i = 0; i < pool->workersCount; ++i) {
+    FSLPromiseWorkStealingBuffer *buffer =
+        atomic_load_explicit(&pool->workers[i].deque.buffer, memory_order_relaxed);
+    while (buffer) {
+      FSLPromiseWorkStealingBuffer *previous = buffer->previous;
+      free(buffer);
+      buffer = previous;
+    }
+  }
+  pthread_cond_destroy(&pool->condition);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool);
+}
+
+/**
+ Returns the next block for a thread to invoke, sleeping until there is one, or NULL once the
+ executor is deallocated and no block is left.
+ */
+static void *FSLPromiseWorkStealingNextBlock(FSLPromiseWorkStealingWorker *worker) {
+  void *block = FSLPromiseWorkStealingDequeTake(&worker->deque);
+  if (block) {
+    return block;
+  }
+  block = FSLPromiseWorkStealingFindBlock(worker, NO);
+  if (block) {
+    return block;
+  }
+  FSLPromiseWorkStealingPool *pool = worker->pool;
+  pthread_mutex_lock(&pool->mutex);
+  atomic_fetch_add_explicit(&pool->sleepersCount, 1, memory_order_seq_cst);
+  while (!(block = FSLPromiseWorkStealingFindBlock(worker, YES)) && !pool->isStopping) {
+    pthread_cond_wait(&pool->condition, &pool->mutex);
+  }
+  atomic_fetch_sub_explicit(&pool->sleepersCount, 1, memory_order_relaxed);
+  pthread_mutex_unlock(&pool->mutex);
+  return block;
+}
+
+static void *FSLPromiseWorkStealingWorkerMain(void *context) {
+  FSLPromiseWorkStealingWorker *worker = context;
+  gFSLPromiseWorkStealingCurrentWorker = worker;
+  @autoreleasepool {
+    NSThread.currentThread.name =
+        [NSString stringWithFormat:@"com.google.FSLPromises.WorkStealingExecutor.%lu",
+                                   (unsigned long)worker->index];
+  }
+  void *block;
+  while ((block = FSLPromiseWorkStealingNextBlock(worker))) {
+    @autoreleasepool {
+      ((__bridge_transfer dispatch_block_t)block)();
+    }
+  }
+  gFSLPromiseWorkStealingCurrentWorker = NULL;
+  FSLPromiseWorkStealingPoolRelease(worker->pool);
+  return NULL;
+}
+
+@implementation FSLPromiseWorkStealingExecutor {
+  FSLPromiseWorkStealingPool *_pool;
+}
+
+- (instancetype)init {
+  return [self initWithThreadsCount:NSProcessInfo.processInfo.activeProcessorCount];
+}
+
+- (instancetype)initWithThreadsCount:(NSUInteger)threadsCount {
+  NSParameterAssert(threadsCount > 0);
+
+  self = [super init];
+  if (self) {
+    _threadsCount = threadsCount;
+    _pool = calloc(1, sizeof(*_pool) + threadsCount * sizeof(*_pool->workers));
+    pthread_mutex_init(&_pool->mutex, NULL);
+    pthread_cond_init(&_pool->condition, NULL);
+    _pool->workersCount = threadsCount;
+    atomic_init(&_pool->referencesCount, threadsCount + 1);
+    for (NSUInteger i = 0; i < threadsCount; ++i) {
+      FSLPromiseWorkStealingWorker *worker = &_pool->workers[i];
+      worker->pool = _pool;
+      worker->index = i;
+      worker->randomState = (uint32_t)i + 1;
+      atomic_init(&worker->deque.buffer,
+                  FSLPromiseWorkStealingBufferCreate(FSLPromiseWorkStealingInitialCapacity));
+    }
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    for (NSUInteger i = 0; i < threadsCount; ++i) {
+      pthread_t thread;
+      int const __unused error = pthread_create(
+          &thread, &attributes, FSLPromiseWorkStealingWorkerMain, &_pool->workers[i]);
+      NSAssert(error == 0, @"Failed to create a thread: %d", error);
+    }
+    pthread_attr_destroy(&attributes);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  pthread_mutex_lock(&_pool->mutex);
+  _pool->isStopping = YES;
+  pthread_cond_broadcast(&_pool->condition);
+  pthread_mutex_unlock(&_pool->mutex);
+  FSLPromiseWorkStealingPoolRelease(_pool);
+}
+
+- (void)executeBlock:(dispatch_block_t)block {
+  NSParameterAssert(block);
+
+  void *retainedBlock = (__bridge_retained void *)[block copy];
+  FSLPromiseWorkStealingWorker *worker = gFSLPromiseWorkStealingCurrentWorker;
+  if (worker && worker->pool == _pool) {
+    FSLPromiseWorkStealingDequePush(&worker->deque, retainedBlock);
+    FSLPromiseWorkStealingPoolSignal(_pool);
+    return;
+  }
+  FSLPromiseWorkStealingEntry *entry = malloc(sizeof(*entry));
+  *entry = (FSLPromiseWorkStealingEntry){.block = retainedBlock};
+  pthread_mutex_lock(&_pool->mutex);
+  if (_pool->tail) {
+    _pool->tail->next = entry;
+  } else {
+    _pool->head = entry;
+  }
+  _pool->tail = entry;
+  atomic_fetch_add_explicit(&_pool->entriesCount, 1, memory_order_relaxed);
+  pthread_cond_signal(&_pool->condition);
+  pthread_mutex_unlock(&_pool->mutex);
+}
+
+@end
@@ -46,6 +46,16 @@ NS_ASSUME_NONNULL_BEGIN
 + (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
                                all:(NSArray *)promises NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:all:`, but observes the given promises via `executor`.
+
+ @param executor An executor to observe the promises with.
+ @param promises Promises to wait for.
+ @return Promise of an array containing the values of input promises in the same order.
+ */
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                  all:(NSArray *)promises NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -36,6 +36,16 @@ typedef void (^FSLPromiseAlwaysWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                  always:(FSLPromiseAlwaysWorkBlock)work NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:always:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param work A block that always executes, no matter if the receiver is rejected or fulfilled.
+ @return A new pending promise to be resolved with same resolution as the receiver.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                    always:(FSLPromiseAlwaysWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -52,6 +52,16 @@ NS_ASSUME_NONNULL_BEGIN
 + (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
                                any:(NSArray *)promises NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:any:`, but observes the given promises via `executor`.
+
+ @param executor An executor to observe the promises with.
+ @param promises Promises to wait for.
+ @return Promise of array containing the values or `NSError`s of input promises in the same order.
+ */
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                  any:(NSArray *)promises NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
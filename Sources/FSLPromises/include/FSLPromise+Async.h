@@ -43,6 +43,16 @@ typedef void (^FSLPromiseAsyncWorkBlock)(FSLPromiseFulfillBlock fulfill,
 + (instancetype)onQueue:(dispatch_queue_t)queue
                   async:(FSLPromiseAsyncWorkBlock)work NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:async:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param work A block to perform any operations needed to resolve the promise.
+ @return A new pending promise.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                     async:(FSLPromiseAsyncWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -42,6 +42,16 @@ typedef void (^FSLPromiseCatchWorkBlock)(NSError *error) NS_SWIFT_UNAVAILABLE(""
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                   catch:(FSLPromiseCatchWorkBlock)reject NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:catch:`, but invokes the `reject` block via `executor`.
+
+ @param executor An executor to invoke the `reject` block with.
+ @param reject A block to handle the error that receiver was rejected with.
+ @return A new pending promise.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                     catch:(FSLPromiseCatchWorkBlock)reject NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
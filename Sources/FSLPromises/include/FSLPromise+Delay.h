@@ -42,6 +42,17 @@ NS_ASSUME_NONNULL_BEGIN
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                   delay:(NSTimeInterval)interval NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:delay:`, but fulfills the new promise via `executor`.
+
+ @param executor An executor to fulfill the new promise with.
+ @param interval Time to wait in seconds.
+ @return A new pending promise that fulfills at least `delay` seconds later than `self`, or rejects
+         with the same error immediately.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                     delay:(NSTimeInterval)interval NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -39,6 +39,16 @@ typedef id __nullable (^FSLPromiseDoWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
  */
 + (instancetype)onQueue:(dispatch_queue_t)queue do:(FSLPromiseDoWorkBlock)work NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:do:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param work A block that returns a value or an error used to resolve the promise.
+ @return A new pending promise.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                        do:(FSLPromiseDoWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -0,0 +1,196 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The default number of hedged attempts made in addition to the original one is 1. */
+FOUNDATION_EXTERN NSInteger const FSLPromiseHedgeDefaultHedgesCount NS_REFINED_FOR_SWIFT;
+
+/** The default delay interval before making a hedged attempt is 0.1 second. */
+FOUNDATION_EXTERN NSTimeInterval const FSLPromiseHedgeDefaultDelayInterval NS_REFINED_FOR_SWIFT;
+
+@interface FSLPromise<Value>(HedgeAdditions)
+
+typedef id __nullable (^FSLPromiseHedgeWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
+typedef NSTimeInterval (^FSLPromiseHedgeDelayBlock)(NSInteger) NS_SWIFT_UNAVAILABLE("");
+typedef void (^FSLPromiseHedgeReportBlock)(NSInteger, NSTimeInterval) NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously, to fulfill. Unless it has been resolved by then, `work` block
+ is executed again after a delay of `FSLPromiseHedgeDefaultDelayInterval` second(s), up to
+ `FSLPromiseHedgeDefaultHedgesCount` time(s), or right away once the latest attempt gets rejected.
+ The attempts still pending once the promise gets resolved get cancelled unless anything else
+ observes them.
+
+ @param work A block that executes asynchronously on the default queue and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously on the given `queue`, to fulfill. Unless it has been resolved
+ by then, `work` block is executed again after a delay of `FSLPromiseHedgeDefaultDelayInterval`
+ second(s), up to `FSLPromiseHedgeDefaultHedgesCount` time(s), or right away once the latest attempt
+ gets rejected. The attempts still pending once the promise gets resolved get cancelled unless
+ anything else observes them.
+
+ @param queue A queue to invoke the `work` block on.
+ @param work A block that executes asynchronously on the given `queue` and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                  hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously, to fulfill. Unless it has been resolved by then, `work` block
+ is executed again after the given delay `interval`, up to `count` times, or right away once the
+ latest attempt gets rejected. The attempts still pending once the promise gets resolved get
+ cancelled unless anything else observes them.
+
+ @param count Max number of hedged attempts. The `work` block will be executed once if the
+              specified count is less than or equal to zero.
+ @param interval Time to wait for the latest attempt before making the next one.
+ @param work A block that executes asynchronously on the default queue and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)hedges:(NSInteger)count
+                 delay:(NSTimeInterval)interval
+                 hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously on the given `queue`, to fulfill. Unless it has been resolved
+ by then, `work` block is executed again after the given delay `interval`, up to `count` times, or
+ right away once the latest attempt gets rejected. The attempts still pending once the promise gets
+ resolved get cancelled unless anything else observes them.
+
+ @param queue A queue to invoke the `work` block on.
+ @param count Max number of hedged attempts. The `work` block will be executed once if the
+              specified count is less than or equal to zero.
+ @param interval Time to wait for the latest attempt before making the next one.
+ @param work A block that executes asynchronously on the given `queue` and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                 hedges:(NSInteger)count
+                  delay:(NSTimeInterval)interval
+                  hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously, to fulfill. Unless it has been resolved by then, `work` block
+ is executed again after a delay provided by the `delay` block, up to `count` times, or right away
+ once the latest attempt gets rejected. The attempts still pending once the promise gets resolved
+ get cancelled unless anything else observes them.
+
+ @param count Max number of hedged attempts. The `work` block will be executed once if the
+              specified count is less than or equal to zero.
+ @param delay A block that returns the time to wait for the latest attempt before making the next
+              one. The delay block provides the number of the next attempt, starting from 1, and is
+              invoked right before waiting, so it can follow a live latency percentile.
+ @param report A block to invoke with the number of the attempt that resolved the promise, where 0
+               is the original one, and the time since the original attempt had been made.
+ @param work A block that executes asynchronously on the default queue and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)hedges:(NSInteger)count
+             delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                report:(nullable FSLPromiseHedgeReportBlock)report
+                 hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that resolves with the same resolution as the first attempt of `work`
+ block, which executes asynchronously on the given `queue`, to fulfill. Unless it has been resolved
+ by then, `work` block is executed again after a delay provided by the `delay` block, up to `count`
+ times, or right away once the latest attempt gets rejected. The attempts still pending once the
+ promise gets resolved get cancelled unless anything else observes them.
+
+ @param queue A queue to invoke the `work`, `delay` and `report` blocks on.
+ @param count Max number of hedged attempts. The `work` block will be executed once if the
+              specified count is less than or equal to zero.
+ @param delay A block that returns the time to wait for the latest attempt before making the next
+              one. The delay block provides the number of the next attempt, starting from 1, and is
+              invoked right before waiting, so it can follow a live latency percentile.
+ @param report A block to invoke with the number of the attempt that resolved the promise, where 0
+               is the original one, and the time since the original attempt had been made.
+ @param work A block that executes asynchronously on the given `queue` and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                 hedges:(NSInteger)count
+              delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                 report:(nullable FSLPromiseHedgeReportBlock)report
+                  hedge:(FSLPromiseHedgeWorkBlock)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:hedges:delayedBy:report:hedge:`, but invokes the blocks via `executor`.
+
+ @param executor An executor to invoke the `work`, `delay` and `report` blocks with.
+ @param count Max number of hedged attempts. The `work` block will be executed once if the
+              specified count is less than or equal to zero.
+ @param delay A block that returns the time to wait for the latest attempt before making the next
+              one, provided with the number of the next attempt, starting from 1.
+ @param report A block to invoke with the number of the attempt that resolved the promise, where 0
+               is the original one, and the time since the original attempt had been made.
+ @param work A block that returns a value or an error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the first attempt to fulfill,
+         or rejects with the same error as the last attempt to reject, if all of them do.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                    hedges:(NSInteger)count
+                 delayedBy:(FSLPromiseHedgeDelayBlock)delay
+                    report:(nullable FSLPromiseHedgeReportBlock)report
+                     hedge:(FSLPromiseHedgeWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+@end
+
+/**
+ Convenience dot-syntax wrappers for `FSLPromise+Hedge` operators.
+ Usage: FSLPromise.hedge(^id { ... })
+ */
+@interface FSLPromise<Value>(DotSyntax_HedgeAdditions)
+
++ (FSLPromise * (^)(FSLPromiseHedgeWorkBlock))hedge FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise * (^)(dispatch_queue_t, FSLPromiseHedgeWorkBlock))hedgeOn FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise * (^)(NSInteger, NSTimeInterval, FSLPromiseHedgeWorkBlock))hedgeAgain
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise * (^)(dispatch_queue_t, NSInteger, NSTimeInterval,
+                    FSLPromiseHedgeWorkBlock))hedgeAgainOn FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
+
+@end
+
+NS_ASSUME_NONNULL_END
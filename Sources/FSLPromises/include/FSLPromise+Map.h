@@ -0,0 +1,223 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Possible ways to handle the errors returned by the work of `map` and `forEach` operators.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseMapMode) {
+  /** Rejects with the first error and doesn't start the work for the remaining items. */
+  FSLPromiseMapModeFailFast = 0,
+  /** Starts the work for all items regardless of errors and collects them with the results. */
+  FSLPromiseMapModeCollectErrors,
+} NS_REFINED_FOR_SWIFT;
+
+@interface FSLPromise<Value>(MapAdditions)
+
+typedef id __nullable (^FSLPromiseMapWorkBlock)(id item) NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Invokes `work` block for each item asynchronously, with at most `count` of the promises it
+ returns pending at a time, and waits until all of them are fulfilled.
+ Items are taken in order, one at a time, as soon as the work for a previous one has completed.
+ If the work for one of the items fails, then the returned promise is rejected with same error.
+ Results of `nil` become `NSNull` instances in the resulting array.
+
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array containing the results of `work` block in the same order as `items`.
+ */
++ (FSLPromise<NSArray *> *)map:(NSArray *)items
+                   concurrency:(NSUInteger)count
+                          work:(FSLPromiseMapWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Invokes `work` block for each item asynchronously on the given `queue`, with at most `count` of the
+ promises it returns pending at a time, and waits until all of them are fulfilled.
+ Items are taken in order, one at a time, as soon as the work for a previous one has completed.
+ If the work for one of the items fails, then the returned promise is rejected with same error.
+ Results of `nil` become `NSNull` instances in the resulting array.
+
+ @param queue A queue to invoke the `work` block on.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array containing the results of `work` block in the same order as `items`.
+ */
++ (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
+                               map:(NSArray *)items
+                       concurrency:(NSUInteger)count
+                              work:(FSLPromiseMapWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `map:concurrency:work:`, but with the given `mode` of handling errors. In
+ `FSLPromiseMapModeCollectErrors` mode the returned promise is always fulfilled once the work for
+ all items has completed, and the resulting array contains errors in place of the failed results.
+
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array containing the results of `work` block in the same order as `items`.
+ */
++ (FSLPromise<NSArray *> *)map:(NSArray *)items
+                   concurrency:(NSUInteger)count
+                          mode:(FSLPromiseMapMode)mode
+                          work:(FSLPromiseMapWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:map:concurrency:work:`, but with the given `mode` of handling errors. In
+ `FSLPromiseMapModeCollectErrors` mode the returned promise is always fulfilled once the work for
+ all items has completed, and the resulting array contains errors in place of the failed results.
+
+ @param queue A queue to invoke the `work` block on.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array containing the results of `work` block in the same order as `items`.
+ */
++ (FSLPromise<NSArray *> *)onQueue:(dispatch_queue_t)queue
+                               map:(NSArray *)items
+                       concurrency:(NSUInteger)count
+                              mode:(FSLPromiseMapMode)mode
+                              work:(FSLPromiseMapWorkBlock)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:map:concurrency:mode:work:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array containing the results of `work` block in the same order as `items`.
+ */
++ (FSLPromise<NSArray *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                  map:(NSArray *)items
+                          concurrency:(NSUInteger)count
+                                 mode:(FSLPromiseMapMode)mode
+                                 work:(FSLPromiseMapWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `map:concurrency:work:`, but doesn't keep the results, for work that is only run for its
+ side effects.
+
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an empty array, fulfilled once the work for all items has completed.
+ */
++ (FSLPromise<NSArray<NSError *> *> *)forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         work:(FSLPromiseMapWorkBlock)work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:map:concurrency:work:`, but doesn't keep the results, for work that is only run
+ for its side effects.
+
+ @param queue A queue to invoke the `work` block on.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an empty array, fulfilled once the work for all items has completed.
+ */
++ (FSLPromise<NSArray<NSError *> *> *)onQueue:(dispatch_queue_t)queue
+                                      forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         work:(FSLPromiseMapWorkBlock)work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `map:concurrency:mode:work:`, but doesn't keep the results, for work that is only run for
+ its side effects. In `FSLPromiseMapModeCollectErrors` mode the returned promise is fulfilled with
+ the errors returned by `work` block, in the order the work has failed.
+
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array of errors, fulfilled once the work for all items has completed.
+ */
++ (FSLPromise<NSArray<NSError *> *> *)forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         mode:(FSLPromiseMapMode)mode
+                                         work:(FSLPromiseMapWorkBlock)work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:map:concurrency:mode:work:`, but doesn't keep the results, for work that is only
+ run for its side effects. In `FSLPromiseMapModeCollectErrors` mode the returned promise is
+ fulfilled with the errors returned by `work` block, in the order the work has failed.
+
+ @param queue A queue to invoke the `work` block on.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array of errors, fulfilled once the work for all items has completed.
+ */
++ (FSLPromise<NSArray<NSError *> *> *)onQueue:(dispatch_queue_t)queue
+                                      forEach:(NSArray *)items
+                                  concurrency:(NSUInteger)count
+                                         mode:(FSLPromiseMapMode)mode
+                                         work:(FSLPromiseMapWorkBlock)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:forEach:concurrency:mode:work:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param items Items to invoke `work` block for.
+ @param count Max number of items to have the work pending for at a time, treated as 1 if zero.
+ @param mode The way to handle the errors returned by `work` block.
+ @param work A block that returns a value, an error or a promise for the given item.
+ @return Promise of an array of errors, fulfilled once the work for all items has completed.
+ */
++ (FSLPromise<NSArray<NSError *> *> *)onExecutor:(id<FSLPromiseExecutor>)executor
+                                         forEach:(NSArray *)items
+                                     concurrency:(NSUInteger)count
+                                            mode:(FSLPromiseMapMode)mode
+                                            work:(FSLPromiseMapWorkBlock)work
+    NS_SWIFT_UNAVAILABLE("");
+
+@end
+
+/**
+ Convenience dot-syntax wrappers for `FSLPromise` `map` and `forEach` operators.
+ Usage: FSLPromise.map(@[ ... ], 4, ^id(id item) { ... })
+ */
+@interface FSLPromise<Value>(DotSyntax_MapAdditions)
+
++ (FSLPromise<NSArray *> * (^)(NSArray *, NSUInteger, FSLPromiseMapWorkBlock))map
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise<NSArray *> * (^)(dispatch_queue_t, NSArray *, NSUInteger,
+                               FSLPromiseMapWorkBlock))mapOn FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise<NSArray<NSError *> *> * (^)(NSArray *, NSUInteger, FSLPromiseMapWorkBlock))forEach
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise<NSArray<NSError *> *> * (^)(dispatch_queue_t, NSArray *, NSUInteger,
+                                          FSLPromiseMapWorkBlock))forEachOn
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
+
+@end
+
+NS_ASSUME_NONNULL_END
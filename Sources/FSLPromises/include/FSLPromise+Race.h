@@ -20,6 +20,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface FSLPromise<Value>(RaceAdditions)
 
+typedef id __nullable (^FSLPromiseRaceWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
+
 /**
  Wait until any of the given promises are fulfilled.
  If one of the promises is rejected, then the returned promise is rejected with same error.
@@ -45,6 +47,91 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)onQueue:(dispatch_queue_t)queue race:(NSArray *)promises NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `race:`, but optionally lets the promises that lose the race know they are not needed
+ anymore, so that they get cancelled unless anything else observes them.
+
+ @param promises Promises to wait for.
+ @param cancelLosers Whether to cancel the losing promises nothing else observes.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the given ones, which was resolved.
+ */
++ (instancetype)race:(NSArray *)promises cancelLosers:(BOOL)cancelLosers NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:race:`, but optionally lets the promises that lose the race know they are not
+ needed anymore, so that they get cancelled unless anything else observes them.
+
+ @param queue A queue to dispatch on.
+ @param promises Promises to wait for.
+ @param cancelLosers Whether to cancel the losing promises nothing else observes.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the given ones, which was resolved.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+                   race:(NSArray *)promises
+           cancelLosers:(BOOL)cancelLosers NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:race:`, but observes the given promises via `executor`.
+
+ @param executor An executor to observe the promises with.
+ @param promises Promises to wait for.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the given ones, which was resolved.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                      race:(NSArray *)promises NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:race:cancelLosers:`, but observes the given promises via `executor`.
+
+ @param executor An executor to observe the promises with.
+ @param promises Promises to wait for.
+ @param cancelLosers Whether to cancel the losing promises nothing else observes.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the given ones, which was resolved.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                      race:(NSArray *)promises
+              cancelLosers:(BOOL)cancelLosers NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Starts the given `work` blocks one by one asynchronously, unless the race has been settled by
+ then, and waits until any of the promises they return is resolved. The promises that lose the
+ race get cancelled unless anything else observes them.
+
+ @param work Blocks that return a promise, a value or an error to race with.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the ones returned by `work` blocks, which was resolved.
+ */
++ (instancetype)raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Starts the given `work` blocks one by one asynchronously, unless the race has been settled by
+ then, and waits until any of the promises they return is resolved. The promises that lose the
+ race get cancelled unless anything else observes them.
+
+ @param queue A queue to dispatch on.
+ @param work Blocks that return a promise, a value or an error to race with.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the ones returned by `work` blocks, which was resolved.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+               raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:raceWork:`, but starts the `work` blocks and observes the promises they return
+ via `executor`.
+
+ @param executor An executor to start the `work` blocks with.
+ @param work Blocks that return a promise, a value or an error to race with.
+ @return A new pending promise to be resolved with the same resolution as the first promise, among
+         the ones returned by `work` blocks, which was resolved.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                  raceWork:(NSArray<FSLPromiseRaceWorkBlock> *)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -56,6 +143,10 @@ NS_ASSUME_NONNULL_BEGIN
 + (FSLPromise * (^)(NSArray *))race FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
 + (FSLPromise * (^)(dispatch_queue_t, NSArray *))raceOn FSL_PROMISES_DOT_SYNTAX
     NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise * (^)(NSArray<FSLPromiseRaceWorkBlock> *))raceWork FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
++ (FSLPromise * (^)(dispatch_queue_t, NSArray<FSLPromiseRaceWorkBlock> *))raceWorkOn
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
 
 @end
 
@@ -42,6 +42,17 @@ typedef id __nullable (^FSLPromiseRecoverWorkBlock)(NSError *error) NS_SWIFT_UNA
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                 recover:(FSLPromiseRecoverWorkBlock)recovery NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:recover:`, but invokes the `recovery` block via `executor`.
+
+ @param executor An executor to invoke the `recovery` block with.
+ @param recovery A block to handle the error that the receiver was rejected with.
+ @return A new pending promise to use instead of the rejected one that gets resolved with resolution
+         returned from `recovery` block.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                   recover:(FSLPromiseRecoverWorkBlock)recovery NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -53,6 +53,120 @@ typedef id __nullable (^FSLPromiseReducerBlock)(Value __nullable partial, id nex
                  reduce:(NSArray *)items
                 combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Same as `onQueue:reduce:combine:`, but invokes the `reducer` via `executor`.
+
+ @param executor An executor to invoke the `reducer` with.
+ @param items An array of values to process in order.
+ @param reducer A block to combine an accumulating value and an element of the sequence into
+                the new accumulating value or a promise resolved with it, to be used in the next
+                call of the `reducer` or returned to the caller.
+ @return A new pending promise returned from the last `reducer` invocation.
+         Or `self` if `items` is empty.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                    reduce:(NSArray *)items
+                   combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Sequentially reduces a sequence of values to a single promise using a given combining block
+ and the value `self` resolves with as initial value. Unlike `reduce:combine:`, takes the values
+ one at a time, only once the previous one has been combined, so that the memory used doesn't grow
+ with the number of values.
+
+ @param items An enumerator of values to process in order.
+ @param reducer A block to combine an accumulating value and an element of the sequence into
+                the new accumulating value or a promise resolved with it, to be used in the next
+                call of the `reducer` or returned to the caller.
+ @return A new pending promise resolved with the same resolution as the last `reducer` invocation,
+         or as `self` if `items` is empty.
+ */
+- (FSLPromise *)lazyReduce:(NSEnumerator *)items
+                   combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Sequentially reduces a sequence of values to a single promise using a given combining block
+ and the value `self` resolves with as initial value. Unlike `onQueue:reduce:combine:`, takes the
+ values one at a time, only once the previous one has been combined, so that the memory used
+ doesn't grow with the number of values.
+
+ @param queue A queue to dispatch on.
+ @param items An enumerator of values to process in order.
+ @param reducer A block to combine an accumulating value and an element of the sequence into
+                the new accumulating value or a promise resolved with it, to be used in the next
+                call of the `reducer` or returned to the caller.
+ @return A new pending promise resolved with the same resolution as the last `reducer` invocation,
+         or as `self` if `items` is empty.
+ */
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+             lazyReduce:(NSEnumerator *)items
+                combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:lazyReduce:combine:`, but invokes the `reducer` via `executor`.
+
+ @param executor An executor to invoke the `reducer` with.
+ @param items An enumerator of values to process in order.
+ @param reducer A block to combine an accumulating value and an element of the sequence into
+                the new accumulating value or a promise resolved with it, to be used in the next
+                call of the `reducer` or returned to the caller.
+ @return A new pending promise resolved with the same resolution as the last `reducer` invocation,
+         or as `self` if `items` is empty.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                lazyReduce:(NSEnumerator *)items
+                   combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Reduces a collection of values to a single promise in parallel, using a given associative
+ combining block and the value `self` resolves with as initial value. The values are split into
+ contiguous chunks, one per active processor, reduced concurrently on a global queue, and then the
+ partial results are combined in order.
+
+ @param items An array of values to process.
+ @param reducer An associative block to combine an accumulating value and an element of the
+                collection, or two partial results, into the new accumulating value or an error.
+                Must not return a promise.
+ @return A new pending promise resolved with the result of the last `reducer` invocation, or
+         rejected with the first error returned from `reducer`.
+ */
+- (FSLPromise *)treeReduce:(NSArray *)items
+                   combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Reduces a collection of values to a single promise, using a given associative combining block
+ and the value `self` resolves with as initial value. The values are split into contiguous chunks,
+ one per active processor, reduced on the given `queue`, and then the partial results are combined
+ in order. The chunks are only reduced in parallel if `queue` is concurrent.
+
+ @param queue A queue to dispatch on.
+ @param items An array of values to process.
+ @param reducer An associative block to combine an accumulating value and an element of the
+                collection, or two partial results, into the new accumulating value or an error.
+                Must not return a promise.
+ @return A new pending promise resolved with the result of the last `reducer` invocation, or
+         rejected with the first error returned from `reducer`.
+ */
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+             treeReduce:(NSArray *)items
+                combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:treeReduce:combine:`, but reduces the chunks via `executor`, which they are
+ only reduced in parallel by if it runs blocks concurrently.
+
+ @param executor An executor to reduce the chunks with.
+ @param items An array of values to process.
+ @param reducer An associative block to combine an accumulating value and an element of the
+                collection, or two partial results, into the new accumulating value or an error.
+                Must not return a promise.
+ @return A new pending promise resolved with the result of the last `reducer` invocation, or
+         rejected with the first error returned from `reducer`.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                treeReduce:(NSArray *)items
+                   combine:(FSLPromiseReducerBlock)reducer NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -65,6 +179,14 @@ typedef id __nullable (^FSLPromiseReducerBlock)(Value __nullable partial, id nex
     NS_SWIFT_UNAVAILABLE("");
 - (FSLPromise * (^)(dispatch_queue_t, NSArray *, FSLPromiseReducerBlock))reduceOn
     FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
+- (FSLPromise * (^)(NSEnumerator *, FSLPromiseReducerBlock))lazyReduce FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
+- (FSLPromise * (^)(dispatch_queue_t, NSEnumerator *, FSLPromiseReducerBlock))lazyReduceOn
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
+- (FSLPromise * (^)(NSArray *, FSLPromiseReducerBlock))treeReduce FSL_PROMISES_DOT_SYNTAX
+    NS_SWIFT_UNAVAILABLE("");
+- (FSLPromise * (^)(dispatch_queue_t, NSArray *, FSLPromiseReducerBlock))treeReduceOn
+    FSL_PROMISES_DOT_SYNTAX NS_SWIFT_UNAVAILABLE("");
 
 @end
 
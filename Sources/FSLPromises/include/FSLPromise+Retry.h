@@ -15,6 +15,7 @@
  */
 
 #import "FSLPromise.h"
+#import "FSLPromiseRetryBudget.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -24,6 +25,19 @@ FOUNDATION_EXTERN NSInteger const FSLPromiseRetryDefaultAttemptsCount NS_REFINED
 /** The default delay interval before making a retry attempt is 1.0 second. */
 FOUNDATION_EXTERN NSTimeInterval const FSLPromiseRetryDefaultDelayInterval NS_REFINED_FOR_SWIFT;
 
+/**
+ Possible ways to randomize the delay interval before making a retry attempt.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseRetryJitter) {
+  /** The delay doubles with each retry attempt, from the initial delay up to the max one. */
+  FSLPromiseRetryJitterNone = 0,
+  /**
+   The delay is picked at random between the initial delay and three times the previous one, up to
+   the max one, so that clients which failed at the same time don't retry in lockstep.
+   */
+  FSLPromiseRetryJitterDecorrelated,
+} NS_REFINED_FOR_SWIFT;
+
 @interface FSLPromise<Value>(RetryAdditions)
 
 typedef id __nullable (^FSLPromiseRetryWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
@@ -95,7 +109,8 @@ typedef BOOL (^FSLPromiseRetryPredicateBlock)(NSInteger, NSError *) NS_SWIFT_UNA
  block, which executes asynchronously, or rejects with the same error after all retry attempts have
  been exhausted. On rejection, the `work` block is retried after the given delay `interval` and will
  continue to retry until the number of specified attempts have been exhausted or will bail early if
- the given condition is not met.
+ the given condition is not met. Attempts rejected by an open `FSLPromiseCircuitBreaker` are not
+ retried.
 
  @param count Max number of retry attempts. The `work` block will be executed once if the specified
               count is less than or equal to zero.
@@ -119,7 +134,8 @@ typedef BOOL (^FSLPromiseRetryPredicateBlock)(NSInteger, NSError *) NS_SWIFT_UNA
  block, which executes asynchronously on the given `queue`, or rejects with the same error after all
  retry attempts have been exhausted. On rejection, the `work` block is retried after the given
  delay `interval` and will continue to retry until the number of specified attempts have been
- exhausted or will bail early if the given condition is not met.
+ exhausted or will bail early if the given condition is not met. Attempts rejected by an open
+ `FSLPromiseCircuitBreaker` are not retried.
 
  @param queue A queue to invoke the `work` block on.
  @param count Max number of retry attempts. The `work` block will be executed once if the specified
@@ -140,6 +156,113 @@ typedef BOOL (^FSLPromiseRetryPredicateBlock)(NSInteger, NSError *) NS_SWIFT_UNA
               condition:(nullable FSLPromiseRetryPredicateBlock)predicate
                   retry:(FSLPromiseRetryWorkBlock)work NS_REFINED_FOR_SWIFT;
 
+/**
+ Creates a pending promise that fulfills with the same value as the promise returned from `work`
+ block, which executes asynchronously, or rejects with the same error after all retry attempts have
+ been exhausted. On rejection, the `work` block is retried after a delay that grows exponentially
+ from `initialDelay` up to `maxDelay`, randomized according to `jitter`, and will continue to retry
+ until the number of specified attempts have been exhausted, or will bail early if the next attempt
+ would start past the `deadline`, the `budget` doesn't allow for more retries or the given condition
+ is not met. Attempts rejected by an open `FSLPromiseCircuitBreaker` are not retried.
+
+ @param count Max number of retry attempts. The `work` block will be executed once if the specified
+              count is less than or equal to zero.
+ @param initialDelay Time to wait before the first retry attempt.
+ @param maxDelay Max time to wait before any retry attempt.
+ @param jitter The way to randomize the time to wait before each retry attempt.
+ @param deadline Time since the first attempt after which no more retry attempts are made, or zero
+                 for no deadline. Doesn't interrupt an attempt in progress.
+ @param budget Token bucket to share between retry operations to cap the ratio of retry attempts, or
+               nil for no cap.
+ @param predicate Condition to check before the next retry attempt. The predicate block provides the
+                  the number of remaining retry attempts and the error that the promise was rejected
+                  with.
+ @param work A block that executes asynchronously on the default queue and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the promise returned from `work`
+         block, or rejects with the same error after all retry attempts have been exhausted or if
+         any of the given limits is reached.
+ */
++ (instancetype)attempts:(NSInteger)count
+            initialDelay:(NSTimeInterval)initialDelay
+                maxDelay:(NSTimeInterval)maxDelay
+                  jitter:(FSLPromiseRetryJitter)jitter
+                deadline:(NSTimeInterval)deadline
+                  budget:(nullable FSLPromiseRetryBudget *)budget
+               condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                   retry:(FSLPromiseRetryWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Creates a pending promise that fulfills with the same value as the promise returned from `work`
+ block, which executes asynchronously on the given `queue`, or rejects with the same error after all
+ retry attempts have been exhausted. On rejection, the `work` block is retried after a delay that
+ grows exponentially from `initialDelay` up to `maxDelay`, randomized according to `jitter`, and
+ will continue to retry until the number of specified attempts have been exhausted, or will bail
+ early if the next attempt would start past the `deadline`, the `budget` doesn't allow for more
+ retries or the given condition is not met. Attempts rejected by an open
+ `FSLPromiseCircuitBreaker` are not retried.
+
+ @param queue A queue to invoke the `work` block on.
+ @param count Max number of retry attempts. The `work` block will be executed once if the specified
+              count is less than or equal to zero.
+ @param initialDelay Time to wait before the first retry attempt.
+ @param maxDelay Max time to wait before any retry attempt.
+ @param jitter The way to randomize the time to wait before each retry attempt.
+ @param deadline Time since the first attempt after which no more retry attempts are made, or zero
+                 for no deadline. Doesn't interrupt an attempt in progress.
+ @param budget Token bucket to share between retry operations to cap the ratio of retry attempts, or
+               nil for no cap.
+ @param predicate Condition to check before the next retry attempt. The predicate block provides the
+                  the number of remaining retry attempts and the error that the promise was rejected
+                  with.
+ @param work A block that executes asynchronously on the given `queue` and returns a value or an
+             error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the promise returned from `work`
+         block, or rejects with the same error after all retry attempts have been exhausted or if
+         any of the given limits is reached.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+               attempts:(NSInteger)count
+           initialDelay:(NSTimeInterval)initialDelay
+               maxDelay:(NSTimeInterval)maxDelay
+                 jitter:(FSLPromiseRetryJitter)jitter
+               deadline:(NSTimeInterval)deadline
+                 budget:(nullable FSLPromiseRetryBudget *)budget
+              condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                  retry:(FSLPromiseRetryWorkBlock)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:attempts:initialDelay:maxDelay:jitter:deadline:budget:condition:retry:`, but
+ invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param count Max number of retry attempts. The `work` block will be executed once if the specified
+              count is less than or equal to zero.
+ @param initialDelay Time to wait before the first retry attempt.
+ @param maxDelay Max time to wait before any retry attempt.
+ @param jitter The way to randomize the time to wait before each retry attempt.
+ @param deadline Time since the first attempt after which no more retry attempts are made, or zero
+                 for no deadline. Doesn't interrupt an attempt in progress.
+ @param budget Token bucket to share between retry operations to cap the ratio of retry attempts, or
+               nil for no cap.
+ @param predicate Condition to check before the next retry attempt. The predicate block provides the
+                  the number of remaining retry attempts and the error that the promise was rejected
+                  with.
+ @param work A block that returns a value or an error used to resolve the promise.
+ @return A new pending promise that fulfills with the same value as the promise returned from `work`
+         block, or rejects with the same error after all retry attempts have been exhausted or if
+         any of the given limits is reached.
+ */
++ (instancetype)onExecutor:(id<FSLPromiseExecutor>)executor
+                  attempts:(NSInteger)count
+              initialDelay:(NSTimeInterval)initialDelay
+                  maxDelay:(NSTimeInterval)maxDelay
+                    jitter:(FSLPromiseRetryJitter)jitter
+                  deadline:(NSTimeInterval)deadline
+                    budget:(nullable FSLPromiseRetryBudget *)budget
+                 condition:(nullable FSLPromiseRetryPredicateBlock)predicate
+                     retry:(FSLPromiseRetryWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -19,7 +19,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- Waits for all scheduled promises blocks.
+ Waits for all scheduled promises blocks tracked by `FSLPromise.dispatchGroup`.
 
  @param timeout Maximum time to wait.
  @return YES if all promises blocks have completed before the timeout and NO otherwise.
@@ -30,8 +30,14 @@ FOUNDATION_EXTERN BOOL FSLWaitForPromisesWithTimeout(NSTimeInterval timeout) NS_
 
 /**
  Dispatch group for promises that is typically used to wait for all scheduled blocks.
+ Every pending promise enters the group it finds here on creation, leaves it on resolution, and
+ dispatches its observers within it. Set to a new group, e.g. in a test `setUp`, to only track the
+ promises created from then on, or to `nil` at startup to stop tracking promises altogether and
+ avoid contending on a single process-wide counter. Replaced groups are released once the promises
+ created in them don't need them anymore.
+ Always `nil` if `FSL_PROMISES_DISPATCH_GROUP_IS_DISABLED` is defined at compile time.
  */
-@property(class, nonatomic, readonly) dispatch_group_t dispatchGroup NS_REFINED_FOR_SWIFT;
+@property(class, nullable) dispatch_group_t dispatchGroup NS_REFINED_FOR_SWIFT;
 
 /**
  Properties to get the current state of the promise.
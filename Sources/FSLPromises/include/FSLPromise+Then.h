@@ -46,6 +46,43 @@ typedef id __nullable (^FSLPromiseThenWorkBlock)(Value __nullable value) NS_SWIF
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                    then:(FSLPromiseThenWorkBlock)work NS_REFINED_FOR_SWIFT;
 
+/**
+ Creates a pending promise which eventually gets resolved with resolution returned from `work`
+ block: either value, error or another promise. The `work` block is invoked according to `policy`
+ when the receiver is fulfilled, regardless of the receiver's `executionPolicy`. If receiver is
+ rejected, the returned promise is also rejected with the same error.
+
+ @param queue A queue to invoke the `work` block on.
+ @param policy A policy to invoke the `work` block with.
+ @param work A block to handle the value that receiver was fulfilled with.
+ @return A new pending promise to be resolved with resolution returned from the `work` block.
+ */
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+                 policy:(FSLPromiseExecutionPolicy)policy
+                   then:(FSLPromiseThenWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:then:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param work A block to handle the value that receiver was fulfilled with.
+ @return A new pending promise to be resolved with resolution returned from the `work` block.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                      then:(FSLPromiseThenWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:policy:then:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param policy A policy to invoke the `work` block with.
+ @param work A block to handle the value that receiver was fulfilled with.
+ @return A new pending promise to be resolved with resolution returned from the `work` block.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                    policy:(FSLPromiseExecutionPolicy)policy
+                      then:(FSLPromiseThenWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -40,6 +40,17 @@ NS_ASSUME_NONNULL_BEGIN
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                 timeout:(NSTimeInterval)interval NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:timeout:`, but resolves the new promise via `executor`.
+
+ @param executor An executor to resolve the new promise with.
+ @param interval Time to wait in seconds.
+ @return A new pending promise that gets either resolved with same resolution as the receiver or
+         rejected with `FSLPromiseErrorCodeTimedOut` error code in `FSLPromiseErrorDomain`.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                   timeout:(NSTimeInterval)interval NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -42,6 +42,17 @@ typedef BOOL (^FSLPromiseValidateWorkBlock)(Value __nullable value) NS_SWIFT_UNA
 - (FSLPromise *)onQueue:(dispatch_queue_t)queue
                validate:(FSLPromiseValidateWorkBlock)predicate NS_REFINED_FOR_SWIFT;
 
+/**
+ Same as `onQueue:validate:`, but invokes the `predicate` block via `executor`.
+
+ @param executor An executor to invoke the `predicate` block with.
+ @param predicate An expression to validate.
+ @return A new pending promise that gets either resolved with same resolution as the receiver or
+         rejected with `FSLPromiseErrorCodeValidationFailure` error code in `FSLPromiseErrorDomain`.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                  validate:(FSLPromiseValidateWorkBlock)predicate NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -39,6 +39,12 @@ typedef void (^FSLPromiseDoubleCompletion)(double) NS_SWIFT_UNAVAILABLE("");
 typedef void (^FSLPromiseDoubleOrErrorCompletion)(double, NSError* __nullable)
     NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Combines the objects provided by a completion handler into the value to resolve a promise with.
+ */
+typedef id __nullable (^FSLPromise2ObjectsCombineBlock)(id __nullable, id __nullable)
+    NS_SWIFT_UNAVAILABLE("");
+
 /**
  Provides an easy way to convert methods that use common callback patterns into promises.
  */
@@ -146,6 +152,36 @@ typedef void (^FSLPromiseDoubleOrErrorCompletion)(double, NSError* __nullable)
     wrap2ObjectsOrErrorCompletion:(void (^)(FSLPromise2ObjectsOrErrorCompletion handler))work
     NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Same as `wrap2ObjectsOrErrorCompletion:`, but resolves the promise with the value returned by
+ `combine` instead of boxing the objects into an array.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @param combine A block invoked from the completion handler to combine the objects it provides if
+                error is `nil`.
+ @returns A promise that resolves with the value returned by `combine`, the same way `async:` does,
+ if error is `nil`. Otherwise, rejects with the error.
+ */
++ (instancetype)wrap2ObjectsOrErrorCompletion:
+                    (void (^)(FSLPromise2ObjectsOrErrorCompletion handler))work
+                                      combine:(FSLPromise2ObjectsCombineBlock)combine
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:wrap2ObjectsOrErrorCompletion:`, but resolves the promise with the value returned
+ by `combine` instead of boxing the objects into an array.
+
+ @param queue A queue to invoke the `work` block on.
+ @param work A block to perform any operations needed to resolve the promise.
+ @param combine A block invoked from the completion handler to combine the objects it provides if
+                error is `nil`.
+ @returns A promise that resolves with the value returned by `combine`, the same way `async:` does,
+ if error is `nil`. Otherwise, rejects with the error.
+ */
++ (instancetype)onQueue:(dispatch_queue_t)queue
+    wrap2ObjectsOrErrorCompletion:(void (^)(FSLPromise2ObjectsOrErrorCompletion handler))work
+                          combine:(FSLPromise2ObjectsCombineBlock)combine NS_SWIFT_UNAVAILABLE("");
+
 /**
  @param work A block to perform any operations needed to resolve the promise.
  @returns A promise that resolves with an `NSNumber` wrapping YES/NO.
@@ -248,6 +284,148 @@ typedef void (^FSLPromiseDoubleOrErrorCompletion)(double, NSError* __nullable)
       wrapDoubleOrErrorCompletion:(void (^)(FSLPromiseDoubleOrErrorCompletion handler))work
     NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Same as `wrapCompletion:`, but invokes `work` synchronously on the current thread and resolves the
+ promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with `nil` when completion handler is invoked.
+ */
++ (instancetype)syncWrapCompletion:(void (^)(FSLPromiseCompletion handler))work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapObjectCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an object provided by completion handler.
+ */
++ (instancetype)syncWrapObjectCompletion:(void (^)(FSLPromiseObjectCompletion handler))work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapErrorCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an error provided by completion handler.
+ If error is `nil`, fulfills with `nil`, otherwise rejects with the error.
+ */
++ (instancetype)syncWrapErrorCompletion:(void (^)(FSLPromiseErrorCompletion handler))work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapObjectOrErrorCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an object provided by completion handler if error is `nil`.
+ Otherwise, rejects with the error.
+ */
++ (instancetype)syncWrapObjectOrErrorCompletion:
+    (void (^)(FSLPromiseObjectOrErrorCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapErrorOrObjectCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an error or object provided by completion handler. If error
+ is not `nil`, rejects with the error.
+ */
++ (instancetype)syncWrapErrorOrObjectCompletion:
+    (void (^)(FSLPromiseErrorOrObjectCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrap2ObjectsOrErrorCompletion:`, but invokes `work` synchronously on the current thread
+ and resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an array of objects provided by completion handler in order
+ if error is `nil`. Otherwise, rejects with the error.
+ */
++ (FSLPromise<NSArray*>*)syncWrap2ObjectsOrErrorCompletion:
+    (void (^)(FSLPromise2ObjectsOrErrorCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `syncWrap2ObjectsOrErrorCompletion:`, but resolves the promise with the value returned by
+ `combine` instead of boxing the objects into an array.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @param combine A block invoked from the completion handler to combine the objects it provides if
+                error is `nil`.
+ @returns A promise that resolves with the value returned by `combine`, the same way `async:` does,
+ if error is `nil`. Otherwise, rejects with the error.
+ */
++ (instancetype)syncWrap2ObjectsOrErrorCompletion:
+                    (void (^)(FSLPromise2ObjectsOrErrorCompletion handler))work
+                                          combine:(FSLPromise2ObjectsCombineBlock)combine
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapBoolCompletion:`, but invokes `work` synchronously on the current thread and resolves
+ the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping YES/NO.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapBoolCompletion:(void (^)(FSLPromiseBoolCompletion handler))work
+    NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapBoolOrErrorCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping YES/NO when error is `nil`.
+ Otherwise rejects with the error.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapBoolOrErrorCompletion:
+    (void (^)(FSLPromiseBoolOrErrorCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapIntegerCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping an integer.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapIntegerCompletion:
+    (void (^)(FSLPromiseIntegerCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapIntegerOrErrorCompletion:`, but invokes `work` synchronously on the current thread
+ and resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping an integer when error is `nil`.
+ Otherwise rejects with the error.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapIntegerOrErrorCompletion:
+    (void (^)(FSLPromiseIntegerOrErrorCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapDoubleCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping a double.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapDoubleCompletion:
+    (void (^)(FSLPromiseDoubleCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `wrapDoubleOrErrorCompletion:`, but invokes `work` synchronously on the current thread and
+ resolves the promise directly from the completion handler, without hopping through any queue.
+
+ @param work A block to perform any operations needed to resolve the promise.
+ @returns A promise that resolves with an `NSNumber` wrapping a double when error is `nil`.
+ Otherwise rejects with the error.
+ */
++ (FSLPromise<NSNumber*>*)syncWrapDoubleOrErrorCompletion:
+    (void (^)(FSLPromiseDoubleOrErrorCompletion handler))work NS_SWIFT_UNAVAILABLE("");
+
 @end
 
 /**
@@ -15,9 +15,25 @@
  */
 
 #import "FSLPromiseError.h"
+#import "FSLPromiseExecutor.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ Possible ways to invoke the blocks observing a promise.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseExecutionPolicy) {
+  /** Blocks are always dispatched asynchronously on their queue. */
+  FSLPromiseExecutionPolicyAsync = 0,
+  /**
+   Blocks are invoked synchronously if the promise is already resolved and the caller is itself a
+   promise block running on the same queue, and are dispatched asynchronously otherwise.
+   Synchronous invocations are nested up to a fixed depth, after which the blocks are deferred
+   until the outermost block on that queue returns, so long chains cannot overflow the stack.
+   */
+  FSLPromiseExecutionPolicyInline,
+} NS_REFINED_FOR_SWIFT;
+
 /**
  Promises synchronization construct in Objective-C.
  */
@@ -28,6 +44,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(class) dispatch_queue_t defaultDispatchQueue NS_REFINED_FOR_SWIFT;
 
+/**
+ Granularity of the timers used by `delay`, `timeout` and `retry`, in seconds. Those timers fire
+ within one tick after their interval elapses, and share a single GCD timer which wakes up once per
+ tick while any of them is scheduled. Defaults to 10 milliseconds. Changing it only affects the
+ timers scheduled afterwards.
+ */
+@property(class) NSTimeInterval timerTickInterval NS_REFINED_FOR_SWIFT;
+
+/**
+ Policy to invoke the blocks observing the promise with, which is inherited by the promises
+ chained to it. Defaults to `FSLPromiseExecutionPolicyAsync`.
+ Must be set before any blocks are chained to the promise.
+ */
+@property(nonatomic) FSLPromiseExecutionPolicy executionPolicy NS_REFINED_FOR_SWIFT;
+
 /**
  Creates a pending promise.
  */
@@ -55,6 +86,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)reject:(NSError *)error NS_REFINED_FOR_SWIFT;
 
+/**
+ Synchronously rejects the promise with `FSLPromiseErrorCodeCancelled` error code in
+ `FSLPromiseErrorDomain`, unless it has been resolved already.
+ Cancellation tears down the pending timers and subscriptions made on behalf of the promise, and
+ propagates to the promises it waits for, which get cancelled in turn if nothing else observes
+ them anymore. Rejecting a promise with a cancellation error is equivalent to cancelling it.
+ */
+- (void)cancel NS_REFINED_FOR_SWIFT;
+
 + (instancetype)new NS_UNAVAILABLE;
 - (instancetype)init NS_UNAVAILABLE;
 @end
@@ -0,0 +1,139 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Possible states of a circuit breaker.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseCircuitBreakerState) {
+  /** Work is performed, and its failure rate is tracked. */
+  FSLPromiseCircuitBreakerStateClosed = 0,
+  /** Work is rejected without being performed until the cool-down has passed. */
+  FSLPromiseCircuitBreakerStateOpen,
+  /** A limited number of probes are performed to decide whether to close or open again. */
+  FSLPromiseCircuitBreakerStateHalfOpen,
+} NS_REFINED_FOR_SWIFT;
+
+typedef id __nullable (^FSLPromiseCircuitBreakerWorkBlock)(void) NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Guards promise-returning work against a failing dependency. The breaker tracks the rate of failed
+ work over a sliding window and opens once it reaches a threshold. While open, the breaker rejects
+ new work right away with `FSLPromiseErrorCodeCircuitOpen` instead of performing it, so that the
+ work doomed to fail doesn't pile up. After a cool-down, the breaker lets a few probes through and
+ closes on the first one to succeed, or opens again on the first one to fail.
+ Checking and updating the state is lock-free.
+ */
+@interface FSLPromiseCircuitBreaker : NSObject
+
+/**
+ The current state.
+ */
+@property(nonatomic, readonly) FSLPromiseCircuitBreakerState state;
+
+/**
+ Creates a closed circuit breaker.
+
+ @param threshold Rate of failed work, between 0 and 1, to open at.
+ @param count Min number of results in the window to open at, so that a few early failures don't.
+ @param windowInterval Time over which to track the rate of failed work.
+ @param coolDownInterval Time to stay open for before letting probes through.
+ @param probesCount Max number of probes to let through at a time, treated as 1 if zero.
+ */
+- (instancetype)initWithFailureRateThreshold:(double)threshold
+                              minResultsCount:(NSUInteger)count
+                               windowInterval:(NSTimeInterval)windowInterval
+                             coolDownInterval:(NSTimeInterval)coolDownInterval
+                                  probesCount:(NSUInteger)probesCount NS_DESIGNATED_INITIALIZER;
+
+/**
+ Performs `work` asynchronously on the default queue if the breaker lets it through, and records its
+ result.
+
+ @param work A block that returns a value, an error or a promise.
+ @return A new pending promise resolved with the same resolution as `work`, or a promise rejected
+         with `FSLPromiseErrorCodeCircuitOpen` if the breaker is open.
+ */
+- (FSLPromise *)execute:(FSLPromiseCircuitBreakerWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Performs `work` asynchronously on the given `queue` if the breaker lets it through, and records its
+ result.
+
+ @param queue A queue to invoke the `work` block on.
+ @param work A block that returns a value, an error or a promise.
+ @return A new pending promise resolved with the same resolution as `work`, or a promise rejected
+         with `FSLPromiseErrorCodeCircuitOpen` if the breaker is open.
+ */
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+                execute:(FSLPromiseCircuitBreakerWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `onQueue:execute:`, but also rejects with `FSLPromiseErrorCodeTimedOut` and records a
+ failure if `work` doesn't resolve within the given `interval`, so that hanging work trips the
+ breaker too.
+
+ @param queue A queue to invoke the `work` block on.
+ @param interval Time to wait for `work` to resolve.
+ @param work A block that returns a value, an error or a promise.
+ @return A new pending promise resolved with the same resolution as `work`, or a promise rejected
+         with `FSLPromiseErrorCodeCircuitOpen` if the breaker is open.
+ */
+- (FSLPromise *)onQueue:(dispatch_queue_t)queue
+                timeout:(NSTimeInterval)interval
+                execute:(FSLPromiseCircuitBreakerWorkBlock)work NS_REFINED_FOR_SWIFT;
+
+/**
+ Same as `onQueue:timeout:execute:`, but invokes the `work` block via `executor`.
+
+ @param executor An executor to invoke the `work` block with.
+ @param interval Time to wait for `work` to resolve, or zero to wait indefinitely.
+ @param work A block that returns a value, an error or a promise.
+ @return A new pending promise resolved with the same resolution as `work`, or a promise rejected
+         with `FSLPromiseErrorCodeCircuitOpen` if the breaker is open.
+ */
+- (FSLPromise *)onExecutor:(id<FSLPromiseExecutor>)executor
+                   timeout:(NSTimeInterval)interval
+                   execute:(FSLPromiseCircuitBreakerWorkBlock)work NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Checks whether the breaker lets work through, for work not performed with `execute:`.
+ In half-open state, takes one of the probes, which must then be given back by recording the result
+ of the work with `recordSuccess` or `recordFailure`.
+
+ @return YES if the work may be performed.
+ */
+- (BOOL)allowsWork;
+
+/**
+ Records successful work.
+ */
+- (void)recordSuccess;
+
+/**
+ Records failed work.
+ */
+- (void)recordFailure;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
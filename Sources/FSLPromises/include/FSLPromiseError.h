@@ -28,6 +28,10 @@ typedef NS_ENUM(NSInteger, FSLPromiseErrorCode) {
   FSLPromiseErrorCodeTimedOut = 1,
   /** Validation predicate returned false. */
   FSLPromiseErrorCodeValidationFailure = 2,
+  /** Promise was cancelled. */
+  FSLPromiseErrorCodeCancelled = 3,
+  /** Circuit breaker was open and rejected the work without performing it. */
+  FSLPromiseErrorCodeCircuitOpen = 4,
 } NS_REFINED_FOR_SWIFT;
 
 NS_INLINE BOOL FSLPromiseErrorIsTimedOut(NSError *error) NS_SWIFT_UNAVAILABLE("") {
@@ -40,4 +44,14 @@ NS_INLINE BOOL FSLPromiseErrorIsValidationFailure(NSError *error) NS_SWIFT_UNAVA
          error.code == FSLPromiseErrorCodeValidationFailure;
 }
 
+NS_INLINE BOOL FSLPromiseErrorIsCancelled(NSError *error) NS_SWIFT_UNAVAILABLE("") {
+  return error.domain == FSLPromiseErrorDomain &&
+         error.code == FSLPromiseErrorCodeCancelled;
+}
+
+NS_INLINE BOOL FSLPromiseErrorIsCircuitOpen(NSError *error) NS_SWIFT_UNAVAILABLE("") {
+  return error.domain == FSLPromiseErrorDomain &&
+         error.code == FSLPromiseErrorCodeCircuitOpen;
+}
+
 NS_ASSUME_NONNULL_END
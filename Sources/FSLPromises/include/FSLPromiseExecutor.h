@@ -0,0 +1,60 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Runs the blocks of promises, i.e. the observers of promises and the work blocks of combinators, as
+ an alternative to dispatch queues, e.g. a thread pool or a run loop pumped by the caller. All APIs
+ taking a `queue` have an overload taking an executor instead.
+ */
+@protocol FSLPromiseExecutor <NSObject>
+
+/**
+ Invokes `block` exactly once, on any thread. Invoking it before returning is allowed, though
+ promises resolved from within an executor which does so notify their observers recursively.
+ Executors invoking one block at a time are expected to invoke the blocks passed in order by the
+ same thread in that order, as a serial dispatch queue does.
+ */
+- (void)executeBlock:(dispatch_block_t)block;
+
+@end
+
+/**
+ Executor dispatching blocks asynchronously on a dispatch queue, e.g. to pass a queue to code
+ taking an executor. Promises recognize it and target its queue directly, so passing one costs the
+ same as passing its queue.
+ */
+@interface FSLPromiseDispatchQueueExecutor : NSObject <FSLPromiseExecutor>
+
+/**
+ Queue to dispatch the blocks on.
+ */
+@property(nonatomic, readonly) dispatch_queue_t queue;
+
+/**
+ Creates an executor dispatching blocks on `queue`.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
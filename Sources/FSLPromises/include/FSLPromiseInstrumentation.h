@@ -0,0 +1,142 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Kinds of events reported about the promise runtime.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseInstrumentationEventKind) {
+  /** A promise has been created, either pending or resolved. */
+  FSLPromiseInstrumentationEventKindCreated = 0,
+  /** A pending promise has been fulfilled. */
+  FSLPromiseInstrumentationEventKindFulfilled,
+  /** A pending promise has been rejected, including by cancellation. */
+  FSLPromiseInstrumentationEventKindRejected,
+  /** An observer has been registered on a promise. */
+  FSLPromiseInstrumentationEventKindObserved,
+  /** A block has been dispatched on a queue. */
+  FSLPromiseInstrumentationEventKindDispatched,
+  /** A combinator has been called. */
+  FSLPromiseInstrumentationEventKindCombinatorEntered,
+  /** A combinator has returned. */
+  FSLPromiseInstrumentationEventKindCombinatorExited,
+  /** A promise has been chained on another one, e.g. with `then`. */
+  FSLPromiseInstrumentationEventKindChained,
+  /** Observers of a resolved promise have started running on a queue. */
+  FSLPromiseInstrumentationEventKindContinuationBegan,
+  /** Observers of a resolved promise have finished running on a queue. */
+  FSLPromiseInstrumentationEventKindContinuationEnded,
+  /**
+   A pending promise has adopted another one, e.g. returned from a `then` block, and gets resolved
+   along with it from now on, so it's not pending on its own anymore.
+   */
+  FSLPromiseInstrumentationEventKindForwarded,
+} NS_REFINED_FOR_SWIFT;
+
+/**
+ An event reported about the promise runtime.
+ */
+typedef struct {
+  /** What happened. */
+  FSLPromiseInstrumentationEventKind kind;
+  /** Monotonic time of the event in nanoseconds. */
+  uint64_t timestamp;
+  /** Small number identifying the thread the event happened on, assigned on its first event. */
+  uint64_t threadID;
+  /**
+   Address of the promise the event is about, or zero for dispatch and combinator events. Only meant
+   to correlate events, since the object may be gone by now.
+   */
+  uintptr_t object;
+  /**
+   Address of the promise the one the event is about has been chained on, for chain events, or has
+   adopted, for forward events.
+   */
+  uintptr_t parent;
+  /**
+   Time in nanoseconds the promise has been pending for, for resolution and forward events, or zero
+   if it was created while there was no sink.
+   */
+  uint64_t pendingInterval;
+  /**
+   Name of the combinator for combinator events, or label of the queue for dispatch and continuation
+   events, which is valid forever.
+   */
+  char const *__nullable name;
+} FSLPromiseInstrumentationEvent;
+
+/**
+ Receives events recorded about the promise runtime.
+ */
+@protocol FSLPromiseInstrumentationSink <NSObject>
+
+/**
+ Invoked synchronously on a thread with a batch of events recorded on it, in order, once its buffer
+ is full or gets flushed. May be invoked concurrently from different threads, so is expected to
+ return quickly without blocking. Events recorded by the sink itself while handling a batch are
+ dropped.
+
+ @param events Events valid only until the method returns.
+ @param count Number of events.
+ */
+- (void)promiseInstrumentationDidRecordEvents:(FSLPromiseInstrumentationEvent const *)events
+                                        count:(NSUInteger)count;
+
+@end
+
+/**
+ Reports what the promise runtime does, i.e. the promise creation, chaining and resolution,
+ observer registration, dispatch on queues, continuations, and combinator entry and exit, to a
+ pluggable sink.
+ The hooks are only compiled in if `FSL_PROMISES_INSTRUMENTATION_IS_ENABLED` is defined at compile
+ time, and cost a single atomic load each while there's no sink. Events are buffered per thread
+ behind a lock only ever contended by `flushAllThreads`, and handed to the sink in batches.
+ */
+@interface FSLPromiseInstrumentation : NSObject
+
+/**
+ Whether the hooks are compiled in, i.e. the sink can receive any events at all.
+ */
+@property(class, nonatomic, readonly, getter=isEnabled) BOOL enabled;
+
+/**
+ The sink to hand the recorded events to, or `nil` to stop recording. Sinks set here are never
+ released, so that threads can keep handing events to the previous one without locks.
+ */
+@property(class, nullable) id<FSLPromiseInstrumentationSink> sink;
+
+/**
+ Hands the events buffered on the current thread to the sink right away. The buffers of other
+ threads get flushed once full or once their threads exit.
+ */
++ (void)flush;
+
+/**
+ Hands the events buffered on all threads to the sink right away, from the current thread, e.g.
+ before exporting what the sink has received. Threads recording events meanwhile wait for their
+ buffer to be flushed.
+ */
++ (void)flushAllThreads;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,127 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Latencies measured by `FSLPromiseLatencyHistograms`.
+ */
+typedef NS_ENUM(NSInteger, FSLPromiseLatencyMetric) {
+  /** Time from the creation of a pending promise to its fulfillment or rejection. */
+  FSLPromiseLatencyMetricPending = 0,
+  /** Time from dispatching an observer on its queue to the queue starting to run it. */
+  FSLPromiseLatencyMetricQueueWait,
+  /** Time an observer takes to run. */
+  FSLPromiseLatencyMetricRun,
+} NS_REFINED_FOR_SWIFT;
+
+/**
+ Snapshot of the latencies of one metric, combinator and label, bucketed with a relative precision
+ of 1/16 from 1 nanosecond up to about 18 minutes.
+ */
+@interface FSLPromiseLatencyHistogram : NSObject
+
+/**
+ Latency measured.
+ */
+@property(nonatomic, readonly) FSLPromiseLatencyMetric metric;
+
+/**
+ Name of the combinator, e.g. `then`, that created the promise or registered the observer, or `nil`
+ if none did, e.g. for promises created with `pendingPromise`.
+ */
+@property(nonatomic, readonly, nullable) NSString *combinator;
+
+/**
+ Label the promise or the observer has been created with, if any.
+ */
+@property(nonatomic, readonly, nullable) NSString *label;
+
+/**
+ Number of latencies recorded.
+ */
+@property(nonatomic, readonly) uint64_t count;
+
+/**
+ Sum of the latencies recorded, in seconds.
+ */
+@property(nonatomic, readonly) NSTimeInterval totalInterval;
+
+/**
+ Returns the upper bound of the bucket the latency at the given percentile falls into, in seconds,
+ or zero if nothing has been recorded.
+
+ @param percentile Percentile between 0 and 100.
+ */
+- (NSTimeInterval)intervalAtPercentile:(double)percentile;
+
+/**
+ Enumerates the non-empty buckets in increasing order of latency, with their bounds in seconds.
+ */
+- (void)enumerateBucketsUsingBlock:(void (^)(NSTimeInterval lowerBound, NSTimeInterval upperBound,
+                                             uint64_t count))block;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ Measures how long promises stay pending, how long their observers wait in queues, and how long
+ the observers take to run, bucketed by the combinator that created the promise or registered the
+ observer, and by an optional label.
+ The measures are only taken if `FSL_PROMISES_INSTRUMENTATION_IS_ENABLED` is defined at compile
+ time, and cost a single atomic load per hook while disabled. Each thread accumulates them into its
+ own histograms without locks or atomic read-modify-write operations, and the histograms of all
+ threads are merged when taking a snapshot. Promises resolved by adopting another promise, e.g. one
+ returned from a `then` block, are accounted for by the adopted promise instead.
+ */
+@interface FSLPromiseLatencyHistograms : NSObject
+
+/**
+ Whether latencies get recorded. Defaults to NO.
+ */
+@property(class, getter=isEnabled) BOOL enabled;
+
+/**
+ Invokes `work` synchronously, labeling the promises created and the observers registered from it
+ on the current thread, as well as the ones created and registered from those observers in turn.
+ Up to 255 distinct labels are kept apart, and any others are ignored.
+
+ @param label Label to record the latencies under, e.g. the name of the call site.
+ @param work Block to invoke.
+ */
++ (void)performWithLabel:(NSString *)label work:(NS_NOESCAPE void (^)(void))work;
+
+/**
+ Merges the histograms of all threads recorded since the last reset.
+
+ @return Non-empty histograms, in no particular order.
+ */
++ (NSArray<FSLPromiseLatencyHistogram *> *)snapshot;
+
+/**
+ Starts recording the latencies from scratch, as far as snapshots are concerned.
+ */
++ (void)reset;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
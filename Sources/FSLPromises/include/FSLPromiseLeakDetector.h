@@ -0,0 +1,107 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A promise tracked by `FSLPromiseLeakDetector`, which either has been pending for too long or has
+ been deallocated while still pending.
+ */
+@interface FSLPromiseLeak : NSObject
+
+/**
+ Address of the promise, only meant to tell promises apart, since the object may be gone by now.
+ */
+@property(nonatomic, readonly) uintptr_t address;
+
+/**
+ Class of the promise.
+ */
+@property(nonatomic, readonly) Class promiseClass;
+
+/**
+ Time in seconds the promise has been pending for, until it was deallocated or the report was made.
+ */
+@property(nonatomic, readonly) NSTimeInterval pendingInterval;
+
+/**
+ Whether the promise has been deallocated while still pending.
+ */
+@property(nonatomic, readonly, getter=isDeallocated) BOOL deallocated;
+
+/**
+ Symbolicated call stack the promise was created with, or `nil` if it was not sampled.
+ */
+@property(nonatomic, readonly, nullable) NSArray<NSString *> *creationCallStackSymbols;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ Keeps track of the pending promises to find the ones that never get resolved, e.g. because of a
+ forgotten `reject` path, and keep their observers and pending objects alive for as long as they
+ live. Promises created while the detector is enabled get registered along with their creation time
+ and, for a sample of them, their creation call stack, and get unregistered once resolved.
+ The registry is split into shards by promise address, each guarded by its own lock, so that
+ threads creating and resolving promises concurrently rarely contend, which makes the detector
+ cheap enough to leave on in production canaries. While disabled, it costs a single atomic load per
+ pending promise created.
+ */
+@interface FSLPromiseLeakDetector : NSObject
+
+/**
+ Whether pending promises created from now on get tracked. Disabling the detector doesn't forget
+ about the promises tracked already. Defaults to NO.
+ */
+@property(class, getter=isEnabled) BOOL enabled;
+
+/**
+ Captures the creation call stack of one in every that many tracked promises, or of none if zero.
+ Defaults to 100.
+ */
+@property(class) NSUInteger callStackSamplingInterval;
+
+/**
+ Number of promises tracked and still pending.
+ */
+@property(class, readonly) NSUInteger pendingPromisesCount;
+
+/**
+ Returns the tracked promises that have been pending for at least `interval` seconds, the oldest
+ first.
+ */
++ (NSArray<FSLPromiseLeak *> *)pendingPromisesOlderThan:(NSTimeInterval)interval;
+
+/**
+ Returns the latest tracked promises deallocated while still pending since the last reset, the
+ oldest first. Only the latest 1024 are kept.
+ */
++ (NSArray<FSLPromiseLeak *> *)deallocatedPendingPromises;
+
+/**
+ Forgets about all tracked promises and deallocated pending promises reported so far.
+ */
++ (void)reset;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -15,6 +15,8 @@
  */
 
 #import "FSLPromise+Testing.h"
+#import "FSLPromiseInstrumentation.h"
+#import "FSLPromiseLatencyHistograms.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -51,6 +53,96 @@ typedef id __nullable (^__nullable FSLPromiseChainedRejectBlock)(NSError *error)
                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
                 reject:(FSLPromiseOnRejectBlock)onReject NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Same as `observeOnQueue:fulfill:reject:`, but invokes the blocks according to `policy` instead of
+ the receiver's `executionPolicy`.
+ */
+- (void)observeOnQueue:(dispatch_queue_t)queue
+                policy:(FSLPromiseExecutionPolicy)policy
+               fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                reject:(FSLPromiseOnRejectBlock)onReject NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `observeOnQueue:fulfill:reject:`, but invokes the blocks on `target`.
+ */
+- (void)observeOnTarget:(void *)target
+                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                 reject:(FSLPromiseOnRejectBlock)onReject NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `observeOnQueue:policy:fulfill:reject:`, but invokes the blocks on `target`.
+ */
+- (void)observeOnTarget:(void *)target
+                 policy:(FSLPromiseExecutionPolicy)policy
+                fulfill:(FSLPromiseOnFulfillBlock)onFulfill
+                 reject:(FSLPromiseOnRejectBlock)onReject NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Invokes `handler` synchronously once the receiver gets cancelled, or right away if it has been
+ cancelled already. The handler is released without being invoked if the receiver gets resolved
+ otherwise.
+ */
+- (void)addCancellationHandler:(dispatch_block_t)handler NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Makes the receiver stop observing `promise` once the receiver gets cancelled. The `promise` gets
+ cancelled in turn if the receiver was its last observer. Must be paired with one observer
+ registered on `promise` on behalf of the receiver.
+ */
+- (void)propagateCancellationToPromise:(FSLPromise *)promise NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Lets the receiver know that one of its observers has lost interest in it, and cancels the receiver
+ if that was the last one. Must be called at most once per observer.
+ */
+- (void)detachObserver NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Cancels the receiver unless anything observes it, as registering an observer and detaching it
+ right away would, e.g. for a promise that nothing is interested in anymore by the time it's
+ received.
+ */
+- (void)cancelUnlessObserved NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Resolves the receiver with the eventual resolution of `promise`, without observing it.
+ Instead, the pending receiver starts forwarding its observers and pending objects to `promise`,
+ so that a chain of promises resolving one another collapses into one, and ignores any further
+ resolution attempts. The receiver counts as a single observer of `promise`, which it detaches
+ when cancelled, so that `promise` only gets cancelled if nothing else observes it.
+ */
+- (void)adoptPromise:(FSLPromise *)promise NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Asynchronously dispatches a block on `queue`, tracking it in the dispatch group the receiver was
+ created in, if any.
+ */
+- (void)dispatchOnQueue:(dispatch_queue_t)queue
+                  block:(dispatch_block_t)block NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `dispatchOnQueue:block:`, but invokes the block on `target`.
+ */
+- (void)dispatchOnTarget:(void *)target block:(dispatch_block_t)block NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Dispatches a block on `queue` after `interval` seconds, unless the receiver gets cancelled first.
+ Non-positive intervals dispatch the block right away, and intervals shorter than a tick of the
+ timer wheel don't go through the wheel, so that they aren't rounded up to a whole tick.
+
+ @return A block to cancel the timer with, which is safe to invoke at any time.
+ */
+- (dispatch_block_t)dispatchAfterInterval:(NSTimeInterval)interval
+                                  onQueue:(dispatch_queue_t)queue
+                                    block:(dispatch_block_t)block NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `dispatchAfterInterval:onQueue:block:`, but invokes the block on `target`.
+ */
+- (dispatch_block_t)dispatchAfterInterval:(NSTimeInterval)interval
+                                 onTarget:(void *)target
+                                    block:(dispatch_block_t)block NS_SWIFT_UNAVAILABLE("");
+
 /**
  Returns a new promise which gets resolved with the return value of `chainedFulfill` or
  `chainedReject` blocks respectively. The blocks are invoked when the receiver gets either
@@ -61,6 +153,237 @@ typedef id __nullable (^__nullable FSLPromiseChainedRejectBlock)(NSError *error)
               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject NS_SWIFT_UNAVAILABLE("");
 
+/**
+ Same as `chainOnQueue:chainedFulfill:chainedReject:`, but invokes the blocks according to
+ `policy` instead of the receiver's `executionPolicy`.
+ */
+- (FSLPromise *)chainOnQueue:(dispatch_queue_t)queue
+                      policy:(FSLPromiseExecutionPolicy)policy
+              chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+               chainedReject:(FSLPromiseChainedRejectBlock)chainedReject NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `chainOnQueue:chainedFulfill:chainedReject:`, but invokes the blocks on `target`.
+ */
+- (FSLPromise *)chainOnTarget:(void *)target
+               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject NS_SWIFT_UNAVAILABLE("");
+
+/**
+ Same as `chainOnQueue:policy:chainedFulfill:chainedReject:`, but invokes the blocks on `target`.
+ */
+- (FSLPromise *)chainOnTarget:(void *)target
+                       policy:(FSLPromiseExecutionPolicy)policy
+               chainedFulfill:(FSLPromiseChainedFulfillBlock)chainedFulfill
+                chainedReject:(FSLPromiseChainedRejectBlock)chainedReject NS_SWIFT_UNAVAILABLE("");
+
 @end
 
+@interface FSLPromise<Value>(TimeoutPrivateAdditions)
+
+/**
+ Same as `onQueue:timeout:`, but resolves the promise on `target`.
+ */
+- (FSLPromise *)onTarget:(void *)target timeout:(NSTimeInterval)interval NS_SWIFT_UNAVAILABLE("");
+
+@end
+
+/**
+ Returns the target to invoke blocks on `queue` with. Combinators implement their variants taking
+ a queue and taking an executor once, on top of a target, which points to either a queue or an
+ executor without wrapping one into the other. Blocks capturing a target don't retain what it
+ points to, so they may only use it while invoked on that target, which keeps it alive meanwhile,
+ or while the caller does.
+ */
+FOUNDATION_EXTERN void *FSLPromiseTargetWithQueue(dispatch_queue_t queue);
+
+/**
+ Returns the target to invoke blocks via `executor` with, which is the queue of `executor` if it's
+ an `FSLPromiseDispatchQueueExecutor`.
+ */
+FOUNDATION_EXTERN void *FSLPromiseTargetWithExecutor(id<FSLPromiseExecutor> executor);
+
+/**
+ Registers a pending promise with `FSLPromiseLeakDetector`, unless it's disabled.
+
+ @return YES if the promise has been registered and must be unregistered once not pending anymore.
+ */
+FOUNDATION_EXTERN BOOL FSLPromiseLeakDetectorTrack(void const *promise);
+
+/**
+ Unregisters a promise registered with `FSLPromiseLeakDetectorTrack` once it's not pending anymore,
+ and reports it if it has been deallocated while still pending.
+ */
+FOUNDATION_EXTERN void FSLPromiseLeakDetectorUntrack(void const *promise, BOOL deallocated);
+
+/**
+ Records an event in the buffer of the current thread, unless there's no sink.
+ Prefer the `FSL_PROMISES_INSTRUMENT` macros, which compile away when instrumentation is disabled.
+
+ @param creationTime Time the promise was created at, to compute the pending interval from.
+ @return Time the event was recorded at, or zero if there's no sink.
+ */
+FOUNDATION_EXTERN uint64_t FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKind kind,
+                                                           void const *__nullable object,
+                                                           void const *__nullable parent,
+                                                           uint64_t creationTime,
+                                                           char const *__nullable name);
+
+/**
+ Same as `FSLPromiseInstrumentationRecord`, but names the event after the label of `queue`, which
+ is only looked up if there's a sink, or leaves it unnamed if `queue` is nil.
+ */
+FOUNDATION_EXTERN void FSLPromiseInstrumentationRecordOnQueue(
+    FSLPromiseInstrumentationEventKind kind, void const *__nullable object,
+    dispatch_queue_t __nullable queue);
+
+/**
+ Returns the current time to measure latencies from, or zero if `FSLPromiseLatencyHistograms` is
+ disabled.
+ */
+FOUNDATION_EXTERN uint64_t FSLPromiseLatencyNow(void);
+
+/**
+ Returns the key to record the latencies of a promise or an observer created on the current thread
+ under, according to the current combinator and label, or zero if they are not to be recorded.
+ */
+FOUNDATION_EXTERN uint16_t FSLPromiseLatencyCurrentKey(void);
+
+/**
+ Records the latency from `startTime` to now under `key`, unless either is zero.
+
+ @return Current time, or zero if nothing has been recorded.
+ */
+FOUNDATION_EXTERN uint64_t FSLPromiseLatencyRecord(FSLPromiseLatencyMetric metric, uint16_t key,
+                                                   uint64_t startTime);
+
+/**
+ Makes the combinator `name` the current one on this thread, unless there's one already.
+
+ @return Context to restore once the combinator returns.
+ */
+FOUNDATION_EXTERN uint16_t FSLPromiseLatencyEnterCombinator(char const *name);
+
+/** Restores the context returned by `FSLPromiseLatencyEnterCombinator`. */
+FOUNDATION_EXTERN void FSLPromiseLatencyRestoreContext(uint16_t context);
+
+/** Observer being run, as declared by `FSL_PROMISES_MEASURE_CONTINUATION`. */
+typedef struct {
+  uint16_t key;
+  uint16_t previousContext;
+  uint64_t startTime;
+} FSLPromiseLatencyContinuation;
+
+/**
+ Records the time an observer dispatched at `dispatchTime` has waited in its queue for, and makes
+ its label the current one on this thread.
+ */
+FOUNDATION_EXTERN FSLPromiseLatencyContinuation
+FSLPromiseLatencyBeginContinuation(uint16_t key, uint64_t dispatchTime);
+
+/** Records the time an observer has run for, and restores the previous context. */
+FOUNDATION_EXTERN void FSLPromiseLatencyEndContinuation(
+    FSLPromiseLatencyContinuation const *continuation);
+
+#ifdef FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+
+/** Combinator declared by `FSL_PROMISES_INSTRUMENT_COMBINATOR`. */
+typedef struct {
+  char const *name;
+  uint16_t previousLatencyContext;
+} FSLPromiseInstrumentationCombinator;
+
+/** Promise and queue of the continuation declared by `FSL_PROMISES_INSTRUMENT_CONTINUATION`. */
+typedef struct {
+  void const *promise;
+  void const *queue;
+} FSLPromiseInstrumentationContinuation;
+
+/**
+ Records the exit of a combinator, as a cleanup of the variable declared by
+ `FSL_PROMISES_INSTRUMENT_COMBINATOR`.
+ */
+static inline void FSLPromiseInstrumentationExitCombinator(
+    FSLPromiseInstrumentationCombinator const *combinator) {
+  FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKindCombinatorExited, NULL, NULL, 0,
+                                  combinator->name);
+  FSLPromiseLatencyRestoreContext(combinator->previousLatencyContext);
+}
+
+/**
+ Records the end of a continuation, as a cleanup of the variable declared by
+ `FSL_PROMISES_INSTRUMENT_CONTINUATION`.
+ */
+static inline void FSLPromiseInstrumentationEndContinuation(
+    FSLPromiseInstrumentationContinuation const *continuation) {
+  FSLPromiseInstrumentationRecordOnQueue(FSLPromiseInstrumentationEventKindContinuationEnded,
+                                         continuation->promise,
+                                         (__bridge dispatch_queue_t)continuation->queue);
+}
+
+/** Records an event of the given kind about `object`, e.g. `Observed` about a promise. */
+#define FSL_PROMISES_INSTRUMENT(kind, object)                                                   \
+  FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKind##kind,                     \
+                                  (__bridge void const *)(object), NULL, 0, NULL)
+
+/** Records that `promise` has been chained on `parent`. */
+#define FSL_PROMISES_INSTRUMENT_CHAIN(promise, parent)                                          \
+  FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKindChained,                    \
+                                  (__bridge void const *)(promise),                             \
+                                  (__bridge void const *)(parent), 0, NULL)
+
+/** Records a block dispatched on `queue`. */
+#define FSL_PROMISES_INSTRUMENT_DISPATCH(queue)                                                 \
+  FSLPromiseInstrumentationRecordOnQueue(FSLPromiseInstrumentationEventKindDispatched, NULL, queue)
+
+/**
+ Records the entry into the combinator `name` right away, and the exit at the end of scope.
+ Latencies of the promises and observers created in between are recorded under its name.
+ */
+#define FSL_PROMISES_INSTRUMENT_COMBINATOR(name)                                                \
+  FSLPromiseInstrumentationRecord(FSLPromiseInstrumentationEventKindCombinatorEntered, NULL,    \
+                                  NULL, 0, name);                                               \
+  FSLPromiseInstrumentationCombinator FSLPromiseInstrumentationCombinator                       \
+      __attribute__((cleanup(FSLPromiseInstrumentationExitCombinator), unused)) = {             \
+          name, FSLPromiseLatencyEnterCombinator(name)}
+
+/**
+ Records the beginning of a continuation of `promise` on `queue` right away, and its end at the end
+ of scope.
+ */
+#define FSL_PROMISES_INSTRUMENT_CONTINUATION(promise, queue)                                    \
+  FSLPromiseInstrumentationRecordOnQueue(FSLPromiseInstrumentationEventKindContinuationBegan,   \
+                                         (__bridge void const *)(promise), queue);              \
+  FSLPromiseInstrumentationContinuation FSLPromiseInstrumentationContinuation                   \
+      __attribute__((cleanup(FSLPromiseInstrumentationEndContinuation), unused)) = {            \
+          (__bridge void const *)(promise), (__bridge void const *)(queue)}
+
+/** Returns the key to record the latencies of an observer registered now under. */
+#define FSL_PROMISES_LATENCY_KEY() FSLPromiseLatencyCurrentKey()
+
+/** Returns the time an observer gets dispatched at, to measure its wait in the queue from. */
+#define FSL_PROMISES_LATENCY_NOW() FSLPromiseLatencyNow()
+
+/**
+ Records the time an observer with the latency `key` has waited in its queue since `dispatchTime`
+ right away, and the time it has run for at the end of scope.
+ */
+#define FSL_PROMISES_MEASURE_CONTINUATION(key, dispatchTime)                                    \
+  FSLPromiseLatencyContinuation FSLPromiseLatencyContinuation                                   \
+      __attribute__((cleanup(FSLPromiseLatencyEndContinuation), unused)) =                      \
+          FSLPromiseLatencyBeginContinuation(key, dispatchTime)
+
+#else
+
+#define FSL_PROMISES_INSTRUMENT(kind, object)
+#define FSL_PROMISES_INSTRUMENT_CHAIN(promise, parent)
+#define FSL_PROMISES_INSTRUMENT_DISPATCH(queue)
+#define FSL_PROMISES_INSTRUMENT_COMBINATOR(name)
+#define FSL_PROMISES_INSTRUMENT_CONTINUATION(promise, queue)
+#define FSL_PROMISES_LATENCY_KEY() 0
+#define FSL_PROMISES_LATENCY_NOW() 0
+#define FSL_PROMISES_MEASURE_CONTINUATION(key, dispatchTime)
+
+#endif  // FSL_PROMISES_INSTRUMENTATION_IS_ENABLED
+
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,72 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Fixed-size buffer for the results of a group of promises combined into one, filled in place as
+ each of them settles, with atomic counts of those yet to settle and of those rejected.
+ */
+@interface FSLPromiseResults : NSObject
+
+/**
+ Number of results.
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ Number of results set with `setError:atIndex:`.
+ Must only be accessed after all results have been set.
+ */
+@property(nonatomic, readonly) NSUInteger errorsCount;
+
+/**
+ Results in order, with `NSNull` in place of `nil`.
+ Must only be accessed after all results have been set.
+ */
+@property(nonatomic, readonly) NSArray *array;
+
+/**
+ Returns the result at `index` as set, including `nil`.
+ Must only be accessed after all results have been set.
+ */
+- (nullable id)objectAtIndex:(NSUInteger)index;
+
+/**
+ Creates a buffer for `count` results.
+ */
+- (instancetype)initWithCount:(NSUInteger)count NS_DESIGNATED_INITIALIZER;
+
+/**
+ Stores a result, which must happen exactly once per index, from any thread.
+
+ @return YES if that was the last result to set.
+ */
+- (BOOL)setObject:(nullable id)object atIndex:(NSUInteger)index;
+
+/**
+ Same as `setObject:atIndex:`, but also counts the result as an error.
+ */
+- (BOOL)setError:(NSError *)error atIndex:(NSUInteger)index;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
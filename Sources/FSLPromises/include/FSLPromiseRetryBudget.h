@@ -0,0 +1,73 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Token bucket shared by many retry operations to cap the ratio of retries to successful attempts,
+ so that clients stop retrying in bulk when a dependency is overloaded, instead of amplifying the
+ load on it. The bucket starts full. Every failed attempt takes one token and every successful one
+ puts back `tokenRatio` tokens, up to `maxTokens`. Retries are allowed while the bucket is more than
+ half full.
+ */
+@interface FSLPromiseRetryBudget : NSObject
+
+/**
+ Max number of tokens the bucket holds, which it starts with.
+ */
+@property(nonatomic, readonly) NSUInteger maxTokens;
+
+/**
+ Number of tokens put back into the bucket by each successful attempt.
+ */
+@property(nonatomic, readonly) double tokenRatio;
+
+/**
+ Number of tokens currently in the bucket.
+ */
+@property(nonatomic, readonly) double tokens;
+
+/**
+ Creates a full bucket.
+
+ @param maxTokens Max number of tokens, which also bounds the number of retries in a row when all
+                  attempts fail. Treated as 1 if zero.
+ @param tokenRatio Number of tokens put back by each successful attempt, which roughly caps the
+                   ratio of retries to successful attempts in the long run.
+ */
+- (instancetype)initWithMaxTokens:(NSUInteger)maxTokens
+                       tokenRatio:(double)tokenRatio NS_DESIGNATED_INITIALIZER;
+
+/**
+ Puts `tokenRatio` tokens back into the bucket for a successful attempt.
+ */
+- (void)recordSuccess;
+
+/**
+ Takes a token from the bucket for a failed attempt.
+
+ @return YES if the failed attempt may be retried.
+ */
+- (BOOL)recordFailure;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
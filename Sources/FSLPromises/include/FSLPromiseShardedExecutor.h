@@ -0,0 +1,74 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseExecutor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Fixed set of serial executors, called shards, each running blocks in order on its own thread.
+ Keys, e.g. user or connection identifiers, map to a stable shard by their hash, so that the work
+ for a key is serialized without creating a serial dispatch queue per key, e.g. by passing the
+ executor returned by `executorForKey:` to `onExecutor:then:`.
+
+ Keys equal per `isEqual:` have equal hashes, so they share a shard, while distinct keys may share
+ one too. Once the sharded executor gets deallocated, the shard executors obtained from it keep
+ running blocks until released.
+ */
+@interface FSLPromiseShardedExecutor : NSObject
+
+/**
+ Number of shards.
+ */
+@property(nonatomic, readonly) NSUInteger shardsCount;
+
+/**
+ Whether the thread of each shard is pinned to a processor. Only supported on Linux.
+ */
+@property(nonatomic, readonly) BOOL pinsShardsToProcessors;
+
+/**
+ Creates a sharded executor with one shard per active processor, not pinned.
+ */
+- (instancetype)init;
+
+/**
+ Creates a sharded executor with `shardsCount` shards, which must be positive. On Linux, the thread
+ of each shard may be pinned to one of the processors the creating thread is allowed to run on,
+ round-robin, so that the data of a key stays in the cache of the same core.
+ */
+- (instancetype)initWithShardsCount:(NSUInteger)shardsCount
+             pinsShardsToProcessors:(BOOL)pinsShardsToProcessors NS_DESIGNATED_INITIALIZER;
+
+/**
+ Returns the index of the shard for `key`.
+ */
+- (NSUInteger)shardIndexForKey:(id<NSObject>)key;
+
+/**
+ Returns the serial executor of the shard for `key`, to pass to any API taking an executor.
+ */
+- (id<FSLPromiseExecutor>)executorForKey:(id<NSObject>)key;
+
+/**
+ Invokes `block` on the shard for `key`, after the blocks previously passed to that shard.
+ */
+- (void)executeBlock:(dispatch_block_t)block forKey:(id<NSObject>)key;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,78 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Timer scheduled on a `FSLPromiseTimerWheel`.
+ */
+@interface FSLPromiseTimer : NSObject
+
+/**
+ Removes the timer from its wheel and releases its block, unless it has fired already.
+ Safe to call at any time and from any thread.
+ */
+- (void)cancel;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ Hashed timer wheel backing the timers of promises: a ring of slots, each holding a doubly linked
+ list of the timers expiring at that slot in some round, with a cursor advanced by a single GCD
+ timer once per tick. Scheduling and cancelling a timer take constant time, and the GCD timer only
+ runs while the wheel has any timers. Timers fire within one tick after their interval elapses.
+ */
+@interface FSLPromiseTimerWheel : NSObject
+
+/**
+ Time between two consecutive ticks, in seconds.
+ */
+@property(nonatomic, readonly) NSTimeInterval tickInterval;
+
+/**
+ Creates a wheel with the default number of slots.
+ */
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval;
+
+/**
+ Creates a wheel.
+
+ @param tickInterval Time between two consecutive ticks, in seconds.
+ @param slotsCount Number of slots in the wheel. Timers further than that many ticks away are
+                   visited once per round until they expire.
+ */
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval
+                          slotsCount:(NSUInteger)slotsCount NS_DESIGNATED_INITIALIZER;
+
+/**
+ Dispatches a block on `queue` once `interval` seconds have elapsed.
+
+ @return A timer to cancel the block with.
+ */
+- (FSLPromiseTimer *)scheduleAfterInterval:(NSTimeInterval)interval
+                                   onQueue:(dispatch_queue_t)queue
+                                     block:(dispatch_block_t)block;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
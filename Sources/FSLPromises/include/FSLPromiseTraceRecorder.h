@@ -0,0 +1,85 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseInstrumentation.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Records the events reported by `FSLPromiseInstrumentation` and exports them in the Chrome Trace
+ Event format, which Perfetto and chrome://tracing can open. Each promise shows up as an async span
+ from its creation to its resolution, annotated with the promise it was chained on, if any.
+ Continuations show up as slices on the threads they ran on, named after their queues, with flow
+ arrows from the resolutions that triggered them, which makes serial bottlenecks and needless queue
+ hops stand out. Combinator calls show up as slices too.
+ Set as `FSLPromiseInstrumentation.sink` to start recording.
+ */
+@interface FSLPromiseTraceRecorder : NSObject <FSLPromiseInstrumentationSink>
+
+/**
+ Max number of events to keep, or zero if unbounded.
+ */
+@property(nonatomic, readonly) NSUInteger capacity;
+
+/**
+ Number of events kept so far.
+ */
+@property(nonatomic, readonly) NSUInteger eventsCount;
+
+/**
+ Number of events dropped to make room for newer ones since the last reset.
+ */
+@property(nonatomic, readonly) NSUInteger droppedEventsCount;
+
+/**
+ Creates a recorder that keeps all events.
+ */
+- (instancetype)init;
+
+/**
+ Creates a recorder that keeps the latest events in a ring buffer, to be able to run continuously
+ and dump the recent history on demand.
+
+ @param capacity Max number of events to keep, or zero to keep all of them.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ Exports the events kept so far, after flushing the ones buffered on the current thread.
+ The events still buffered on other threads are not included.
+
+ @return Chrome Trace Event JSON.
+ */
+- (NSData *)traceData;
+
+/**
+ Same as `traceData`, but writes the JSON to a file.
+
+ @param path Path of the file to write to.
+ @param error Error the file could not be written with, if any.
+ @return YES if the file has been written and NO otherwise.
+ */
+- (BOOL)writeTraceToFile:(NSString *)path error:(NSError **)error;
+
+/**
+ Drops all events kept so far.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
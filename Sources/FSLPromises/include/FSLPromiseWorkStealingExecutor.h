@@ -0,0 +1,56 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseExecutor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Executor running blocks on a fixed pool of threads, meant for CPU-bound chains of promises, e.g.
+ parsing or compression, which a concurrent dispatch queue spreads over more and more threads as
+ soon as some of its blocks block.
+
+ Each thread has its own deque of blocks. Blocks passed by a thread of the pool, e.g. the
+ observers of a promise resolved from one of its blocks, are pushed onto the deque of that thread,
+ which invokes the latest one first while the data it touches is likely still in cache. Threads
+ running out of blocks take the ones passed from outside of the pool in order, and then steal the
+ oldest blocks from the deques of the other threads.
+
+ Like a concurrent dispatch queue, the executor invokes blocks concurrently and in no particular
+ order. Blocks are invoked within an autorelease pool. Once the executor gets deallocated, its
+ threads invoke the blocks left and exit.
+ */
+@interface FSLPromiseWorkStealingExecutor : NSObject <FSLPromiseExecutor>
+
+/**
+ Number of threads in the pool.
+ */
+@property(nonatomic, readonly) NSUInteger threadsCount;
+
+/**
+ Creates an executor with one thread per active processor.
+ */
+- (instancetype)init;
+
+/**
+ Creates an executor with `threadsCount` threads, which must be positive.
+ */
+- (instancetype)initWithThreadsCount:(NSUInteger)threadsCount NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
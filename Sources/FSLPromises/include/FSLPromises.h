@@ -22,6 +22,8 @@
 #import "FSLPromise+Catch.h"
 #import "FSLPromise+Delay.h"
 #import "FSLPromise+Do.h"
+#import "FSLPromise+Hedge.h"
+#import "FSLPromise+Map.h"
 #import "FSLPromise+Race.h"
 #import "FSLPromise+Recover.h"
 #import "FSLPromise+Reduce.h"
@@ -30,3 +32,11 @@
 #import "FSLPromise+Timeout.h"
 #import "FSLPromise+Validate.h"
 #import "FSLPromise+Wrap.h"
+#import "FSLPromiseCircuitBreaker.h"
+#import "FSLPromiseExecutor.h"
+#import "FSLPromiseInstrumentation.h"
+#import "FSLPromiseLatencyHistograms.h"
+#import "FSLPromiseLeakDetector.h"
+#import "FSLPromiseShardedExecutor.h"
+#import "FSLPromiseTraceRecorder.h"
+#import "FSLPromiseWorkStealingExecutor.h"
@@ -0,0 +1,82 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+All.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseAllPerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromiseAllPerformanceTests
+
+/**
+ Measures how the time to combine pending promises with `all` and fulfill them scales with the
+ number of promises.
+ */
+- (void)testAllScaling {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  for (NSUInteger count = 10; count <= 1000000; count *= 10) {
+    NSMutableArray<FSLPromise *> *promises = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+      [promises addObject:[FSLPromise pendingPromise]];
+    }
+    NSDate *startDate = [NSDate date];
+
+    // Act.
+    FSLPromise<NSArray *> *combinedPromise = [FSLPromise onQueue:queue all:promises];
+    for (FSLPromise *promise in promises) {
+      [promise fulfill:@42];
+    }
+
+    // Assert.
+    XCTAssert(FSLWaitForPromisesWithTimeout(100));
+    NSLog(@"Promises: %lu, total time: %.10lf", (unsigned long)count,
+          [[NSDate date] timeIntervalSinceDate:startDate]);
+    XCTAssertEqual(combinedPromise.value.count, count);
+  }
+}
+
+/**
+ Measures how the time to combine values with `all` scales with the number of values.
+ */
+- (void)testAllWithValuesScaling {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  for (NSUInteger count = 10; count <= 1000000; count *= 10) {
+    NSMutableArray<NSNumber *> *values = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+      [values addObject:@(i)];
+    }
+    NSDate *startDate = [NSDate date];
+
+    // Act.
+    FSLPromise<NSArray *> *combinedPromise = [FSLPromise onQueue:queue all:values];
+
+    // Assert.
+    XCTAssert(FSLWaitForPromisesWithTimeout(100));
+    NSLog(@"Values: %lu, total time: %.10lf", (unsigned long)count,
+          [[NSDate date] timeIntervalSinceDate:startDate]);
+    XCTAssertEqualObjects(combinedPromise.value, values);
+  }
+}
+
+@end
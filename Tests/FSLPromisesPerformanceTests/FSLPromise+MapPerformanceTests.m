@@ -0,0 +1,69 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Map.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Async.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseMapPerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromiseMapPerformanceTests
+
+/**
+ Measures the throughput of `map` for different concurrency limits, with work that completes
+ asynchronously on a concurrent queue.
+ */
+- (void)testMapConcurrencyThroughput {
+  // Arrange.
+  NSUInteger const count = 100000;
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  dispatch_queue_t workQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  NSMutableArray<NSNumber *> *items = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    [items addObject:@(i)];
+  }
+  for (NSNumber *concurrency in @[ @1, @4, @16, @64, @256, @1024 ]) {
+    NSDate *startDate = [NSDate date];
+
+    // Act.
+    FSLPromise<NSArray *> *promise =
+        [FSLPromise onQueue:queue
+                        map:items
+                concurrency:concurrency.unsignedIntegerValue
+                       work:^id(NSNumber *item) {
+                         return [FSLPromise onQueue:workQueue
+                                              async:^(FSLPromiseFulfillBlock fulfill,
+                                                      FSLPromiseRejectBlock __unused _) {
+                                                fulfill(@(item.unsignedIntegerValue * 2));
+                                              }];
+                       }];
+
+    // Assert.
+    XCTAssert(FSLWaitForPromisesWithTimeout(100));
+    NSTimeInterval totalTime = [[NSDate date] timeIntervalSinceDate:startDate];
+    NSLog(@"Concurrency: %lu, items per second: %.0lf", concurrency.unsignedLongValue,
+          count / totalTime);
+    XCTAssertEqual(promise.value.count, count);
+  }
+}
+
+@end
@@ -0,0 +1,100 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Retry.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseRetryPerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromiseRetryPerformanceTests
+
+/**
+ Simulates many clients retrying against a fake service that is down for a while and then recovers,
+ and measures the load amplification, i.e. the number of requests the service gets per client, for
+ different retry strategies.
+ */
+- (void)testRetryLoadAmplification {
+  // Arrange.
+  NSUInteger const clientsCount = 1000;
+  NSTimeInterval const outageInterval = 0.5;
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  NSError *overloadedError = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  // Shared by all clients.
+  FSLPromiseRetryBudget *budget = [[FSLPromiseRetryBudget alloc] initWithMaxTokens:100
+                                                                        tokenRatio:0.1];
+  NSDictionary<NSString *, FSLPromise * (^)(FSLPromiseRetryWorkBlock)> *strategies = @{
+    @"fixed delay" : ^(FSLPromiseRetryWorkBlock work) {
+      return [FSLPromise onQueue:queue attempts:20 delay:0.05 condition:nil retry:work];
+    },
+    @"backoff with jitter" : ^(FSLPromiseRetryWorkBlock work) {
+      return [FSLPromise onQueue:queue
+                        attempts:20
+                    initialDelay:0.05
+                        maxDelay:1
+                          jitter:FSLPromiseRetryJitterDecorrelated
+                        deadline:0
+                          budget:nil
+                       condition:nil
+                           retry:work];
+    },
+    @"backoff with jitter and budget" : ^(FSLPromiseRetryWorkBlock work) {
+      return [FSLPromise onQueue:queue
+                        attempts:20
+                    initialDelay:0.05
+                        maxDelay:1
+                          jitter:FSLPromiseRetryJitterDecorrelated
+                        deadline:0
+                          budget:budget
+                       condition:nil
+                           retry:work];
+    },
+  };
+  for (NSString *strategy in strategies) {
+    NSUInteger __block requestsCount = 0;
+    NSDate *startDate = [NSDate date];
+    // The fake service fails all requests during the outage.
+    FSLPromiseRetryWorkBlock request = ^id {
+      ++requestsCount;
+      return [[NSDate date] timeIntervalSinceDate:startDate] < outageInterval ? overloadedError
+                                                                               : @42;
+    };
+
+    // Act.
+    NSMutableArray<FSLPromise *> *promises = [NSMutableArray arrayWithCapacity:clientsCount];
+    for (NSUInteger i = 0; i < clientsCount; ++i) {
+      [promises addObject:strategies[strategy](request)];
+    }
+
+    // Assert.
+    FSLWaitForPromisesWithTimeout(100);
+    NSUInteger fulfilledCount = 0;
+    for (FSLPromise *promise in promises) {
+      fulfilledCount += promise.isFulfilled ? 1 : 0;
+    }
+    NSLog(@"Strategy: %@, requests per client: %.2lf, fulfilled: %lu, total time: %.3lf", strategy,
+          (double)requestsCount / clientsCount, (unsigned long)fulfilledCount,
+          [[NSDate date] timeIntervalSinceDate:startDate]);
+    XCTAssertGreaterThanOrEqual(requestsCount, clientsCount);
+  }
+}
+
+@end
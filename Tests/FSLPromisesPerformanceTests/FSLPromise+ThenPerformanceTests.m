@@ -263,6 +263,45 @@ NS_INLINE void FSLLogTotalTime(NSTimeInterval time) {
   [self waitForExpectationsWithTimeout:10 handler:nil];
 }
 
+/**
+ Measures the average time needed to create a resolved FSLPromise with the inline execution policy,
+ chain three `then` blocks on it and get into the last `then` block.
+ */
+- (void)testTripleThenOnSerialQueueWithInlinePolicy {
+  // Arrange.
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  expectation.expectedFulfillmentCount = FSLPromisePerformanceTestIterationCount;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__,
+      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+
+  // Act.
+  dispatch_async(dispatch_get_main_queue(), ^{
+    uint64_t time = dispatch_benchmark(FSLPromisePerformanceTestIterationCount, ^{
+      FSLPromise *promise = [FSLPromise resolvedWith:@YES];
+      promise.executionPolicy = FSLPromiseExecutionPolicyInline;
+      [[[promise onQueue:queue
+                    then:^id(id result) {
+                      return result;
+                    }] onQueue:queue
+                          then:^id(id result) {
+                            return result;
+                          }] onQueue:queue
+                                then:^id(id result) {
+                                  dispatch_semaphore_signal(semaphore);
+                                  [expectation fulfill];
+                                  return result;
+                                }];
+      dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+    FSLLogAverageTime(time);
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
 /**
  Measures the total time needed to resolve a lot of pending FSLPromise with chained `then` blocks
  on them on a concurrent queue and wait for each of them to get into chained block.
@@ -297,4 +336,45 @@ NS_INLINE void FSLLogTotalTime(NSTimeInterval time) {
   FSLLogTotalTime([endDate timeIntervalSinceDate:startDate]);
 }
 
+/**
+ Measures the total time needed to observe and fulfill a few shared pending FSLPromise from many
+ threads at once on a concurrent queue and wait for each observer to get into chained block.
+ */
+- (void)testThenOnSharedPromisesOnConcurrentQueue {
+  // Arrange.
+  static NSUInteger const sharedPromisesCount = 8;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__, dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
+                                                            QOS_CLASS_USER_INITIATED, 0));
+  dispatch_group_t group = dispatch_group_create();
+  NSMutableArray<FSLPromise *> *promises = [NSMutableArray arrayWithCapacity:sharedPromisesCount];
+  for (NSUInteger i = 0; i < sharedPromisesCount; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+  }
+  for (NSUInteger i = 0; i < FSLPromisePerformanceTestIterationCount; ++i) {
+    dispatch_group_enter(group);
+  }
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  dispatch_apply(FSLPromisePerformanceTestIterationCount, queue, ^(size_t index) {
+    FSLPromise *promise = promises[index % sharedPromisesCount];
+    [promise onQueue:queue
+                then:^id(id result) {
+                  dispatch_group_leave(group);
+                  return result;
+                }];
+    // Let the second half of observers race against the resolution.
+    if (index >= FSLPromisePerformanceTestIterationCount / 2) {
+      [promise fulfill:@YES];
+    }
+  });
+
+  // Assert.
+  XCTAssert(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, NSEC_PER_SEC)) == 0,
+            @"Asynchronous wait failed: Exceeded timeout of 1 second.");
+  NSDate *endDate = [NSDate date];
+  FSLLogTotalTime([endDate timeIntervalSinceDate:startDate]);
+}
+
 @end
@@ -0,0 +1,143 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Timeout.h"
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+static size_t const FSLPromiseTimeoutPerformanceTestPromiseCount = 100000;
+static NSTimeInterval const FSLPromiseTimeoutPerformanceTestInterval = 30;
+
+NS_INLINE size_t FSLMemoryInUse(void) {
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(NULL, &statistics);
+  return statistics.size_in_use;
+}
+
+NS_INLINE void FSLLogTimeAndMemory(NSDate *startDate, size_t memoryBefore) {
+  NSLog(@"Total time: %.10lf, bytes left per promise: %.1lf",
+        [[NSDate date] timeIntervalSinceDate:startDate],
+        ((double)FSLMemoryInUse() - (double)memoryBefore) /
+            FSLPromiseTimeoutPerformanceTestPromiseCount);
+}
+
+@interface FSLPromiseTimeoutPerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromiseTimeoutPerformanceTests
+
+/**
+ Measures the time to put a timeout on many promises that get resolved right away, and the memory
+ left behind by their timers, with a `dispatch_after` per promise, as `timeout` used to do.
+ */
+- (void)testTimeoutWithDispatchAfter {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  NSMutableArray<FSLPromise *> *promises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseTimeoutPerformanceTestPromiseCount];
+  for (size_t i = 0; i < FSLPromiseTimeoutPerformanceTestPromiseCount; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+  }
+  size_t memoryBefore = FSLMemoryInUse();
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  for (FSLPromise *promise in promises) {
+    FSLPromise __weak *weakPromise = promise;
+    dispatch_after(dispatch_time(0, (int64_t)(FSLPromiseTimeoutPerformanceTestInterval *
+                                              NSEC_PER_SEC)),
+                   queue, ^{
+                     [weakPromise reject:[NSError errorWithDomain:FSLPromiseErrorDomain
+                                                             code:FSLPromiseErrorCodeTimedOut
+                                                         userInfo:nil]];
+                   });
+  }
+  [promises makeObjectsPerformSelector:@selector(fulfill:) withObject:@42];
+  [promises removeAllObjects];
+
+  // Assert.
+  FSLLogTimeAndMemory(startDate, memoryBefore);
+}
+
+/**
+ Measures the time to put a timeout on many promises that get resolved right away, and the memory
+ left behind by their timers, with `timeout`.
+ */
+- (void)testTimeoutWithTimerWheel {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  NSMutableArray<FSLPromise *> *promises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseTimeoutPerformanceTestPromiseCount];
+  for (size_t i = 0; i < FSLPromiseTimeoutPerformanceTestPromiseCount; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+  }
+  size_t memoryBefore = FSLMemoryInUse();
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  NSMutableArray<FSLPromise *> *timeoutPromises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseTimeoutPerformanceTestPromiseCount];
+  for (FSLPromise *promise in promises) {
+    [timeoutPromises addObject:[promise onQueue:queue
+                                         timeout:FSLPromiseTimeoutPerformanceTestInterval]];
+  }
+  [promises makeObjectsPerformSelector:@selector(fulfill:) withObject:@42];
+  [promises removeAllObjects];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  [timeoutPromises removeAllObjects];
+
+  // Assert.
+  FSLLogTimeAndMemory(startDate, memoryBefore);
+}
+
+/**
+ Measures the time to put a timeout on many promises that get resolved right away, with ticks of
+ different granularity.
+ */
+- (void)testTimeoutWithTimerWheelTickIntervals {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  NSTimeInterval defaultTickInterval = FSLPromise.timerTickInterval;
+
+  for (NSNumber *tickInterval in @[ @0.001, @0.01, @0.1, @1 ]) {
+    FSLPromise.timerTickInterval = tickInterval.doubleValue;
+    NSMutableArray<FSLPromise *> *promises =
+        [NSMutableArray arrayWithCapacity:FSLPromiseTimeoutPerformanceTestPromiseCount];
+    for (size_t i = 0; i < FSLPromiseTimeoutPerformanceTestPromiseCount; ++i) {
+      [promises addObject:[FSLPromise pendingPromise]];
+    }
+    NSDate *startDate = [NSDate date];
+
+    // Act.
+    for (FSLPromise *promise in promises) {
+      [promise onQueue:queue timeout:FSLPromiseTimeoutPerformanceTestInterval];
+    }
+    [promises makeObjectsPerformSelector:@selector(fulfill:) withObject:@42];
+    XCTAssert(FSLWaitForPromisesWithTimeout(10));
+
+    // Assert.
+    NSLog(@"Tick interval: %@, total time: %.10lf", tickInterval,
+          [[NSDate date] timeIntervalSinceDate:startDate]);
+  }
+  FSLPromise.timerTickInterval = defaultTickInterval;
+}
+
+@end
@@ -0,0 +1,103 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Wrap.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Then.h"
+#import "FSLPromisesTestHelpers.h"
+
+static size_t const FSLPromisePerformanceTestIterationCount = 10000;
+
+NS_INLINE void FSLLogAverageTime(uint64_t time) {
+  NSLog(@"Average time: %.10lf", (double)time / NSEC_PER_SEC);
+}
+
+@interface FSLPromiseWrapPerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromiseWrapPerformanceTests
+
+/**
+ Measures the average time needed to wrap a completion handler invoked right away, chain a `then`
+ block on the resulting promise and get into that block.
+ */
+- (void)testWrapObjectCompletionOnSerialQueue {
+  // Arrange.
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  expectation.expectedFulfillmentCount = FSLPromisePerformanceTestIterationCount;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__,
+      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+
+  // Act.
+  dispatch_async(dispatch_get_main_queue(), ^{
+    uint64_t time = dispatch_benchmark(FSLPromisePerformanceTestIterationCount, ^{
+      [[FSLPromise onQueue:queue
+          wrapObjectCompletion:^(FSLPromiseObjectCompletion handler) {
+            handler(@42);
+          }] onQueue:queue
+                then:^id(id value) {
+                  dispatch_semaphore_signal(semaphore);
+                  [expectation fulfill];
+                  return value;
+                }];
+      dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+    FSLLogAverageTime(time);
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+/**
+ Same as `testWrapObjectCompletionOnSerialQueue`, but with `syncWrapObjectCompletion:`, which skips
+ the dispatch needed to invoke the `work` block.
+ */
+- (void)testSyncWrapObjectCompletionOnSerialQueue {
+  // Arrange.
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  expectation.expectedFulfillmentCount = FSLPromisePerformanceTestIterationCount;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__,
+      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+
+  // Act.
+  dispatch_async(dispatch_get_main_queue(), ^{
+    uint64_t time = dispatch_benchmark(FSLPromisePerformanceTestIterationCount, ^{
+      [[FSLPromise syncWrapObjectCompletion:^(FSLPromiseObjectCompletion handler) {
+        handler(@42);
+      }] onQueue:queue
+            then:^id(id value) {
+              dispatch_semaphore_signal(semaphore);
+              [expectation fulfill];
+              return value;
+            }];
+      dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+    FSLLogAverageTime(time);
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+@end
@@ -0,0 +1,211 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#import "FSLPromise+Then.h"
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import <objc/runtime.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+static size_t const FSLPromiseMemoryTestPromiseCount = 100000;
+
+NS_INLINE size_t FSLMemoryInUse(void) {
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(NULL, &statistics);
+  return statistics.size_in_use;
+}
+
+NS_INLINE void FSLLogBytesPerPromise(size_t memoryBefore, size_t memoryAfter) {
+  NSLog(@"Bytes per promise: %.1lf",
+        ((double)memoryAfter - (double)memoryBefore) / FSLPromiseMemoryTestPromiseCount);
+}
+
+@interface FSLPromisePerformanceTests : XCTestCase
+@end
+
+@implementation FSLPromisePerformanceTests
+
+/**
+ Measures the average number of heap bytes occupied by a pending FSLPromise.
+ */
+- (void)testMemoryPerPendingPromise {
+  // Arrange.
+  NSMutableArray<FSLPromise *> *promises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseMemoryTestPromiseCount];
+  NSLog(@"Instance size: %zu", class_getInstanceSize([FSLPromise class]));
+  size_t memoryBefore = FSLMemoryInUse();
+
+  // Act.
+  for (size_t i = 0; i < FSLPromiseMemoryTestPromiseCount; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+  }
+
+  // Assert.
+  FSLLogBytesPerPromise(memoryBefore, FSLMemoryInUse());
+  XCTAssertEqual(promises.count, FSLPromiseMemoryTestPromiseCount);
+  [promises makeObjectsPerformSelector:@selector(fulfill:) withObject:nil];
+}
+
+/**
+ Measures the average number of heap bytes added by chaining a `then` block to a pending
+ FSLPromise, which includes the chained promise and the observer of the original one.
+ */
+- (void)testMemoryPerChainedThen {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  NSMutableArray<FSLPromise *> *promises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseMemoryTestPromiseCount];
+  NSMutableArray<FSLPromise *> *chainedPromises =
+      [NSMutableArray arrayWithCapacity:FSLPromiseMemoryTestPromiseCount];
+  for (size_t i = 0; i < FSLPromiseMemoryTestPromiseCount; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+  }
+  size_t memoryBefore = FSLMemoryInUse();
+
+  // Act.
+  for (FSLPromise *promise in promises) {
+    [chainedPromises addObject:[promise onQueue:queue
+                                           then:^id(id value) {
+                                             return value;
+                                           }]];
+  }
+
+  // Assert.
+  FSLLogBytesPerPromise(memoryBefore, FSLMemoryInUse());
+  XCTAssertEqual(chainedPromises.count, FSLPromiseMemoryTestPromiseCount);
+  [promises makeObjectsPerformSelector:@selector(fulfill:) withObject:nil];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+}
+
+/**
+ Measures how the throughput of creating and resolving FSLPromise scales with the number of
+ threads doing that concurrently, with and without the global dispatch group bookkeeping.
+ */
+- (void)testCreateAndResolveScalingWithDispatchGroup {
+  // Arrange.
+  static size_t const promisesPerThreadCount = 100000;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__, dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
+                                                            QOS_CLASS_USER_INITIATED, 0));
+  dispatch_group_t defaultDispatchGroup = FSLPromise.dispatchGroup;
+  NSUInteger const maxThreadsCount = NSProcessInfo.processInfo.activeProcessorCount;
+
+  for (NSUInteger useDispatchGroup = 0; useDispatchGroup < 2; ++useDispatchGroup) {
+    FSLPromise.dispatchGroup = useDispatchGroup ? defaultDispatchGroup : nil;
+    for (size_t threadsCount = 1; threadsCount <= maxThreadsCount; threadsCount *= 2) {
+      NSDate *startDate = [NSDate date];
+
+      // Act.
+      dispatch_apply(threadsCount, queue, ^(size_t __unused _) {
+        for (size_t i = 0; i < promisesPerThreadCount; ++i) {
+          [[FSLPromise pendingPromise] fulfill:@YES];
+        }
+      });
+
+      // Assert.
+      NSTimeInterval time = [[NSDate date] timeIntervalSinceDate:startDate];
+      NSLog(@"Dispatch group: %@, threads: %zu, promises per second: %.0lf",
+            useDispatchGroup ? @"YES" : @"NO", threadsCount,
+            threadsCount * promisesPerThreadCount / time);
+    }
+  }
+  FSLPromise.dispatchGroup = defaultDispatchGroup;
+}
+
+/**
+ Measures the time to notify an increasing number of observers of a single FSLPromise, all on the
+ same queue, from the moment it gets resolved until the last observer is invoked.
+ */
+- (void)testResolveWithManyObserversOnSerialQueue {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  for (NSNumber *count in @[ @1, @10, @1000, @10000 ]) {
+    NSUInteger const observersCount = count.unsignedIntegerValue;
+    FSLPromise *promise = [FSLPromise pendingPromise];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger notifiedCount = 0;
+    for (NSUInteger i = 0; i < observersCount; ++i) {
+      [promise onQueue:queue
+                  then:^id(id value) {
+                    if (++notifiedCount == observersCount) {
+                      dispatch_semaphore_signal(semaphore);
+                    }
+                    return value;
+                  }];
+    }
+    NSDate *startDate = [NSDate date];
+
+    // Act.
+    [promise fulfill:@YES];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+
+    // Assert.
+    NSTimeInterval time = [[NSDate date] timeIntervalSinceDate:startDate];
+    NSLog(@"Observers: %lu, time: %.3lf ms", (unsigned long)observersCount, time * 1000);
+    XCTAssertEqual(notifiedCount, observersCount);
+  }
+}
+
+/**
+ Measures the heap growth of a recursive asynchronous loop, where each iteration resolves the
+ promise of the previous one with its own promise, at the moment the last iteration runs.
+ */
+- (void)testMemoryPerRecursiveIteration {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__, dispatch_queue_attr_make_with_autorelease_frequency(
+                        DISPATCH_QUEUE_SERIAL, DISPATCH_AUTORELEASE_FREQUENCY_WORK_ITEM));
+  size_t __block memoryAtLastIteration = 0;
+  size_t memoryBefore = FSLMemoryInUse();
+
+  // Act.
+  FSLPromise *promise = [self loopFrom:FSLPromiseMemoryTestPromiseCount
+                               onQueue:queue
+                            completion:^{
+                              memoryAtLastIteration = FSLMemoryInUse();
+                            }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(100));
+  FSLLogBytesPerPromise(memoryBefore, memoryAtLastIteration);
+  XCTAssertEqualObjects(promise.value, @0);
+}
+
+#pragma mark - Private
+
+/**
+ Returns a promise resolved with zero after recursively counting down from `count` on `queue`,
+ invoking `completion` from the last iteration.
+ */
+- (FSLPromise *)loopFrom:(size_t)count
+                 onQueue:(dispatch_queue_t)queue
+              completion:(dispatch_block_t)completion {
+  return [[FSLPromise resolvedWith:@(count)] onQueue:queue
+                                                then:^id(NSNumber *value) {
+                                                  if (count == 0) {
+                                                    completion();
+                                                    return value;
+                                                  }
+                                                  return [self loopFrom:count - 1
+                                                                onQueue:queue
+                                                             completion:completion];
+                                                }];
+}
+
+@end
@@ -227,4 +227,42 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseAllCancel {
+  // Arrange.
+  FSLPromise *promise1 = [FSLPromise pendingPromise];
+  FSLPromise *promise2 = [FSLPromise pendingPromise];
+  FSLPromise<NSArray *> *combinedPromise = [FSLPromise all:@[ promise1, promise2 ]];
+  // Let the combined promise subscribe to the others.
+  FSLWaitForPromisesWithTimeout(0.1);
+
+  // Act.
+  [combinedPromise cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(combinedPromise.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise1.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise2.error));
+}
+
+- (void)testPromiseAllFulfilledInReverseOrder {
+  // Arrange.
+  NSUInteger const count = 1000;
+  NSMutableArray<FSLPromise *> *promises = [NSMutableArray arrayWithCapacity:count];
+  NSMutableArray<NSNumber *> *expectedValues = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+    [expectedValues addObject:@(i)];
+  }
+  FSLPromise<NSArray *> *combinedPromise = [FSLPromise all:promises];
+
+  // Act.
+  for (NSUInteger i = count; i > 0; --i) {
+    [promises[i - 1] fulfill:@(i - 1)];
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(combinedPromise.value, expectedValues);
+}
+
 @end
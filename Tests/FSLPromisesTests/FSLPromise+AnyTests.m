@@ -228,4 +228,26 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseAnyResolvedInReverseOrder {
+  // Arrange.
+  NSUInteger const count = 1000;
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  NSMutableArray<FSLPromise *> *promises = [NSMutableArray arrayWithCapacity:count];
+  NSMutableArray *expectedValuesAndErrors = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    [promises addObject:[FSLPromise pendingPromise]];
+    [expectedValuesAndErrors addObject:i % 2 ? error : @(i)];
+  }
+  FSLPromise<NSArray *> *combinedPromise = [FSLPromise any:promises];
+
+  // Act.
+  for (NSUInteger i = count; i > 0; --i) {
+    [promises[i - 1] fulfill:expectedValuesAndErrors[i - 1]];
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(combinedPromise.value, expectedValuesAndErrors);
+}
+
 @end
@@ -110,4 +110,52 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseDelayCancel {
+  // Arrange.
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *delayedPromise = [promise delay:1];
+  FSLPromise __weak *weakDelayedPromise;
+
+  // Act.
+  @autoreleasepool {
+    [promise fulfill:@42];
+    XCTAssert(FSLWaitForPromisesWithTimeout(10));
+    XCTAssertTrue(delayedPromise.isPending);
+    [delayedPromise cancel];
+    weakDelayedPromise = delayedPromise;
+    delayedPromise = nil;
+  }
+
+  // Assert.
+  // The cancelled timer shouldn't keep the delayed promise alive until it would have fired.
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  FSLDelay(0.1, ^{
+    XCTAssertNil(weakDelayedPromise);
+    [expectation fulfill];
+  });
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+/**
+ Zero delays should not wait for the next tick of the timer wheel.
+ */
+- (void)testPromiseDelayZeroDoesNotWaitForTimerTick {
+  // Arrange.
+  NSTimeInterval defaultTickInterval = FSLPromise.timerTickInterval;
+  FSLPromise.timerTickInterval = 10;
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+
+  // Act.
+  FSLPromise<NSNumber *> *promise = [[FSLPromise resolvedWith:@42] delay:0];
+  FSLPromise<NSNumber *> *queuePromise = [[FSLPromise resolvedWith:@42] onQueue:queue delay:0];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(1));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertEqualObjects(queuePromise.value, @42);
+
+  // Cleanup.
+  FSLPromise.timerTickInterval = defaultTickInterval;
+}
+
 @end
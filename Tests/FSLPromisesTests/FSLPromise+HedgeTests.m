@@ -0,0 +1,148 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Hedge.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseHedgeTests : XCTestCase
+@end
+
+@implementation FSLPromiseHedgeTests
+
+- (void)testPromiseHedgeNoHedgeOnFastAttempt {
+  // Arrange.
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise hedges:2
+                                     delay:0.01
+                                     hedge:^id {
+                                       ++count;
+                                       return @42;
+                                     }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertNil(promise.error);
+  XCTAssertEqual(count, 1u);
+}
+
+- (void)testPromiseHedgeSlowAttempt {
+  // Arrange.
+  FSLPromise *slowPromise = [FSLPromise pendingPromise];
+  NSArray<FSLPromise *> *attempts = @[ slowPromise, [FSLPromise resolvedWith:@42] ];
+  NSUInteger __block count = 0;
+  NSInteger __block winningAttempt = -1;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise hedges:1
+      delayedBy:^NSTimeInterval(NSInteger attempt) {
+        XCTAssertEqual(attempt, 1);
+        return 0.01;
+      }
+      report:^(NSInteger attempt, NSTimeInterval latency) {
+        winningAttempt = attempt;
+        XCTAssertGreaterThan(latency, 0);
+      }
+      hedge:^id {
+        return attempts[count++];
+      }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertEqual(count, 2u);
+  XCTAssertEqual(winningAttempt, 1);
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(slowPromise.error));
+}
+
+- (void)testPromiseHedgeNextAttemptRightAwayOnReject {
+  // Arrange.
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise hedges:2
+                                     delay:60
+                                     hedge:^id {
+                                       if (++count < 3) {
+                                         return [NSError errorWithDomain:FSLPromiseErrorDomain
+                                                                    code:42
+                                                                userInfo:nil];
+                                       }
+                                       return @42;
+                                     }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertEqual(count, 3u);
+}
+
+- (void)testPromiseHedgeAllAttemptsRejected {
+  // Arrange.
+  NSInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise hedges:2
+                                     delay:0.01
+                                     hedge:^id {
+                                       return [NSError errorWithDomain:FSLPromiseErrorDomain
+                                                                  code:++count
+                                                              userInfo:nil];
+                                     }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(promise.error.code, 3);
+  XCTAssertNil(promise.value);
+  XCTAssertEqual(count, 3);
+}
+
+- (void)testPromiseHedgeMaxHedgesAndCancel {
+  // Arrange.
+  NSMutableArray<FSLPromise *> *attempts = [[NSMutableArray alloc] init];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  FSLPromise *promise = [FSLPromise hedges:2
+                                     delay:0.01
+                                     hedge:^id {
+                                       FSLPromise *attempt = [FSLPromise pendingPromise];
+                                       [attempts addObject:attempt];
+                                       if (attempts.count == 3) {
+                                         [expectation fulfill];
+                                       }
+                                       return attempt;
+                                     }];
+  // Let all the hedged attempts start.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+
+  // Act.
+  [promise cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertEqual(attempts.count, 3u);
+  for (FSLPromise *attempt in attempts) {
+    XCTAssertTrue(FSLPromiseErrorIsCancelled(attempt.error));
+  }
+}
+
+@end
@@ -0,0 +1,188 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromise+Map.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Async.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseMapTests : XCTestCase
+@end
+
+@implementation FSLPromiseMapTests
+
+- (void)testPromiseMapConcurrencyLimit {
+  // Arrange.
+  NSUInteger const count = 100;
+  NSUInteger const concurrency = 4;
+  NSMutableArray<NSNumber *> *items = [NSMutableArray arrayWithCapacity:count];
+  NSMutableArray<NSString *> *expectedValues = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    [items addObject:@(i)];
+    [expectedValues addObject:[@(i) stringValue]];
+  }
+  NSUInteger __block pendingCount = 0;
+  NSUInteger __block maxPendingCount = 0;
+
+  // Act.
+  FSLPromise<NSArray *> *promise =
+      [FSLPromise map:items
+          concurrency:concurrency
+                 work:^id(NSNumber *item) {
+                   maxPendingCount = MAX(maxPendingCount, ++pendingCount);
+                   return [FSLPromise async:^(FSLPromiseFulfillBlock fulfill,
+                                              FSLPromiseRejectBlock __unused _) {
+                     // Complete out of order.
+                     FSLDelay(0.001 * (item.unsignedIntegerValue % 3), ^{
+                       --pendingCount;
+                       fulfill(item.stringValue);
+                     });
+                   }];
+                 }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, expectedValues);
+  XCTAssertEqual(maxPendingCount, concurrency);
+  XCTAssertEqual(pendingCount, 0u);
+}
+
+- (void)testPromiseMapWithValues {
+  // Act.
+  FSLPromise<NSArray *> *promise = [FSLPromise map:@[ @1, @2, @3 ]
+                                       concurrency:2
+                                              work:^id(NSNumber *item) {
+                                                return item.integerValue == 2 ? nil : item;
+                                              }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, (@[ @1, [NSNull null], @3 ]));
+}
+
+- (void)testPromiseMapEmpty {
+  // Act.
+  FSLPromise<NSArray *> *promise = [FSLPromise map:@[]
+                                       concurrency:2
+                                              work:^id(id __unused _) {
+                                                XCTFail();
+                                                return nil;
+                                              }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @[]);
+}
+
+- (void)testPromiseMapFailFast {
+  // Arrange.
+  NSArray<NSNumber *> *items = @[ @0, @1, @2, @3, @4, @5 ];
+  NSMutableArray<NSNumber *> *startedItems = [[NSMutableArray alloc] init];
+
+  // Act.
+  FSLPromise<NSArray *> *promise =
+      [FSLPromise map:items
+          concurrency:1
+                 work:^id(NSNumber *item) {
+                   [startedItems addObject:item];
+                   if (item.integerValue == 2) {
+                     return [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+                   }
+                   return [FSLPromise resolvedWith:item];
+                 }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(promise.error.code, 42);
+  XCTAssertNil(promise.value);
+  XCTAssertEqualObjects(startedItems, (@[ @0, @1, @2 ]));
+}
+
+- (void)testPromiseMapCollectErrors {
+  // Arrange.
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+
+  // Act.
+  FSLPromise<NSArray *> *promise =
+      [FSLPromise map:@[ @0, @1, @2 ]
+          concurrency:2
+                 mode:FSLPromiseMapModeCollectErrors
+                 work:^id(NSNumber *item) {
+                   return [FSLPromise resolvedWith:item.integerValue == 1 ? error : item];
+                 }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, (@[ @0, error, @2 ]));
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseForEachCollectErrors {
+  // Arrange.
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise<NSArray<NSError *> *> *promise =
+      [FSLPromise forEach:@[ @0, @1, @2, @3 ]
+              concurrency:3
+                     mode:FSLPromiseMapModeCollectErrors
+                     work:^id(NSNumber *item) {
+                       ++count;
+                       if (item.integerValue % 2 == 0) {
+                         return [NSError errorWithDomain:FSLPromiseErrorDomain
+                                                    code:item.integerValue
+                                                userInfo:nil];
+                       }
+                       return item;
+                     }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(count, 4u);
+  XCTAssertEqual(promise.value.count, 2u);
+  XCTAssertEqualObjects([promise.value valueForKey:@"code"], (@[ @0, @2 ]));
+}
+
+- (void)testPromiseMapCancel {
+  // Arrange.
+  NSMutableArray<FSLPromise *> *pendingPromises = [[NSMutableArray alloc] init];
+  FSLPromise<NSArray *> *promise = [FSLPromise map:@[ @0, @1, @2, @3 ]
+                                       concurrency:2
+                                              work:^id(id __unused _) {
+                                                FSLPromise *pendingPromise =
+                                                    [FSLPromise pendingPromise];
+                                                [pendingPromises addObject:pendingPromise];
+                                                return pendingPromise;
+                                              }];
+  // Let the work start for the first items.
+  FSLWaitForPromisesWithTimeout(0.1);
+
+  // Act.
+  [promise cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertEqual(pendingPromises.count, 2u);
+  for (FSLPromise *pendingPromise in pendingPromises) {
+    XCTAssertTrue(FSLPromiseErrorIsCancelled(pendingPromise.error));
+  }
+}
+
+@end
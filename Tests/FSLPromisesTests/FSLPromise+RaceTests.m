@@ -226,4 +226,127 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseRaceCancelLosers {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  FSLPromise *promise1 = [FSLPromise pendingPromise];
+  FSLPromise *promise2 = [FSLPromise pendingPromise];
+  FSLPromise *promise3 = [FSLPromise pendingPromise];
+  FSLPromise *observedPromise = [promise3 then:^id(id value) {
+    return value;
+  }];
+  FSLPromise *fastestPromise = [FSLPromise onQueue:queue
+                                              race:@[ promise1, promise2, promise3 ]
+                                      cancelLosers:YES];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+
+  // Act.
+  [promise1 fulfill:@42];
+  // The losers get detached right after the combined promise is resolved, on the same queue.
+  [fastestPromise onQueue:queue
+                     then:^id(id value) {
+                       [expectation fulfill];
+                       return value;
+                     }];
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqualObjects(fastestPromise.value, @42);
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise2.error));
+  XCTAssertTrue(promise3.isPending);
+  XCTAssertTrue(observedPromise.isPending);
+
+  // Cleanup.
+  [promise3 fulfill:nil];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+}
+
+- (void)testPromiseRaceNoCancelLosersByDefault {
+  // Arrange.
+  FSLPromise *promise1 = [FSLPromise pendingPromise];
+  FSLPromise *promise2 = [FSLPromise pendingPromise];
+  FSLPromise *fastestPromise = [FSLPromise race:@[ promise1, promise2 ]];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+
+  // Act.
+  [promise1 fulfill:@42];
+  [fastestPromise then:^id(id value) {
+    [expectation fulfill];
+    return value;
+  }];
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqualObjects(fastestPromise.value, @42);
+  XCTAssertTrue(promise2.isPending);
+
+  // Cleanup.
+  [promise2 fulfill:nil];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+}
+
+- (void)testPromiseRaceCancel {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  FSLPromise *promise1 = [FSLPromise pendingPromise];
+  FSLPromise *promise2 = [FSLPromise pendingPromise];
+  FSLPromise *fastestPromise = [FSLPromise onQueue:queue race:@[ promise1, promise2 ]];
+  // Let the combined promise subscribe to the others.
+  dispatch_sync(queue, ^{
+  });
+
+  // Act.
+  [fastestPromise cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(fastestPromise.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise1.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise2.error));
+}
+
+- (void)testPromiseRaceWork {
+  // Arrange.
+  FSLPromise *slowPromise = [FSLPromise pendingPromise];
+  __block NSUInteger startedCount = 0;
+
+  // Act.
+  FSLPromise *fastestPromise = [FSLPromise raceWork:@[
+    ^id {
+      ++startedCount;
+      return slowPromise;
+    },
+    ^id {
+      ++startedCount;
+      return [FSLPromise resolvedWith:@42];
+    },
+    ^id {
+      ++startedCount;
+      return @"not started";
+    },
+  ]];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(fastestPromise.value, @42);
+  XCTAssertEqual(startedCount, 2u);
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(slowPromise.error));
+}
+
+- (void)testPromiseRaceWorkWithValue {
+  // Act.
+  FSLPromise *fastestPromise = [FSLPromise raceWork:@[
+    ^id {
+      return @42;
+    },
+    ^id {
+      return [FSLPromise resolvedWith:@"hello world"];
+    },
+  ]];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(fastestPromise.value, @42);
+  XCTAssertNil(fastestPromise.error);
+}
+
 @end
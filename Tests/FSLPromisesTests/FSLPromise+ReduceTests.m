@@ -79,4 +79,133 @@
   XCTAssertEqual(count, expectedCount);
 }
 
+- (void)testPromiseLazyReduce {
+  // Arrange.
+  NSUInteger const count = 10000;
+  NSMutableArray<NSNumber *> *numbers = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 1; i <= count; ++i) {
+    [numbers addObject:@(i)];
+  }
+
+  // Act.
+  FSLPromise<NSNumber *> *promise = [[FSLPromise resolvedWith:@0]
+      lazyReduce:numbers.objectEnumerator
+         combine:^id(NSNumber *partialSum, NSNumber *nextNumber) {
+           NSNumber *sum = @(partialSum.unsignedIntegerValue + nextNumber.unsignedIntegerValue);
+           // Mix values and promises.
+           return nextNumber.unsignedIntegerValue % 100 == 0 ? [FSLPromise resolvedWith:sum] : sum;
+         }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @(count * (count + 1) / 2));
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseLazyReduceReject {
+  // Arrange.
+  NSArray<NSNumber *> *numbers = @[ @1, @2, @3 ];
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [[FSLPromise resolvedWith:@""]
+      lazyReduce:numbers.objectEnumerator
+         combine:^id(NSString *partialString, NSNumber *nextNumber) {
+           ++count;
+           if (partialString.length > 0) {
+             return [FSLPromise resolvedWith:[NSError errorWithDomain:FSLPromiseErrorDomain
+                                                                 code:42
+                                                             userInfo:nil]];
+           }
+           return [partialString stringByAppendingString:nextNumber.stringValue];
+         }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(promise.error.code, 42);
+  XCTAssertEqual(count, 2u);
+}
+
+- (void)testPromiseLazyReduceCancel {
+  // Arrange.
+  NSEnumerator<NSNumber *> *numbers = @[ @1, @2, @3 ].objectEnumerator;
+  FSLPromise *partialPromise = [FSLPromise pendingPromise];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  FSLPromise *promise = [[FSLPromise resolvedWith:@0]
+      lazyReduce:numbers
+         combine:^id(id __unused partialSum, id __unused nextNumber) {
+           [expectation fulfill];
+           return partialPromise;
+         }];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+
+  // Act.
+  [promise cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(partialPromise.error));
+  XCTAssertEqualObjects([numbers nextObject], @2);
+}
+
+- (void)testPromiseTreeReduce {
+  // Arrange.
+  NSUInteger const count = 1000;
+  NSMutableArray<NSString *> *letters = [NSMutableArray arrayWithCapacity:count];
+  NSMutableString *expectedString = [NSMutableString stringWithString:@">"];
+  for (NSUInteger i = 0; i < count; ++i) {
+    NSString *letter = [NSString stringWithFormat:@"%c", (char)('a' + i % 26)];
+    [letters addObject:letter];
+    [expectedString appendString:letter];
+  }
+
+  // Act.
+  FSLPromise<NSString *> *promise =
+      [[FSLPromise resolvedWith:@">"] treeReduce:letters
+                                         combine:^id(NSString *partialString, NSString *next) {
+                                           return [partialString stringByAppendingString:next];
+                                         }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, expectedString);
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseTreeReduceEmpty {
+  // Act.
+  FSLPromise *promise = [[FSLPromise resolvedWith:@42] treeReduce:@[]
+                                                          combine:^id(id __unused partial,
+                                                                      id __unused next) {
+                                                            XCTFail();
+                                                            return nil;
+                                                          }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+}
+
+- (void)testPromiseTreeReduceReject {
+  // Arrange.
+  NSArray<NSNumber *> *numbers = @[ @1, @2, @3, @4, @5, @6, @7, @8 ];
+
+  // Act.
+  FSLPromise *promise = [[FSLPromise resolvedWith:@0]
+      treeReduce:numbers
+         combine:^id(NSNumber *partialSum, NSNumber *nextNumber) {
+           NSInteger sum = partialSum.integerValue + nextNumber.integerValue;
+           // Fails at some point regardless of how the numbers are split, since the total is 36.
+           if (sum > 20) {
+             return [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+           }
+           return @(sum);
+         }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(promise.error.code, 42);
+  XCTAssertNil(promise.value);
+}
+
 @end
@@ -162,6 +162,33 @@
   XCTAssertEqual(count, expectedCount);
 }
 
+/**
+ Zero delays between attempts should not wait for the next tick of the timer wheel.
+ */
+- (void)testPromiseRetryZeroDelayDoesNotWaitForTimerTick {
+  // Arrange.
+  NSTimeInterval defaultTickInterval = FSLPromise.timerTickInterval;
+  FSLPromise.timerTickInterval = 10;
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise<NSNumber *> *promise = [FSLPromise attempts:3
+                                                   delay:0
+                                               condition:nil
+                                                   retry:^id {
+                                                     return ++count == 4 ? @42 : error;
+                                                   }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(1));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertEqual(count, 4u);
+
+  // Cleanup.
+  FSLPromise.timerTickInterval = defaultTickInterval;
+}
+
 - (void)testPromiseRetryRejectsBeforeRetryAttemptsAreExhaustedIfPredicateIsNotMet {
   // Arrange.
   NSInteger customAttempts = 3;
@@ -234,4 +261,124 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseRetryCancel {
+  // Arrange.
+  NSUInteger __block count = 0;
+  NSError *retryError = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+
+  // Act.
+  FSLPromise *promise = [FSLPromise attempts:10
+                                       delay:0.1
+                                   condition:nil
+                                       retry:^id {
+                                         ++count;
+                                         return retryError;
+                                       }];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  FSLDelay(0.05, ^{
+    [promise cancel];
+  });
+  FSLDelay(1, ^{
+    [expectation fulfill];
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertEqual(count, 1u);
+}
+
+- (void)testPromiseRetryBailsOnDeadline {
+  // Arrange.
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise attempts:10
+                                initialDelay:0.05
+                                    maxDelay:1
+                                      jitter:FSLPromiseRetryJitterNone
+                                    deadline:0.12
+                                      budget:nil
+                                   condition:nil
+                                       retry:^id {
+                                         ++count;
+                                         return [NSError errorWithDomain:FSLPromiseErrorDomain
+                                                                    code:42
+                                                                userInfo:nil];
+                                       }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(promise.error.code, 42);
+  // The second retry attempt would start after 0.05 + 0.1 seconds, past the deadline.
+  XCTAssertEqual(count, 2u);
+}
+
+- (void)testPromiseRetryDecorrelatedJitter {
+  // Arrange.
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise attempts:5
+                                initialDelay:0.001
+                                    maxDelay:0.01
+                                      jitter:FSLPromiseRetryJitterDecorrelated
+                                    deadline:0
+                                      budget:nil
+                                   condition:nil
+                                       retry:^id {
+                                         if (++count < 3) {
+                                           return [NSError errorWithDomain:FSLPromiseErrorDomain
+                                                                      code:42
+                                                                  userInfo:nil];
+                                         }
+                                         return @42;
+                                       }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertEqual(count, 3u);
+}
+
+- (void)testPromiseRetrySharedBudget {
+  // Arrange.
+  FSLPromiseRetryBudget *budget = [[FSLPromiseRetryBudget alloc] initWithMaxTokens:4
+                                                                        tokenRatio:0.5];
+  NSUInteger __block count = 0;
+  FSLPromiseRetryWorkBlock work = ^id {
+    ++count;
+    return [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  };
+
+  // Act.
+  [FSLPromise attempts:10
+          initialDelay:0
+              maxDelay:0
+                jitter:FSLPromiseRetryJitterNone
+              deadline:0
+                budget:budget
+             condition:nil
+                 retry:work];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  NSUInteger firstCount = count;
+  [FSLPromise attempts:10
+          initialDelay:0
+              maxDelay:0
+                jitter:FSLPromiseRetryJitterNone
+              deadline:0
+                budget:budget
+             condition:nil
+                 retry:work];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+
+  // Assert.
+  // The bucket drops to half full after the second failed attempt, and below after the third.
+  XCTAssertEqual(firstCount, 2u);
+  XCTAssertEqual(count - firstCount, 1u);
+  XCTAssertEqualWithAccuracy(budget.tokens, 1, 0.001);
+  [budget recordSuccess];
+  XCTAssertEqualWithAccuracy(budget.tokens, 1.5, 0.001);
+}
+
 @end
@@ -305,4 +305,255 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+/**
+ With the inline policy, a block chained to a resolved promise from another block running on the
+ same queue should be invoked synchronously.
+ */
+- (void)testPromiseThenInlinePolicyOnSameQueue {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  FSLPromise<NSNumber *> *promise = [FSLPromise resolvedWith:@42];
+  promise.executionPolicy = FSLPromiseExecutionPolicyInline;
+  BOOL __block isInvokedInline = NO;
+  BOOL __block isInvokedAsync = NO;
+
+  // Act.
+  [promise onQueue:queue
+              then:^id(NSNumber *value) {
+                BOOL __block isInvoked = NO;
+                [promise onQueue:queue
+                            then:^id(NSNumber *value) {
+                              isInvoked = YES;
+                              return value;
+                            }];
+                isInvokedInline = isInvoked;
+                isInvoked = NO;
+                [promise onQueue:queue
+                          policy:FSLPromiseExecutionPolicyAsync
+                            then:^id(NSNumber *value) {
+                              isInvoked = YES;
+                              return value;
+                            }];
+                isInvokedAsync = isInvoked;
+                return value;
+              }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(isInvokedInline);
+  XCTAssertFalse(isInvokedAsync);
+}
+
+/**
+ With the inline policy, a long chain of blocks should not overflow the stack.
+ */
+- (void)testPromiseThenInlinePolicyLongChain {
+  // Arrange.
+  NSUInteger const count = 100000;
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  promise.executionPolicy = FSLPromiseExecutionPolicyInline;
+  FSLPromise<NSNumber *> *chainedPromise = promise;
+
+  // Act.
+  for (NSUInteger i = 0; i < count; ++i) {
+    chainedPromise = [chainedPromise onQueue:queue
+                                        then:^id(NSNumber *value) {
+                                          return @(value.unsignedIntegerValue + 1);
+                                        }];
+  }
+  [promise fulfill:@0];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(chainedPromise.executionPolicy, FSLPromiseExecutionPolicyInline);
+  XCTAssertEqualObjects(chainedPromise.value, @(count));
+}
+
+/**
+ A pending promise returned from a `then` block should be adopted: both the promise returned by
+ `then` and the observers already registered on the adopted one get its resolution.
+ */
+- (void)testPromiseThenAdoptsReturnedPendingPromise {
+  // Arrange.
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *innerPromise = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *innerChainedPromise = [innerPromise then:^id(NSNumber *value) {
+    return @(value.integerValue + 1);
+  }];
+
+  // Act.
+  FSLPromise<NSNumber *> *chainedPromise = [promise then:^id(NSNumber __unused *_) {
+    return innerPromise;
+  }];
+  [promise fulfill:@0];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(chainedPromise.isPending);
+  XCTAssertTrue(innerPromise.isPending);
+  [innerPromise fulfill:@42];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(chainedPromise.value, @42);
+  XCTAssertEqualObjects(innerPromise.value, @42);
+  XCTAssertEqualObjects(innerChainedPromise.value, @43);
+}
+
+/**
+ A promise recursively resolved with the promises of the subsequent iterations shouldn't keep them
+ all alive until the recursion completes, but only the last one it adopts.
+ */
+- (void)testPromiseThenRecursiveAdoptionReleasesIntermediatePromises {
+  // Arrange.
+  NSUInteger const count = 1000;
+  dispatch_queue_t queue = dispatch_queue_create(
+      __FUNCTION__, dispatch_queue_attr_make_with_autorelease_frequency(
+                        DISPATCH_QUEUE_SERIAL, DISPATCH_AUTORELEASE_FREQUENCY_WORK_ITEM));
+  NSPointerArray *promises = [NSPointerArray weakObjectsPointerArray];
+
+  // Act.
+  FSLPromise<NSNumber *> *promise = [self countdownFrom:count onQueue:queue promises:promises];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @0);
+  XCTAssertEqual(promises.count, count + 1);
+  XCTAssertEqual(promises.allObjects.count, 2u);
+}
+
+/**
+ Cancelling a promise which adopted another one shouldn't resolve the adopted one, unless nothing
+ else observes it anymore.
+ */
+- (void)testPromiseThenCancelDoesNotResolveObservedAdoptedPromise {
+  // Arrange.
+  FSLPromise<NSNumber *> *promise = [FSLPromise resolvedWith:@0];
+  FSLPromise<NSNumber *> *innerPromise = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *chainedPromise1 = [promise then:^id(NSNumber __unused *_) {
+    return innerPromise;
+  }];
+  FSLPromise<NSNumber *> *chainedPromise2 = [promise then:^id(NSNumber __unused *_) {
+    return innerPromise;
+  }];
+  FSLPromise<NSNumber *> *innerChainedPromise = [innerPromise then:^id(NSNumber *value) {
+    return value;
+  }];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+
+  // Act.
+  [chainedPromise1 cancel];
+
+  // Assert.
+  XCTAssertTrue(innerPromise.isPending);
+  XCTAssertTrue(chainedPromise1.isPending);
+  XCTAssertTrue(chainedPromise2.isPending);
+
+  // Act.
+  [innerChainedPromise cancel];
+  [chainedPromise2 cancel];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(innerPromise.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(chainedPromise1.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(chainedPromise2.error));
+}
+
+/**
+ Rejecting a promise which adopted another one should be ignored rather than rejecting the adopted
+ one, which may be shared with other observers.
+ */
+- (void)testPromiseThenRejectDoesNotResolveAdoptedPromise {
+  // Arrange.
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  FSLPromise<NSNumber *> *promise = [FSLPromise resolvedWith:@0];
+  FSLPromise<NSNumber *> *innerPromise = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *chainedPromise = [promise then:^id(NSNumber __unused *_) {
+    return innerPromise;
+  }];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+
+  // Act.
+  [chainedPromise reject:error];
+  [innerPromise fulfill:@42];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(innerPromise.value, @42);
+  XCTAssertEqualObjects(chainedPromise.value, @42);
+}
+
+/**
+ Cancelling a chained promise should cancel the promise it's chained to, but only once nothing
+ else observes that one.
+ */
+- (void)testPromiseThenCancelPropagatesUpstream {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  FSLPromise *chainedPromise1 = [promise then:^id(id value) {
+    return value;
+  }];
+  FSLPromise *chainedPromise2 = [promise then:^id(id value) {
+    return value;
+  }];
+
+  // Act.
+  [chainedPromise1 cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(chainedPromise1.error));
+  XCTAssertTrue(promise.isPending);
+  XCTAssertTrue(chainedPromise2.isPending);
+
+  // Act.
+  [chainedPromise2 cancel];
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+}
+
+/**
+ Cancelling an upstream promise should reject the chained ones with the cancellation error.
+ */
+- (void)testPromiseThenCancelPropagatesDownstream {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  FSLPromise *chainedPromise = [promise then:^id(id value) {
+    XCTFail();
+    return value;
+  }];
+
+  // Act.
+  [promise cancel];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(chainedPromise.error));
+}
+
+#pragma mark - Private
+
+/**
+ Returns a promise resolved with zero after recursively counting down from `count` on `queue`,
+ collecting weak references to all the promises created along the way.
+ */
+- (FSLPromise<NSNumber *> *)countdownFrom:(NSUInteger)count
+                                  onQueue:(dispatch_queue_t)queue
+                                 promises:(NSPointerArray *)promises {
+  FSLPromise<NSNumber *> *promise = [[FSLPromise onQueue:queue
+                                                      do:^id {
+                                                        return @(count);
+                                                      }] onQueue:queue
+                                                            then:^id(NSNumber *value) {
+                                                              if (count == 0) {
+                                                                return value;
+                                                              }
+                                                              return [self countdownFrom:count - 1
+                                                                                 onQueue:queue
+                                                                                promises:promises];
+                                                            }];
+  [promises addPointer:(__bridge void *)promise];
+  return promise;
+}
+
 @end
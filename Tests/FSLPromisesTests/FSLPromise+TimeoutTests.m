@@ -99,4 +99,28 @@
   XCTAssertNil(weakExtendedPromise2);
 }
 
+- (void)testPromiseTimeoutWithCustomTimerTickInterval {
+  // Arrange.
+  NSTimeInterval defaultTickInterval = FSLPromise.timerTickInterval;
+  FSLPromise.timerTickInterval = 0.5;
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  FSLPromise *timeoutPromise = [[promise timeout:0.6] catch:^(NSError __unused *_) {
+    [expectation fulfill];
+  }];
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertTrue(FSLPromiseErrorIsTimedOut(timeoutPromise.error));
+  XCTAssertGreaterThanOrEqual([[NSDate date] timeIntervalSinceDate:startDate], 0.6);
+
+  // Cleanup.
+  [promise fulfill:nil];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  FSLPromise.timerTickInterval = defaultTickInterval;
+}
+
 @end
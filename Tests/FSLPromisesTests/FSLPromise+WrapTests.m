@@ -272,6 +272,24 @@
   XCTAssertNil(promise.value);
 }
 
+- (void)testPromiseWrap2ObjectsOrErrorCompletionCombineFulfillsOnValueReturned {
+  // Act.
+  FSLPromise<NSNumber *> *promise = [FSLPromise
+      wrap2ObjectsOrErrorCompletion:^(FSLPromise2ObjectsOrErrorCompletion handler) {
+        FSLDelay(0.1, ^{
+          [self wrapHarnessWithObject:@42 object:@13 error:nil completion:handler];
+        });
+      }
+      combine:^id(NSNumber *value1, NSNumber *value2) {
+        return @(value1.integerValue + value2.integerValue);
+      }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @55);
+  XCTAssertNil(promise.error);
+}
+
 - (void)testPromiseWrapBoolOrErrorCompletionFulfillsOnValueReturned {
   // Act.
   FSLPromise<NSNumber *> *promise =
@@ -416,6 +434,131 @@
   XCTAssertNil(promise.error);
 }
 
+- (void)testPromiseSyncWrapVoidCompletionFulfillsInline {
+  // Act.
+  FSLPromise *promise = [FSLPromise syncWrapCompletion:^(FSLPromiseCompletion handler) {
+    [self wrapHarnessWithCompletion:handler];
+  }];
+
+  // Assert.
+  XCTAssertTrue(promise.isFulfilled);
+  XCTAssertNil(promise.value);
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseSyncWrapObjectCompletionFulfillsOnValueReturned {
+  // Act.
+  FSLPromise<NSNumber *> *promise =
+  [FSLPromise syncWrapObjectCompletion:^(FSLPromiseObjectCompletion handler) {
+    FSLDelay(0.1, ^{
+      [self wrapHarnessWithObject:@42 completion:handler];
+    });
+  }];
+
+  // Assert.
+  XCTAssertTrue(promise.isPending);
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseSyncWrapObjectOrErrorCompletionRejectsOnErrorReturned {
+  // Arrange.
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+
+  // Act.
+  FSLPromise<NSNumber *> *promise =
+  [FSLPromise syncWrapObjectOrErrorCompletion:^(FSLPromiseObjectOrErrorCompletion handler) {
+    [self wrapHarnessWithObject:@42 error:error completion:handler];
+  }];
+
+  // Assert.
+  XCTAssertTrue(promise.isRejected);
+  XCTAssertEqualObjects(promise.error, error);
+  XCTAssertNil(promise.value);
+}
+
+- (void)testPromiseSyncWrap2ObjectsOrErrorCompletionFulfillsOnValueReturned {
+  // Arrange.
+  NSArray *expectedValues = @[ [NSNull null], @42 ];
+
+  // Act.
+  FSLPromise<NSArray *> *promise =
+  [FSLPromise syncWrap2ObjectsOrErrorCompletion:^(FSLPromise2ObjectsOrErrorCompletion handler) {
+    [self wrapHarnessWithObject:nil object:@42 error:nil completion:handler];
+  }];
+
+  // Assert.
+  XCTAssertEqualObjects(promise.value, expectedValues);
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseSyncWrap2ObjectsOrErrorCompletionCombineFulfillsInline {
+  // Act.
+  FSLPromise<NSNumber *> *promise = [FSLPromise
+      syncWrap2ObjectsOrErrorCompletion:^(FSLPromise2ObjectsOrErrorCompletion handler) {
+        [self wrapHarnessWithObject:nil object:@42 error:nil completion:handler];
+      }
+      combine:^id(id __nullable value1, id __nullable value2) {
+        return value1 ?: value2;
+      }];
+
+  // Assert.
+  XCTAssertEqualObjects(promise.value, @42);
+  XCTAssertNil(promise.error);
+}
+
+- (void)testPromiseSyncWrap2ObjectsOrErrorCompletionCombineRejectsOnErrorReturned {
+  // Arrange.
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  __block BOOL isCombined = NO;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise
+      syncWrap2ObjectsOrErrorCompletion:^(FSLPromise2ObjectsOrErrorCompletion handler) {
+        [self wrapHarnessWithObject:@42 object:@13 error:error completion:handler];
+      }
+      combine:^id(id __nullable value1, id __nullable __unused value2) {
+        isCombined = YES;
+        return value1;
+      }];
+
+  // Assert.
+  XCTAssertEqualObjects(promise.error, error);
+  XCTAssertNil(promise.value);
+  XCTAssertFalse(isCombined);
+}
+
+- (void)testPromiseSyncWrapIntegerOrErrorCompletionRejectsOnErrorReturned {
+  // Arrange.
+  NSError *error = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+
+  // Act.
+  FSLPromise<NSNumber *> *promise =
+  [FSLPromise syncWrapIntegerOrErrorCompletion:^(FSLPromiseIntegerOrErrorCompletion handler) {
+    FSLDelay(0.1, ^{
+      [self wrapHarnessWithInteger:42 error:error completion:handler];
+    });
+  }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.error, error);
+  XCTAssertNil(promise.value);
+}
+
+- (void)testPromiseSyncWrapDoubleCompletionFulfillsInline {
+  // Act.
+  FSLPromise<NSNumber *> *promise =
+  [FSLPromise syncWrapDoubleCompletion:^(FSLPromiseDoubleCompletion handler) {
+    [self wrapHarnessWithDouble:42.0 completion:handler];
+  }];
+
+  // Assert.
+  XCTAssertEqualObjects(promise.value, @42.0);
+  XCTAssertNil(promise.error);
+}
+
 #pragma mark - Private
 
 - (void)wrapHarnessWithCompletion:(FSLPromiseCompletion)handler {
@@ -0,0 +1,188 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseCircuitBreaker.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Retry.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseCircuitBreakerTests : XCTestCase
+@end
+
+@implementation FSLPromiseCircuitBreakerTests
+
+- (void)testCircuitBreakerOpensOnFailureRate {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:0.5
+                                                     minResultsCount:4
+                                                      windowInterval:60
+                                                    coolDownInterval:60
+                                                         probesCount:1];
+
+  // Act.
+  [breaker recordSuccess];
+  [breaker recordFailure];
+  [breaker recordFailure];
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateClosed);
+  [breaker recordSuccess];
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateClosed);
+  [breaker recordFailure];
+
+  // Assert.
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateOpen);
+  XCTAssertFalse([breaker allowsWork]);
+}
+
+- (void)testCircuitBreakerRejectsWhileOpen {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:1
+                                                     minResultsCount:1
+                                                      windowInterval:60
+                                                    coolDownInterval:60
+                                                         probesCount:1];
+  NSUInteger __block count = 0;
+  FSLPromiseCircuitBreakerWorkBlock work = ^id {
+    ++count;
+    return [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  };
+
+  // Act.
+  FSLPromise *failedPromise = [breaker execute:work];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  FSLPromise *rejectedPromise = [breaker execute:work];
+
+  // Assert.
+  XCTAssertEqual(failedPromise.error.code, 42);
+  XCTAssertTrue(FSLPromiseErrorIsCircuitOpen(rejectedPromise.error));
+  XCTAssertEqual(count, 1u);
+}
+
+- (void)testCircuitBreakerProbesAfterCoolDown {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:1
+                                                     minResultsCount:1
+                                                      windowInterval:60
+                                                    coolDownInterval:0.05
+                                                         probesCount:1];
+  [breaker recordFailure];
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateOpen);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+
+  // Act.
+  FSLDelay(0.1, ^{
+    XCTAssertTrue([breaker allowsWork]);
+    XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateHalfOpen);
+    // Only one probe at a time.
+    XCTAssertFalse([breaker allowsWork]);
+    [breaker recordSuccess];
+    [expectation fulfill];
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateClosed);
+  XCTAssertTrue([breaker allowsWork]);
+}
+
+- (void)testCircuitBreakerReopensOnFailedProbe {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:1
+                                                     minResultsCount:1
+                                                      windowInterval:60
+                                                    coolDownInterval:0.05
+                                                         probesCount:1];
+  [breaker recordFailure];
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+
+  // Act.
+  FSLDelay(0.1, ^{
+    XCTAssertTrue([breaker allowsWork]);
+    [breaker recordFailure];
+    [expectation fulfill];
+  });
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateOpen);
+  XCTAssertFalse([breaker allowsWork]);
+}
+
+- (void)testCircuitBreakerTimeoutCountsAsFailure {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:1
+                                                     minResultsCount:1
+                                                      windowInterval:60
+                                                    coolDownInterval:60
+                                                         probesCount:1];
+  FSLPromise *pendingPromise = [FSLPromise pendingPromise];
+
+  // Act.
+  FSLPromise *promise = [breaker onQueue:dispatch_get_main_queue()
+                                 timeout:0.05
+                                 execute:^id {
+                                   return pendingPromise;
+                                 }];
+  // The pending promise keeps the wait from succeeding.
+  FSLWaitForPromisesWithTimeout(0.5);
+
+  // Assert.
+  XCTAssertTrue(FSLPromiseErrorIsTimedOut(promise.error));
+  XCTAssertEqual(breaker.state, FSLPromiseCircuitBreakerStateOpen);
+
+  // Cleanup.
+  [pendingPromise fulfill:nil];
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+}
+
+- (void)testCircuitBreakerNoRetryWhileOpen {
+  // Arrange.
+  FSLPromiseCircuitBreaker *breaker =
+      [[FSLPromiseCircuitBreaker alloc] initWithFailureRateThreshold:1
+                                                     minResultsCount:1
+                                                      windowInterval:60
+                                                    coolDownInterval:60
+                                                         probesCount:1];
+  [breaker recordFailure];
+  NSUInteger __block count = 0;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise attempts:5
+                                       delay:0
+                                   condition:nil
+                                       retry:^id {
+                                         ++count;
+                                         return [breaker execute:^id {
+                                           XCTFail();
+                                           return nil;
+                                         }];
+                                       }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(FSLPromiseErrorIsCircuitOpen(promise.error));
+  XCTAssertEqual(count, 1u);
+}
+
+@end
@@ -0,0 +1,190 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseExecutor.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+All.h"
+#import "FSLPromise+Async.h"
+#import "FSLPromise+Catch.h"
+#import "FSLPromise+Then.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+/**
+ Executor that keeps the blocks until drained by the test, like a run loop pumped by the caller.
+ */
+@interface FSLPromisesTestExecutor : NSObject <FSLPromiseExecutor>
+
+/** Number of blocks executed so far. */
+@property(nonatomic, readonly) NSUInteger executedBlocksCount;
+
+/** Number of blocks waiting to be executed. */
+@property(nonatomic, readonly) NSUInteger pendingBlocksCount;
+
+/** Executes the blocks in order, including the ones they add, until there are none left. */
+- (void)drain;
+
+@end
+
+@implementation FSLPromisesTestExecutor {
+  NSMutableArray<dispatch_block_t> *_blocks;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _blocks = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (NSUInteger)pendingBlocksCount {
+  @synchronized(self) {
+    return _blocks.count;
+  }
+}
+
+- (void)executeBlock:(dispatch_block_t)block {
+  @synchronized(self) {
+    [_blocks addObject:block];
+  }
+}
+
+- (void)drain {
+  while (YES) {
+    dispatch_block_t block;
+    @synchronized(self) {
+      block = _blocks.firstObject;
+      if (!block) {
+        return;
+      }
+      [_blocks removeObjectAtIndex:0];
+      ++_executedBlocksCount;
+    }
+    block();
+  }
+}
+
+@end
+
+@interface FSLPromiseExecutorTests : XCTestCase
+@end
+
+@implementation FSLPromiseExecutorTests
+
+- (void)testThenOnExecutor {
+  // Arrange.
+  FSLPromisesTestExecutor *executor = [[FSLPromisesTestExecutor alloc] init];
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  FSLPromise *thenPromise = [promise onExecutor:executor
+                                           then:^id(NSNumber *value) {
+                                             return @(value.integerValue + 1);
+                                           }];
+
+  // Act.
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertEqual(executor.pendingBlocksCount, 1u);
+  XCTAssertTrue(thenPromise.isPending);
+  [executor drain];
+  XCTAssertEqualObjects(thenPromise.value, @43);
+  XCTAssertEqual(executor.executedBlocksCount, 1u);
+}
+
+- (void)testCatchOnExecutor {
+  // Arrange.
+  FSLPromisesTestExecutor *executor = [[FSLPromisesTestExecutor alloc] init];
+  NSError *expectedError = [NSError errorWithDomain:FSLPromiseErrorDomain code:42 userInfo:nil];
+  NSError __block *caughtError;
+
+  // Act.
+  FSLPromise *promise = [[FSLPromise resolvedWith:expectedError] onExecutor:executor
+                                                                      catch:^(NSError *error) {
+                                                                        caughtError = error;
+                                                                      }];
+  [executor drain];
+
+  // Assert.
+  XCTAssertEqualObjects(caughtError, expectedError);
+  XCTAssertEqualObjects(promise.error, expectedError);
+}
+
+- (void)testInlinePolicyOnExecutor {
+  // Arrange.
+  FSLPromisesTestExecutor *executor = [[FSLPromisesTestExecutor alloc] init];
+  FSLPromise<NSNumber *> *promise = [FSLPromise resolvedWith:@0];
+  FSLPromiseThenWorkBlock increment = ^id(NSNumber *value) {
+    return @(value.integerValue + 1);
+  };
+
+  // Act.
+  for (NSUInteger i = 0; i < 3; ++i) {
+    promise = [promise onExecutor:executor policy:FSLPromiseExecutionPolicyInline then:increment];
+  }
+  [executor drain];
+
+  // Assert.
+  XCTAssertEqualObjects(promise.value, @3);
+  XCTAssertEqual(executor.executedBlocksCount, 1u);
+}
+
+- (void)testAllOnExecutor {
+  // Arrange.
+  FSLPromisesTestExecutor *executor = [[FSLPromisesTestExecutor alloc] init];
+  FSLPromise<NSNumber *> *promise1 = [FSLPromise pendingPromise];
+  FSLPromise<NSNumber *> *promise2 = [FSLPromise pendingPromise];
+
+  // Act.
+  FSLPromise<NSArray *> *combinedPromise =
+      [FSLPromise onExecutor:executor all:@[ promise1, promise2, @3 ]];
+  [executor drain];
+  [promise2 fulfill:@2];
+  [promise1 fulfill:@1];
+  [executor drain];
+
+  // Assert.
+  XCTAssertEqualObjects(combinedPromise.value, (@[ @1, @2, @3 ]));
+}
+
+- (void)testAsyncOnDispatchQueueExecutor {
+  // Arrange.
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  static char const key;
+  dispatch_queue_set_specific(queue, &key, (void *)&key, NULL);
+  FSLPromiseDispatchQueueExecutor *executor =
+      [[FSLPromiseDispatchQueueExecutor alloc] initWithQueue:queue];
+  BOOL __block isOnQueue = NO;
+
+  // Act.
+  FSLPromise *promise =
+      [FSLPromise onExecutor:executor
+                       async:^(FSLPromiseFulfillBlock fulfill, FSLPromiseRejectBlock __unused _) {
+                         isOnQueue = dispatch_get_specific(&key) == &key;
+                         fulfill(@42);
+                       }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(executor.queue, queue);
+  XCTAssertTrue(isOnQueue);
+  XCTAssertEqualObjects(promise.value, @42);
+}
+
+@end
@@ -0,0 +1,174 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseInstrumentation.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromise+Then.h"
+#import "FSLPromisesTestHelpers.h"
+
+/** Keeps the events recorded for the promise it's interested in. */
+@interface FSLPromiseInstrumentationTestSink : NSObject <FSLPromiseInstrumentationSink>
+@property(nonatomic) uintptr_t object;
+@property(nonatomic, readonly) NSMutableArray<NSNumber *> *kinds;
+@property(nonatomic, readonly) NSMutableArray<NSNumber *> *pendingIntervals;
+@end
+
+@implementation FSLPromiseInstrumentationTestSink
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _kinds = [[NSMutableArray alloc] init];
+    _pendingIntervals = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (void)promiseInstrumentationDidRecordEvents:(FSLPromiseInstrumentationEvent const *)events
+                                        count:(NSUInteger)count {
+  @synchronized(self) {
+    for (NSUInteger i = 0; i < count; ++i) {
+      if (events[i].object == self.object) {
+        [self.kinds addObject:@(events[i].kind)];
+        [self.pendingIntervals addObject:@(events[i].pendingInterval)];
+      }
+    }
+  }
+}
+
+@end
+
+@interface FSLPromiseInstrumentationTests : XCTestCase
+@end
+
+@implementation FSLPromiseInstrumentationTests
+
+- (void)tearDown {
+  [FSLPromiseInstrumentation flush];
+  FSLPromiseInstrumentation.sink = nil;
+  [super tearDown];
+}
+
+- (void)testInstrumentationSink {
+  // Arrange.
+  FSLPromiseInstrumentationTestSink *sink = [[FSLPromiseInstrumentationTestSink alloc] init];
+
+  // Act.
+  FSLPromiseInstrumentation.sink = sink;
+
+  // Assert.
+  XCTAssertEqual(FSLPromiseInstrumentation.sink, sink);
+}
+
+- (void)testInstrumentationRecordsPromiseLifecycle {
+  // Arrange.
+  FSLPromiseInstrumentationTestSink *sink = [[FSLPromiseInstrumentationTestSink alloc] init];
+  FSLPromiseInstrumentation.sink = sink;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  sink.object = (uintptr_t)promise;
+  [promise then:^id(id value) {
+    return value;
+  }];
+  usleep(1000);
+  [promise fulfill:@42];
+  [FSLPromiseInstrumentation flush];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  if (FSLPromiseInstrumentation.isEnabled) {
+    NSArray<NSNumber *> *expectedKinds = @[
+      @(FSLPromiseInstrumentationEventKindCreated), @(FSLPromiseInstrumentationEventKindObserved),
+      @(FSLPromiseInstrumentationEventKindFulfilled)
+    ];
+    XCTAssertEqualObjects(sink.kinds, expectedKinds);
+    XCTAssertGreaterThanOrEqual(sink.pendingIntervals.lastObject.unsignedLongLongValue,
+                                NSEC_PER_MSEC);
+  } else {
+    XCTAssertEqual(sink.kinds.count, 0u);
+  }
+}
+
+- (void)testInstrumentationRecordsResolvedPromiseLifecycle {
+  // Arrange.
+  FSLPromiseInstrumentationTestSink *sink = [[FSLPromiseInstrumentationTestSink alloc] init];
+  FSLPromiseInstrumentation.sink = sink;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise resolvedWith:@42];
+  sink.object = (uintptr_t)promise;
+  [FSLPromiseInstrumentation flush];
+
+  // Assert.
+  if (FSLPromiseInstrumentation.isEnabled) {
+    NSArray<NSNumber *> *expectedKinds = @[
+      @(FSLPromiseInstrumentationEventKindCreated), @(FSLPromiseInstrumentationEventKindFulfilled)
+    ];
+    XCTAssertEqualObjects(sink.kinds, expectedKinds);
+  } else {
+    XCTAssertEqual(sink.kinds.count, 0u);
+  }
+}
+
+- (void)testInstrumentationFlushAllThreads {
+  // Arrange.
+  FSLPromiseInstrumentationTestSink *sink = [[FSLPromiseInstrumentationTestSink alloc] init];
+  FSLPromiseInstrumentation.sink = sink;
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  __block FSLPromise *promise;
+  // Record the creation on another thread, which keeps it buffered.
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    promise = [FSLPromise pendingPromise];
+    dispatch_semaphore_signal(semaphore);
+  });
+  dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+  sink.object = (uintptr_t)promise;
+
+  // Act.
+  [FSLPromiseInstrumentation flushAllThreads];
+
+  // Assert.
+  if (FSLPromiseInstrumentation.isEnabled) {
+    XCTAssertEqualObjects(sink.kinds, @[ @(FSLPromiseInstrumentationEventKindCreated) ]);
+  } else {
+    XCTAssertEqual(sink.kinds.count, 0u);
+  }
+
+  // Cleanup.
+  [promise fulfill:nil];
+}
+
+- (void)testInstrumentationRecordsNothingWithoutSink {
+  // Arrange.
+  FSLPromiseInstrumentationTestSink *sink = [[FSLPromiseInstrumentationTestSink alloc] init];
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  sink.object = (uintptr_t)promise;
+
+  // Act.
+  [promise fulfill:@42];
+  FSLPromiseInstrumentation.sink = sink;
+  [FSLPromiseInstrumentation flush];
+
+  // Assert.
+  XCTAssertEqual(sink.kinds.count, 0u);
+}
+
+@end
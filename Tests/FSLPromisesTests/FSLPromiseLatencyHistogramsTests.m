@@ -0,0 +1,115 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseLatencyHistograms.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+#import "FSLPromise+Then.h"
+#import "FSLPromiseInstrumentation.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseLatencyHistogramsTests : XCTestCase
+@end
+
+@implementation FSLPromiseLatencyHistogramsTests
+
+- (void)setUp {
+  [super setUp];
+  [FSLPromiseLatencyHistograms reset];
+  FSLPromiseLatencyHistograms.enabled = YES;
+}
+
+- (void)tearDown {
+  FSLPromiseLatencyHistograms.enabled = NO;
+  [FSLPromiseLatencyHistograms reset];
+  [super tearDown];
+}
+
+/** Returns the histogram of the given metric, combinator and label from a snapshot, if any. */
+static FSLPromiseLatencyHistogram *FSLLatencyHistogram(FSLPromiseLatencyMetric metric,
+                                                       NSString *combinator, NSString *label) {
+  for (FSLPromiseLatencyHistogram *histogram in [FSLPromiseLatencyHistograms snapshot]) {
+    if (histogram.metric == metric &&
+        (histogram.combinator == combinator || [histogram.combinator isEqual:combinator]) &&
+        [histogram.label isEqual:label]) {
+      return histogram;
+    }
+  }
+  return nil;
+}
+
+- (void)testLatencyHistogramsRecordLabeledChain {
+  // Arrange.
+  __block FSLPromise *promise;
+  NSString *label = @"testLatencyHistogramsRecordLabeledChain";
+
+  // Act.
+  [FSLPromiseLatencyHistograms performWithLabel:label
+                                           work:^{
+                                             promise = [FSLPromise pendingPromise];
+                                             [promise then:^id(id value) {
+                                               return value;
+                                             }];
+                                           }];
+  usleep(1000);
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  FSLPromiseLatencyHistogram *pending =
+      FSLLatencyHistogram(FSLPromiseLatencyMetricPending, nil, label);
+  FSLPromiseLatencyHistogram *run = FSLLatencyHistogram(FSLPromiseLatencyMetricRun, @"then", label);
+  if (FSLPromiseInstrumentation.isEnabled) {
+    XCTAssertEqual(pending.count, 1u);
+    XCTAssertGreaterThanOrEqual(pending.totalInterval, 0.001);
+    XCTAssertGreaterThanOrEqual([pending intervalAtPercentile:50], 0.001);
+    XCTAssertEqual(run.count, 1u);
+    XCTAssertEqual(FSLLatencyHistogram(FSLPromiseLatencyMetricQueueWait, @"then", label).count,
+                   1u);
+  } else {
+    XCTAssertNil(pending);
+    XCTAssertNil(run);
+  }
+}
+
+- (void)testLatencyHistogramsReset {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  [promise fulfill:@42];
+
+  // Act.
+  [FSLPromiseLatencyHistograms reset];
+
+  // Assert.
+  XCTAssertEqual([FSLPromiseLatencyHistograms snapshot].count, 0u);
+}
+
+- (void)testLatencyHistogramsRecordNothingWhileDisabled {
+  // Arrange.
+  FSLPromiseLatencyHistograms.enabled = NO;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertEqual([FSLPromiseLatencyHistograms snapshot].count, 0u);
+}
+
+@end
@@ -0,0 +1,115 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseLeakDetector.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Testing.h"
+
+@interface FSLPromiseLeakDetectorTests : XCTestCase
+@end
+
+@implementation FSLPromiseLeakDetectorTests
+
+- (void)setUp {
+  [super setUp];
+  [FSLPromiseLeakDetector reset];
+  FSLPromiseLeakDetector.enabled = YES;
+  FSLPromiseLeakDetector.callStackSamplingInterval = 1;
+}
+
+- (void)tearDown {
+  FSLPromiseLeakDetector.enabled = NO;
+  FSLPromiseLeakDetector.callStackSamplingInterval = 100;
+  [FSLPromiseLeakDetector reset];
+  [super tearDown];
+}
+
+/** Returns the leak reported about `address`, if any. */
+static FSLPromiseLeak *FSLLeakWithAddress(NSArray<FSLPromiseLeak *> *leaks, uintptr_t address) {
+  for (FSLPromiseLeak *leak in leaks) {
+    if (leak.address == address) {
+      return leak;
+    }
+  }
+  return nil;
+}
+
+- (void)testLeakDetectorReportsLongPendingPromise {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  uintptr_t const address = (uintptr_t)(__bridge void *)promise;
+
+  // Act.
+  FSLPromiseLeak *leak =
+      FSLLeakWithAddress([FSLPromiseLeakDetector pendingPromisesOlderThan:0], address);
+  FSLPromiseLeak *newLeak =
+      FSLLeakWithAddress([FSLPromiseLeakDetector pendingPromisesOlderThan:60], address);
+
+  // Assert.
+  XCTAssertNotNil(leak);
+  XCTAssertFalse(leak.isDeallocated);
+  XCTAssertEqual(leak.promiseClass, [FSLPromise class]);
+  XCTAssertGreaterThan(leak.creationCallStackSymbols.count, 0u);
+  XCTAssertNil(newLeak);
+}
+
+- (void)testLeakDetectorForgetsResolvedPromise {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  uintptr_t const address = (uintptr_t)(__bridge void *)promise;
+
+  // Act.
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertNil(FSLLeakWithAddress([FSLPromiseLeakDetector pendingPromisesOlderThan:0], address));
+  XCTAssertEqual(FSLPromiseLeakDetector.deallocatedPendingPromises.count, 0u);
+}
+
+- (void)testLeakDetectorReportsDeallocatedPendingPromise {
+  // Arrange.
+  uintptr_t address = 0;
+
+  // Act.
+  @autoreleasepool {
+    FSLPromise *promise = [FSLPromise pendingPromise];
+    address = (uintptr_t)(__bridge void *)promise;
+  }
+
+  // Assert.
+  FSLPromiseLeak *leak = FSLLeakWithAddress(FSLPromiseLeakDetector.deallocatedPendingPromises,
+                                            address);
+  XCTAssertNotNil(leak);
+  XCTAssertTrue(leak.isDeallocated);
+  XCTAssertNil(FSLLeakWithAddress([FSLPromiseLeakDetector pendingPromisesOlderThan:0], address));
+}
+
+- (void)testLeakDetectorIgnoresPromisesWhileDisabled {
+  // Arrange.
+  FSLPromiseLeakDetector.enabled = NO;
+
+  // Act.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+
+  // Assert.
+  XCTAssertEqual(FSLPromiseLeakDetector.pendingPromisesCount, 0u);
+  XCTAssertTrue(promise.isPending);
+}
+
+@end
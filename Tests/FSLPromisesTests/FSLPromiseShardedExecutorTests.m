@@ -0,0 +1,110 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#import "FSLPromiseShardedExecutor.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+Do.h"
+#import "FSLPromise+Then.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+@interface FSLPromiseShardedExecutorTests : XCTestCase
+@end
+
+@implementation FSLPromiseShardedExecutorTests
+
+- (void)testExecutorForKey {
+  // Arrange.
+  FSLPromiseShardedExecutor *sharded =
+      [[FSLPromiseShardedExecutor alloc] initWithShardsCount:4 pinsShardsToProcessors:NO];
+  NSMutableSet<NSNumber *> *shardIndexes = [[NSMutableSet alloc] init];
+  NSString *equalKey = [@"us" stringByAppendingString:@"er"];
+
+  // Act.
+  for (NSUInteger i = 0; i < 1000; ++i) {
+    [shardIndexes addObject:@([sharded shardIndexForKey:@(i)])];
+  }
+
+  // Assert.
+  XCTAssertEqual(sharded.shardsCount, 4u);
+  XCTAssertEqualObjects(shardIndexes, ([NSSet setWithArray:@[ @0, @1, @2, @3 ]]));
+  XCTAssertEqual([sharded executorForKey:@"user"], [sharded executorForKey:equalKey]);
+}
+
+- (void)testOrderPerKey {
+  // Arrange.
+  FSLPromiseShardedExecutor *sharded =
+      [[FSLPromiseShardedExecutor alloc] initWithShardsCount:4 pinsShardsToProcessors:YES];
+  NSArray<NSString *> *keys = @[ @"a", @"b", @"c", @"d", @"e", @"f", @"g", @"h" ];
+  NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *orders =
+      [[NSMutableDictionary alloc] init];
+  NSMutableArray<NSNumber *> *expectedOrder = [[NSMutableArray alloc] init];
+  for (NSString *key in keys) {
+    orders[key] = [[NSMutableArray alloc] init];
+  }
+  for (NSUInteger i = 0; i < 100; ++i) {
+    [expectedOrder addObject:@(i)];
+  }
+
+  // Act.
+  for (NSUInteger i = 0; i < 100; ++i) {
+    for (NSString *key in keys) {
+      // Only the shard for the key ever touches its array.
+      NSMutableArray<NSNumber *> *order = orders[key];
+      [FSLPromise onExecutor:[sharded executorForKey:key]
+                          do:^id {
+                            [order addObject:@(i)];
+                            return nil;
+                          }];
+    }
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  for (NSString *key in keys) {
+    XCTAssertEqualObjects(orders[key], expectedOrder);
+  }
+}
+
+- (void)testThenOnShardForKey {
+  // Arrange.
+  FSLPromiseShardedExecutor *sharded = [[FSLPromiseShardedExecutor alloc] init];
+  id<FSLPromiseExecutor> executor = [sharded executorForKey:@42];
+  NSThread __block *doThread;
+  NSThread __block *thenThread;
+
+  // Act.
+  FSLPromise *promise = [[FSLPromise onExecutor:executor
+                                             do:^id {
+                                               doThread = NSThread.currentThread;
+                                               return @1;
+                                             }] onExecutor:executor
+                                                      then:^id(NSNumber *value) {
+                                                        thenThread = NSThread.currentThread;
+                                                        return @(value.integerValue + 1);
+                                                      }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @2);
+  XCTAssertNotNil(doThread);
+  XCTAssertEqual(doThread, thenThread);
+  XCTAssertNotEqual(doThread, NSThread.currentThread);
+}
+
+@end
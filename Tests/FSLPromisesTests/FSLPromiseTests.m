@@ -17,6 +17,7 @@
 #import <XCTest/XCTest.h>
 
 #import "FSLPromise+Testing.h"
+#import "FSLPromise+Then.h"
 
 @interface FSLPromiseTests : XCTestCase
 @end
@@ -218,4 +219,151 @@
   XCTAssertNil(weakPromise);
 }
 
+/**
+ Concurrently observing and resolving a pending promise should notify every observer exactly once
+ with the only resolution that won.
+ */
+- (void)testPromiseConcurrentObserveAndResolve {
+  // Arrange.
+  static size_t const count = 1000;
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+  NSMutableArray<NSNumber *> *observedValues = [[NSMutableArray alloc] init];
+
+  // Act.
+  dispatch_apply(count, queue, ^(size_t index) {
+    [promise onQueue:queue
+                then:^id(NSNumber *value) {
+                  @synchronized(observedValues) {
+                    [observedValues addObject:value];
+                  }
+                  return value;
+                }];
+    if (index % 2) {
+      [promise fulfill:@(index)];
+    } else {
+      XCTAssertNotNil(promise.description);
+    }
+  });
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(promise.isFulfilled);
+  XCTAssertEqual(observedValues.count, count);
+  XCTAssertEqual([NSSet setWithArray:observedValues].count, 1u);
+  XCTAssertEqualObjects(observedValues.firstObject, promise.value);
+}
+
+/**
+ Pending promise should be tracked by the dispatch group set at the moment of its creation.
+ */
+- (void)testPromiseDispatchGroupTracksPendingPromise {
+  // Arrange.
+  dispatch_group_t defaultDispatchGroup = FSLPromise.dispatchGroup;
+  dispatch_group_t dispatchGroup = dispatch_group_create();
+  FSLPromise.dispatchGroup = dispatchGroup;
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+  FSLPromise.dispatchGroup = defaultDispatchGroup;
+
+  // Act.
+  long waitResultBeforeFulfill = dispatch_group_wait(dispatchGroup, DISPATCH_TIME_NOW);
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertNotEqual(waitResultBeforeFulfill, 0);
+  XCTAssertEqual(dispatch_group_wait(dispatchGroup, DISPATCH_TIME_NOW), 0);
+}
+
+/**
+ A dispatch group replaced with another one should be released once its promises are resolved.
+ */
+- (void)testPromiseDispatchGroupReleasedOnceReplaced {
+  // Arrange.
+  dispatch_group_t defaultDispatchGroup = FSLPromise.dispatchGroup;
+  dispatch_group_t __weak weakDispatchGroup;
+  FSLPromise<NSNumber *> *promise;
+  @autoreleasepool {
+    dispatch_group_t dispatchGroup = dispatch_group_create();
+    weakDispatchGroup = dispatchGroup;
+    FSLPromise.dispatchGroup = dispatchGroup;
+    promise = [FSLPromise pendingPromise];
+    FSLPromise.dispatchGroup = defaultDispatchGroup;
+  }
+  XCTAssertNotNil(weakDispatchGroup);
+
+  // Act.
+  @autoreleasepool {
+    [promise fulfill:@42];
+    promise = nil;
+  }
+
+  // Assert.
+  XCTAssertNil(weakDispatchGroup);
+}
+
+/**
+ Promise created without a dispatch group should still notify its observers.
+ */
+- (void)testPromiseWithoutDispatchGroup {
+  // Arrange.
+  dispatch_group_t defaultDispatchGroup = FSLPromise.dispatchGroup;
+  FSLPromise.dispatchGroup = nil;
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  FSLPromise<NSNumber *> *promise = [FSLPromise pendingPromise];
+
+  // Act.
+  [promise then:^id(NSNumber *value) {
+    XCTAssertEqualObjects(value, @42);
+    [expectation fulfill];
+    return value;
+  }];
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertTrue(FSLWaitForPromisesWithTimeout(0));
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  FSLPromise.dispatchGroup = defaultDispatchGroup;
+}
+
+- (void)testPromiseCancel {
+  // Arrange.
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  FSLPromise *resolvedPromise = [FSLPromise resolvedWith:@42];
+
+  // Act.
+  [promise cancel];
+  [resolvedPromise cancel];
+  [promise fulfill:@42];
+
+  // Assert.
+  XCTAssertTrue(promise.isRejected);
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertEqualObjects(resolvedPromise.value, @42);
+}
+
+/**
+ Cancelling the last promise of a long chain should cancel all of them without overflowing the
+ stack.
+ */
+- (void)testPromiseCancelLongChain {
+  // Arrange.
+  NSUInteger const count = 100000;
+  FSLPromise *promise = [FSLPromise pendingPromise];
+  FSLPromise *chainedPromise = promise;
+  for (NSUInteger i = 0; i < count; ++i) {
+    chainedPromise = [chainedPromise then:^id(id value) {
+      XCTFail();
+      return value;
+    }];
+  }
+
+  // Act.
+  [chainedPromise cancel];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(promise.error));
+  XCTAssertTrue(FSLPromiseErrorIsCancelled(chainedPromise.error));
+}
+
 @end
@@ -0,0 +1,180 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseTimerWheel.h"
+
+#import <XCTest/XCTest.h>
+
+@interface FSLPromiseTimerWheelTests : XCTestCase
+@end
+
+@implementation FSLPromiseTimerWheelTests
+
+- (void)testTimerWheelFiresOnQueueAfterInterval {
+  // Arrange.
+  FSLPromiseTimerWheel *wheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:0.01];
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  static char key;
+  dispatch_queue_set_specific(queue, &key, &key, NULL);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  __block BOOL isOnQueue = NO;
+  __block NSTimeInterval elapsedInterval = 0;
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  [wheel scheduleAfterInterval:0.1
+                       onQueue:queue
+                         block:^{
+                           isOnQueue = dispatch_get_specific(&key) == &key;
+                           elapsedInterval = [[NSDate date] timeIntervalSinceDate:startDate];
+                           [expectation fulfill];
+                         }];
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertTrue(isOnQueue);
+  XCTAssertGreaterThanOrEqual(elapsedInterval, 0.1);
+}
+
+/**
+ Timers should fire at the granularity of the ticks, i.e. not earlier than one tick away.
+ */
+- (void)testTimerWheelRoundsIntervalsUpToTicks {
+  // Arrange.
+  FSLPromiseTimerWheel *wheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:0.2];
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  expectation.expectedFulfillmentCount = 2;
+  NSMutableArray<NSNumber *> *elapsedIntervals = [[NSMutableArray alloc] init];
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  for (NSNumber *interval in @[ @0, @0.01 ]) {
+    [wheel scheduleAfterInterval:interval.doubleValue
+                         onQueue:queue
+                           block:^{
+                             [elapsedIntervals
+                                 addObject:@([[NSDate date] timeIntervalSinceDate:startDate])];
+                             [expectation fulfill];
+                           }];
+  }
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqual(elapsedIntervals.count, 2u);
+  for (NSNumber *elapsedInterval in elapsedIntervals) {
+    XCTAssertGreaterThanOrEqual(elapsedInterval.doubleValue, 0.2);
+  }
+}
+
+/**
+ Timers further away than the number of slots should wait for as many rounds of the cursor, while
+ the ones sharing their slot in earlier rounds fire in between.
+ */
+- (void)testTimerWheelFiresTimersSpanningMultipleRounds {
+  // Arrange.
+  FSLPromiseTimerWheel *wheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:0.01
+                                                                         slotsCount:4];
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  expectation.expectedFulfillmentCount = 3;
+  NSMutableArray<NSNumber *> *intervals = [[NSMutableArray alloc] init];
+  NSMutableArray<NSNumber *> *elapsedIntervals = [[NSMutableArray alloc] init];
+  NSDate *startDate = [NSDate date];
+
+  // Act.
+  // 4, 12 and 20 ticks away, i.e. the same slot in the first, third and fifth rounds.
+  for (NSNumber *interval in @[ @0.2, @0.04, @0.12 ]) {
+    [wheel scheduleAfterInterval:interval.doubleValue
+                         onQueue:queue
+                           block:^{
+                             [intervals addObject:interval];
+                             [elapsedIntervals
+                                 addObject:@([[NSDate date] timeIntervalSinceDate:startDate])];
+                             [expectation fulfill];
+                           }];
+  }
+
+  // Assert.
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  NSArray<NSNumber *> *expectedIntervals = @[ @0.04, @0.12, @0.2 ];
+  XCTAssertEqualObjects(intervals, expectedIntervals);
+  for (NSUInteger i = 0; i < elapsedIntervals.count; ++i) {
+    XCTAssertGreaterThanOrEqual(elapsedIntervals[i].doubleValue, intervals[i].doubleValue);
+  }
+}
+
+- (void)testTimerWheelCancel {
+  // Arrange.
+  FSLPromiseTimerWheel *wheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:0.01];
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  __block BOOL isCancelledTimerFired = NO;
+  NSObject __weak *weakObject;
+  FSLPromiseTimer *timer;
+  @autoreleasepool {
+    NSObject *object = [[NSObject alloc] init];
+    weakObject = object;
+    timer = [wheel scheduleAfterInterval:0.05
+                                 onQueue:queue
+                                   block:^{
+                                     isCancelledTimerFired = object != nil;
+                                   }];
+  }
+
+  // Act.
+  [timer cancel];
+  // Fires after the cancelled timer would have, on the same queue.
+  [wheel scheduleAfterInterval:0.1
+                       onQueue:queue
+                         block:^{
+                           [expectation fulfill];
+                         }];
+
+  // Assert.
+  XCTAssertNil(weakObject);
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertFalse(isCancelledTimerFired);
+}
+
+/**
+ Cancelling a timer which has fired already should do nothing.
+ */
+- (void)testTimerWheelCancelAfterFiring {
+  // Arrange.
+  FSLPromiseTimerWheel *wheel = [[FSLPromiseTimerWheel alloc] initWithTickInterval:0.01];
+  dispatch_queue_t queue = dispatch_queue_create(__FUNCTION__, DISPATCH_QUEUE_SERIAL);
+  XCTestExpectation *expectation = [self expectationWithDescription:@""];
+  __block NSUInteger firedCount = 0;
+  FSLPromiseTimer *timer = [wheel scheduleAfterInterval:0.01
+                                                onQueue:queue
+                                                  block:^{
+                                                    ++firedCount;
+                                                    [expectation fulfill];
+                                                  }];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+
+  // Act.
+  [timer cancel];
+
+  // Assert.
+  dispatch_sync(queue, ^{
+  });
+  XCTAssertEqual(firedCount, 1u);
+}
+
+@end
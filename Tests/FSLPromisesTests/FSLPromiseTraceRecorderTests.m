@@ -0,0 +1,127 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#import "FSLPromiseTraceRecorder.h"
+
+#import <XCTest/XCTest.h>
+
+@interface FSLPromiseTraceRecorderTests : XCTestCase
+@end
+
+@implementation FSLPromiseTraceRecorderTests
+
+/** Parses the trace exported by the recorder and returns its events. */
+static NSArray<NSDictionary *> *FSLTraceEvents(FSLPromiseTraceRecorder *recorder) {
+  NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[recorder traceData]
+                                                        options:0
+                                                          error:nil];
+  return trace[@"traceEvents"];
+}
+
+- (void)testTraceRecorderExportsPromiseSpansAndFlows {
+  // Arrange.
+  FSLPromiseTraceRecorder *recorder = [[FSLPromiseTraceRecorder alloc] init];
+  FSLPromiseInstrumentationEvent events[] = {
+      {FSLPromiseInstrumentationEventKindCreated, 1000, 1, 0x10, 0, 0, NULL},
+      {FSLPromiseInstrumentationEventKindChained, 1000, 1, 0x10, 0x20, 0, NULL},
+      {FSLPromiseInstrumentationEventKindFulfilled, 3000, 1, 0x10, 0, 2000, NULL},
+      {FSLPromiseInstrumentationEventKindContinuationBegan, 5000, 2, 0x10, 0, 0, "queue"},
+      {FSLPromiseInstrumentationEventKindContinuationEnded, 6000, 2, 0x10, 0, 0, "queue"},
+  };
+
+  // Act.
+  [recorder promiseInstrumentationDidRecordEvents:events count:5];
+  NSArray<NSDictionary *> *traceEvents = FSLTraceEvents(recorder);
+
+  // Assert.
+  XCTAssertEqual(recorder.eventsCount, 5u);
+  NSArray<NSString *> *phases = [traceEvents valueForKey:@"ph"];
+  NSArray<NSString *> *expectedPhases = @[ @"b", @"n", @"e", @"s", @"f", @"B", @"E" ];
+  XCTAssertEqualObjects(phases, expectedPhases);
+  XCTAssertEqualObjects(traceEvents[0][@"id"], @"0x10");
+  XCTAssertEqualObjects(traceEvents[2][@"id"], @"0x10");
+  XCTAssertEqualObjects(traceEvents[2][@"args"][@"parent"], @"0x20");
+  XCTAssertEqualObjects(traceEvents[2][@"args"][@"state"], @"fulfilled");
+  XCTAssertEqualObjects(traceEvents[3][@"ts"], @3);
+  XCTAssertEqualObjects(traceEvents[3][@"tid"], @1);
+  XCTAssertEqualObjects(traceEvents[4][@"ts"], @5);
+  XCTAssertEqualObjects(traceEvents[4][@"tid"], @2);
+  XCTAssertEqualObjects(traceEvents[3][@"id"], traceEvents[4][@"id"]);
+  XCTAssertEqualObjects(traceEvents[5][@"name"], @"queue");
+}
+
+- (void)testTraceRecorderEndsSpansOfForwardingPromises {
+  // Arrange.
+  FSLPromiseTraceRecorder *recorder = [[FSLPromiseTraceRecorder alloc] init];
+  FSLPromiseInstrumentationEvent events[] = {
+      {FSLPromiseInstrumentationEventKindCreated, 1000, 1, 0x10, 0, 0, NULL},
+      {FSLPromiseInstrumentationEventKindForwarded, 3000, 1, 0x10, 0x20, 2000, NULL},
+  };
+
+  // Act.
+  [recorder promiseInstrumentationDidRecordEvents:events count:2];
+  NSArray<NSDictionary *> *traceEvents = FSLTraceEvents(recorder);
+
+  // Assert.
+  NSArray<NSString *> *phases = [traceEvents valueForKey:@"ph"];
+  NSArray<NSString *> *expectedPhases = @[ @"b", @"e" ];
+  XCTAssertEqualObjects(phases, expectedPhases);
+  XCTAssertEqualObjects(traceEvents[1][@"id"], @"0x10");
+  XCTAssertEqualObjects(traceEvents[1][@"args"][@"state"], @"forwarded");
+  XCTAssertEqualObjects(traceEvents[1][@"args"][@"adopted"], @"0x20");
+}
+
+- (void)testTraceRecorderKeepsLatestEventsWhenBounded {
+  // Arrange.
+  FSLPromiseTraceRecorder *recorder = [[FSLPromiseTraceRecorder alloc] initWithCapacity:2];
+  FSLPromiseInstrumentationEvent events[] = {
+      {FSLPromiseInstrumentationEventKindCreated, 1000, 1, 0x10, 0, 0, NULL},
+      {FSLPromiseInstrumentationEventKindCreated, 2000, 1, 0x20, 0, 0, NULL},
+      {FSLPromiseInstrumentationEventKindCreated, 3000, 1, 0x30, 0, 0, NULL},
+  };
+
+  // Act.
+  [recorder promiseInstrumentationDidRecordEvents:events count:3];
+  NSArray<NSDictionary *> *traceEvents = FSLTraceEvents(recorder);
+
+  // Assert.
+  XCTAssertEqual(recorder.eventsCount, 2u);
+  XCTAssertEqual(recorder.droppedEventsCount, 1u);
+  NSArray<NSString *> *ids = [traceEvents valueForKey:@"id"];
+  NSArray<NSString *> *expectedIDs = @[ @"0x20", @"0x30" ];
+  XCTAssertEqualObjects(ids, expectedIDs);
+}
+
+- (void)testTraceRecorderReset {
+  // Arrange.
+  FSLPromiseTraceRecorder *recorder = [[FSLPromiseTraceRecorder alloc] initWithCapacity:1];
+  FSLPromiseInstrumentationEvent events[] = {
+      {FSLPromiseInstrumentationEventKindCreated, 1000, 1, 0x10, 0, 0, NULL},
+      {FSLPromiseInstrumentationEventKindCreated, 2000, 1, 0x20, 0, 0, NULL},
+  };
+  [recorder promiseInstrumentationDidRecordEvents:events count:2];
+
+  // Act.
+  [recorder reset];
+
+  // Assert.
+  XCTAssertEqual(recorder.eventsCount, 0u);
+  XCTAssertEqual(recorder.droppedEventsCount, 0u);
+  XCTAssertEqual(FSLTraceEvents(recorder).count, 0u);
+}
+
+@end
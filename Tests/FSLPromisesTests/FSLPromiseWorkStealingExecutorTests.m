@@ -0,0 +1,142 @@
+/**
+ Copyright 2018 Google Inc. All rights reserved.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at:
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#import "FSLPromiseWorkStealingExecutor.h"
+
+#import <XCTest/XCTest.h>
+
+#import "FSLPromise+All.h"
+#import "FSLPromise+Do.h"
+#import "FSLPromise+Then.h"
+#import "FSLPromise+Testing.h"
+#import "FSLPromisesTestHelpers.h"
+
+/** Returns a promise of `count`, summed up by a tree of `do:` blocks joined with `all:`. */
+static FSLPromise<NSNumber *> *FSLPromisesTestForkJoin(id<FSLPromiseExecutor> executor,
+                                                       NSUInteger count) {
+  return [FSLPromise onExecutor:executor
+                             do:^id {
+                               if (count <= 1) {
+                                 return @(count);
+                               }
+                               NSArray *promises = @[
+                                 FSLPromisesTestForkJoin(executor, count / 2),
+                                 FSLPromisesTestForkJoin(executor, count - count / 2)
+                               ];
+                               return [[FSLPromise onExecutor:executor all:promises]
+                                   onExecutor:executor
+                                         then:^id(NSArray<NSNumber *> *values) {
+                                           return @(values[0].integerValue +
+                                                    values[1].integerValue);
+                                         }];
+                             }];
+}
+
+@interface FSLPromiseWorkStealingExecutorTests : XCTestCase
+@end
+
+@implementation FSLPromiseWorkStealingExecutorTests
+
+- (void)testThenOnWorkStealingExecutor {
+  // Arrange.
+  FSLPromiseWorkStealingExecutor *executor =
+      [[FSLPromiseWorkStealingExecutor alloc] initWithThreadsCount:2];
+  FSLPromise<NSNumber *> *promise = [FSLPromise resolvedWith:@0];
+
+  // Act.
+  for (NSUInteger i = 0; i < 100; ++i) {
+    promise = [promise onExecutor:executor
+                             then:^id(NSNumber *value) {
+                               return @(value.integerValue + 1);
+                             }];
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqual(executor.threadsCount, 2u);
+  XCTAssertEqualObjects(promise.value, @100);
+}
+
+- (void)testLatestBlockFirstFromPoolThread {
+  // Arrange.
+  FSLPromiseWorkStealingExecutor *executor =
+      [[FSLPromiseWorkStealingExecutor alloc] initWithThreadsCount:1];
+  NSMutableArray<NSNumber *> *order = [[NSMutableArray alloc] init];
+
+  // Act.
+  [FSLPromise onExecutor:executor
+                      do:^id {
+                        for (NSUInteger i = 0; i < 3; ++i) {
+                          [FSLPromise onExecutor:executor
+                                              do:^id {
+                                                [order addObject:@(i)];
+                                                return nil;
+                                              }];
+                        }
+                        return nil;
+                      }];
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(order, (@[ @2, @1, @0 ]));
+}
+
+- (void)testOldestBlockFirstFromOtherThread {
+  // Arrange.
+  FSLPromiseWorkStealingExecutor *executor =
+      [[FSLPromiseWorkStealingExecutor alloc] initWithThreadsCount:1];
+  NSMutableArray<NSNumber *> *order = [[NSMutableArray alloc] init];
+
+  // Act.
+  for (NSUInteger i = 0; i < 3; ++i) {
+    [FSLPromise onExecutor:executor
+                        do:^id {
+                          [order addObject:@(i)];
+                          return nil;
+                        }];
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(order, (@[ @0, @1, @2 ]));
+}
+
+- (void)testForkJoin {
+  // Arrange.
+  FSLPromiseWorkStealingExecutor *executor =
+      [[FSLPromiseWorkStealingExecutor alloc] initWithThreadsCount:4];
+  NSMutableSet<NSThread *> *threads = [[NSMutableSet alloc] init];
+  FSLPromiseDoWorkBlock recordThread = ^id {
+    @synchronized(threads) {
+      [threads addObject:NSThread.currentThread];
+    }
+    return nil;
+  };
+
+  // Act.
+  FSLPromise<NSNumber *> *promise = FSLPromisesTestForkJoin(executor, 1000);
+  for (NSUInteger i = 0; i < 100; ++i) {
+    [FSLPromise onExecutor:executor do:recordThread];
+  }
+
+  // Assert.
+  XCTAssert(FSLWaitForPromisesWithTimeout(10));
+  XCTAssertEqualObjects(promise.value, @1000);
+  XCTAssertLessThanOrEqual(threads.count, 4u);
+  XCTAssertFalse([threads containsObject:NSThread.currentThread]);
+}
+
+@end